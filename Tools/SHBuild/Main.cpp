@@ -11,13 +11,13 @@
 /*!	\file Main.cpp
 \ingroup MaintenanceTools
 \brief 宿主构建工具：递归查找源文件并编译和静态链接。
-\version r4580
+\version r4588
 \author FrankHB <frankhb1989@gmail.com>
 \since build 473
 \par 创建时间:
 	2014-02-06 14:33:55 +0800
 \par 修改时间:
-	2022-09-14 03:06 +0800
+	2026-10-17 16:48 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -53,7 +53,9 @@ See readme file for details.
 //	NPL::pmr::memory_resource, NPL, A1, Forms, LoadStandardContext,
 //	LoadModule_SHBuild, TraceException, TraceBacktrace,
 //	NPL::DecomposeMakefileDepList, NPL::FilterMakefileDependencies,
-//	NPL::pmr::pool_resource;
+//	NPL::pmr::pool_resource, A1::SetupConstantFolding;
+#include YFM_NPL_NPLA1Forms // for NPL::EnvironmentCollector,
+//	Forms::TraceEnvironments;
 #include <ystdex/concurrency.h> // for std::mutex, std::lock_guard,
 //	ystdex::task_pool;
 #include <ystdex/string.hpp> // for ystdex::ston, ystdex::sfmt,
@@ -471,20 +473,90 @@ RunNPLFromStream(const char* name, std::istream&& is,
 	using namespace NPL;
 	using namespace A1;
 	using namespace Forms;
-	GlobalState global{rsrc};
+	// NOTE: The profiler is opt-in. If the value is not "1", it is also the
+	//	path of the file to write the collapsed stacks after the run.
+	string profile_path;
+	shared_ptr<Profiler> p_profiler;
+	unique_ptr<Profiler::CountingResource> p_counted;
+
+	YSLib::FetchEnvironmentVariable(profile_path, "SHBuild_Profile");
+	if(!profile_path.empty())
+	{
+		p_profiler = YSLib::make_shared<Profiler>();
+		p_counted = YSLib::make_unique<Profiler::CountingResource>(rsrc,
+			*p_profiler);
+	}
+
+	// NOTE: The environment collector is also opt-in. The value is the number
+	//	of newly tracked environments to trigger the collection, and "0" only
+	//	requests the collection after the run.
+	unique_ptr<EnvironmentCollector> p_collector;
+	observer_ptr<EnvironmentCollector> p_prev_collector;
+
+	{
+		string val;
+
+		YSLib::FetchEnvironmentVariable(val, "SHBuild_CollectEnvironments");
+		if(!val.empty())
+		{
+			p_collector = YSLib::make_unique<EnvironmentCollector>();
+			p_collector->Trace = TraceEnvironments;
+			TryExpr(p_collector->Threshold
+				= size_t(std::stoul(to_std_string(val))))
+			CatchIgnore(std::invalid_argument&)
+			p_prev_collector = EnvironmentCollector::SwitchActive(
+				make_observer(p_collector.get()));
+		}
+	}
+
+	const auto c_gd(ystdex::make_guard([&]() ynothrow{
+		if(p_collector)
+			EnvironmentCollector::SwitchActive(p_prev_collector);
+	}));
+	GlobalState global{p_counted ? *p_counted : rsrc};
 	TermNode term{global.Allocator};
+	ContextState cs(global);
 #if SHBuild_UseBacktrace
-	ContextNode::ReducerSequence backtrace{global.Allocator};
+	// NOTE: The frames are shifted from the current actions of %cs.
+	ContextNode::ReducerSequence backtrace{cs.GetFrameAllocator()};
 #endif
-	ContextState cs(global);
+	const auto gd(ystdex::make_guard([&]() ynothrow{
+		if(p_profiler && profile_path != "1")
+			FilterExceptions([&]{
+				YSLib::ofstream ofs(profile_path.c_str(),
+					std::ios_base::out | std::ios_base::trunc);
+
+				p_profiler->PrintCollapsedStacks(ofs);
+			}, "profile output");
+	}));
+
+	cs.ProfilerPtr = p_profiler;
 
 #if SHBuild_UseSourceInfo
 	global.UseSourceLocation = true;
 #endif
+	// NOTE: The translation unit images are written next to the loaded
+	//	sources, so they are only used on request.
+	{
+		string val(global.Allocator);
+
+		YSLib::FetchEnvironmentVariable(val, "SHBuild_UnitImage");
+		if(val == "1")
+			global.Load = LoadWithUnitImage;
+	}
 	// NOTE: Set the filter level to avoid uninterested NPLA messages. This is
 	//	intended at least in the stage 1.
 	cs.Trace.FilterLevel = Logger::Level::Informative;
 	LoadStandardContext(cs);
+	// NOTE: The constant folding is opt-in. It is set up after the standard
+	//	modules are loaded, as the modules mark the pure combiners.
+	{
+		string val(global.Allocator);
+
+		YSLib::FetchEnvironmentVariable(val, "SHBuild_FoldConstants");
+		if(val == "1")
+			SetupConstantFolding(global);
+	}
 	global.OutputStreamPtr = make_observer(&std::cout);
 	// NOTE: The ground environment is saved during the call to %InvokeIn.
 	InvokeIn(cs, [&]{
@@ -566,6 +638,16 @@ RunNPLFromStream(const char* name, std::istream&& is,
 		CatchExpr(..., std::throw_with_nested(NPLException(
 			ystdex::sfmt("Failed loading external unit '%s'.", name))));
 	});
+	if(p_collector)
+	{
+		p_collector->Collect();
+
+		const auto& stat(p_collector->GetStatistics());
+
+		PrintInfo(ystdex::sfmt("%zu environment(s) of estimated %zu byte(s)"
+			" collected in %zu collection(s).", stat.Environments, stat.Bytes,
+			stat.Collections));
+	}
 }
 
 } // unnamed namespace;
@@ -11,13 +11,13 @@
 /*!	\file cache.hpp
 \ingroup YStandardEx
 \brief 高速缓冲容器模板。
-\version r748
+\version r749
 \author FrankHB <frankhb1989@gmail.com>
 \since build 521
 \par 创建时间:
 	2013-12-22 20:19:14 +0800
 \par 修改时间:
-	2022-03-22 18:11 +0800
+	2026-10-17 14:17 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -33,11 +33,16 @@
 //	std::get, std::piecewise_construct, enable_if_t, head_of_t;
 #include <list> // for std::list;
 #include "scope_guard.hpp" // for std::hash, optional_function, std::ref,
-//	ystdex::unique_guard, ystdex::dismiss;
+//	ystdex::unique_guard, ystdex::dismiss, function, std::equal_to;
 #include <unordered_map> // for std::unordered_map;
 #include <map> // for std::map;
 #include "container.hpp" // for ystdex::begin, ystdex::cbegin,
 //	ystdex::search_map_by, ystdex::end, ystdex::cend;
+#include <mutex> // for std::mutex, std::lock_guard;
+#include <deque> // for std::deque;
+#include <vector> // for std::vector;
+#include <memory> // for std::unique_ptr;
+#include <type_traits> // for std::aligned_storage;
 
 namespace ystdex
 {
@@ -411,6 +416,494 @@ public:
 //@}
 
 
+/*!
+\brief 线程安全的分片缓存。
+\note 除非另行指定，所有公开成员函数线程安全。
+\warning 非虚析构。
+\since build 955
+
+项按散列值分配到数量为 2 的整数次幂的分片中，每个分片使用独立的互斥量。
+每个分片中的项保存在平坦的槽数组中，使用线性探测的开放寻址索引查找，
+	不为每个项单独分配节点。
+容量是项的权重之和的预算，平均分配到每个分片。项的权重由权重函数决定，默认为 1 。
+分片中的项的权重之和超过预算时，使用 CLOCK 策略逐出项：
+	访问的项被标记，逐出时被跳过一次并清除标记。
+权重超过分片预算的项不被缓存。
+访问的结果是映射值的副本，以避免在解锁后引用被逐出的项。
+*/
+template<typename _tKey, typename _tMapped, typename _fHash = std::hash<_tKey>,
+	typename _fEqual = std::equal_to<_tKey>>
+class concurrent_cache
+{
+public:
+	using key_type = _tKey;
+	using mapped_type = _tMapped;
+	using size_type = size_t;
+	using hasher = _fHash;
+	using key_equal = _fEqual;
+	//! \brief 权重函数。
+	using weigher = function<size_t(const key_type&, const mapped_type&)>;
+
+	//! \brief 缓存的统计。
+	struct statistics
+	{
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+	};
+
+private:
+	struct node
+	{
+		key_type key;
+		mapped_type mapped;
+
+		template<typename _tParam>
+		node(const key_type& k, _tParam&& arg)
+			: key(k), mapped(yforward(arg))
+		{}
+	};
+	struct slot
+	{
+		typename std::aligned_storage<sizeof(node), yalignof(node)>::type
+			storage;
+		//! \brief 散列值，或未使用时空闲链表中的下一个槽。
+		size_t hash = 0;
+		size_t weight = 0;
+		bool used = {};
+		bool referenced = {};
+
+		node&
+		get() ynothrow
+		{
+			return *static_cast<node*>(static_cast<void*>(&storage));
+		}
+	};
+	class shard
+	{
+	public:
+		mutable std::mutex mutex{};
+		//! \note 使用 std::deque 使槽在添加时不被转移。
+		std::deque<slot> slots{};
+		//! \brief 索引：零表示空位，否则为槽的下标加一。
+		std::vector<size_t> index = std::vector<size_t>(yimpl(16));
+		size_t free_head = size_t(-1);
+		size_t count = 0;
+		size_t weight = 0;
+		size_t hand = 0;
+		statistics stat{};
+
+		shard() = default;
+		~shard()
+		{
+			for(auto& s : slots)
+				if(s.used)
+					s.get().~node();
+		}
+	};
+
+	std::unique_ptr<shard[]> shards;
+	size_t shard_bits;
+	size_t budget;
+	size_t shard_budget;
+	hasher hash_fn;
+	key_equal equal_fn;
+	weigher weigh;
+
+public:
+	/*!
+	\brief 构造：使用指定的权重预算、分片数和权重函数。
+	\note 分片数向上取整为 2 的整数次幂。
+	\note 权重函数为空时，每个项的权重为 1 。
+	*/
+	explicit
+	concurrent_cache(size_t b, size_t n = yimpl(16), weigher w = {},
+		const hasher& hf = {}, const key_equal& eq = {})
+		: shards(), shard_bits(0), budget(b), shard_budget(),
+		hash_fn(hf), equal_fn(eq), weigh(std::move(w))
+	{
+		while((size_t(1) << shard_bits) < n)
+			++shard_bits;
+		shards.reset(new shard[size_t(1) << shard_bits]);
+		shard_budget = (b + get_shard_num() - 1) >> shard_bits;
+	}
+	concurrent_cache(const concurrent_cache&) = delete;
+
+	concurrent_cache&
+	operator=(const concurrent_cache&) = delete;
+
+	//! \brief 取权重预算。
+	YB_ATTR_nodiscard YB_PURE size_t
+	get_budget() const ynothrow
+	{
+		return budget;
+	}
+
+	YB_ATTR_nodiscard YB_PURE size_t
+	get_shard_num() const ynothrow
+	{
+		return size_t(1) << shard_bits;
+	}
+
+	//! \brief 取所有分片的统计之和。
+	YB_ATTR_nodiscard statistics
+	get_statistics() const
+	{
+		statistics res;
+
+		for_each_shard([&](const shard& sd){
+			res.hits += sd.stat.hits;
+			res.misses += sd.stat.misses;
+			res.evictions += sd.stat.evictions;
+		});
+		return res;
+	}
+
+	//! \brief 取所有项的权重之和。
+	YB_ATTR_nodiscard size_t
+	get_weight() const
+	{
+		size_t res(0);
+
+		for_each_shard([&](const shard& sd){
+			res += sd.weight;
+		});
+		return res;
+	}
+
+	void
+	clear()
+	{
+		for(size_t i(0); i < get_shard_num(); ++i)
+		{
+			auto& sd(shards[i]);
+			std::lock_guard<std::mutex> lck(sd.mutex);
+
+			for(size_t j(0); j < sd.slots.size(); ++j)
+				if(sd.slots[j].used)
+					remove_slot(sd, j);
+		}
+	}
+
+	//! \brief 移除项。
+	bool
+	erase(const key_type& k)
+	{
+		const auto h(hash_fn(k));
+		auto& sd(get_shard(h));
+		std::lock_guard<std::mutex> lck(sd.mutex);
+		const auto i(find_slot(sd, k, h));
+
+		if(i != size_t(-1))
+		{
+			remove_slot(sd, i);
+			return true;
+		}
+		return {};
+	}
+
+	/*!
+	\brief 查找项并复制映射值。
+	\return 是否找到。
+	*/
+	bool
+	find(const key_type& k, mapped_type& x)
+	{
+		return visit(k, [&](const mapped_type& y){
+			x = y;
+		});
+	}
+
+	/*!
+	\brief 插入项，或在项已存在时保留原有的项。
+	\return 是否插入。
+	*/
+	template<typename _tParam>
+	bool
+	insert(const key_type& k, _tParam&& arg)
+	{
+		return emplace_impl(k, yforward(arg), false);
+	}
+
+	/*!
+	\brief 插入项，或在项已存在时替换映射值。
+	\return 是否插入新的项。
+	*/
+	template<typename _tParam>
+	bool
+	insert_or_assign(const key_type& k, _tParam&& arg)
+	{
+		return emplace_impl(k, yforward(arg), true);
+	}
+
+	/*!
+	\brief 查找项，若不存在则调用第二参数初始化并插入。
+	\return 映射值的副本。
+	\note 初始化在不持有锁时进行，因此可能被不同线程重复调用；
+		此时保留先插入的项。
+	*/
+	template<typename _func>
+	mapped_type
+	lookup(const key_type& k, _func init)
+	{
+		const auto h(hash_fn(k));
+		auto& sd(get_shard(h));
+		{
+			std::lock_guard<std::mutex> lck(sd.mutex);
+			const auto i(find_slot(sd, k, h));
+
+			if(i != size_t(-1))
+				return hit(sd, i);
+			++sd.stat.misses;
+		}
+
+		mapped_type res(init());
+		std::lock_guard<std::mutex> lck(sd.mutex);
+		const auto i(find_slot(sd, k, h));
+
+		if(i != size_t(-1))
+			return sd.slots[i].get().mapped;
+		insert_unlocked(sd, k, h, res);
+		return res;
+	}
+
+	//! \brief 取项数。
+	YB_ATTR_nodiscard size_t
+	size() const
+	{
+		size_t res(0);
+
+		for_each_shard([&](const shard& sd){
+			res += sd.count;
+		});
+		return res;
+	}
+
+	/*!
+	\brief 查找项并以映射值调用第二参数。
+	\return 是否找到。
+	\warning 调用时持有分片的锁，不能再次访问缓存。
+	*/
+	template<typename _func>
+	bool
+	visit(const key_type& k, _func f)
+	{
+		const auto h(hash_fn(k));
+		auto& sd(get_shard(h));
+		std::lock_guard<std::mutex> lck(sd.mutex);
+		const auto i(find_slot(sd, k, h));
+
+		if(i != size_t(-1))
+		{
+			f(hit(sd, i));
+			return true;
+		}
+		++sd.stat.misses;
+		return {};
+	}
+
+private:
+	template<typename _tParam>
+	bool
+	emplace_impl(const key_type& k, _tParam&& arg, bool assign)
+	{
+		const auto h(hash_fn(k));
+		auto& sd(get_shard(h));
+		std::lock_guard<std::mutex> lck(sd.mutex);
+		const auto i(find_slot(sd, k, h));
+
+		if(i != size_t(-1))
+		{
+			if(!assign)
+				return {};
+			// NOTE: The old entry is removed to be replaced, so it is not
+			//	evicted in place of others when the weight grows.
+			remove_slot(sd, i);
+		}
+		return insert_unlocked(sd, k, h, yforward(arg)) && i == size_t(-1);
+	}
+
+	//! \brief 逐出项直至可以加入指定的权重。
+	void
+	evict(shard& sd, size_t w) ynothrow
+	{
+		while(sd.weight + w > shard_budget && sd.count != 0)
+		{
+			if(sd.hand >= sd.slots.size())
+				sd.hand = 0;
+
+			auto& s(sd.slots[sd.hand]);
+
+			if(s.used)
+			{
+				if(s.referenced)
+					s.referenced = {};
+				else
+				{
+					remove_slot(sd, sd.hand);
+					++sd.stat.evictions;
+				}
+			}
+			++sd.hand;
+		}
+	}
+
+	//! \return 槽的下标，或 size_t(-1) 表示未找到。
+	size_t
+	find_slot(shard& sd, const key_type& k, size_t h) const
+	{
+		const auto mask(sd.index.size() - 1);
+
+		for(auto p(home(h) & mask); sd.index[p] != 0; p = (p + 1) & mask)
+		{
+			const auto i(sd.index[p] - 1);
+			auto& s(sd.slots[i]);
+
+			if(s.hash == h && equal_fn(s.get().key, k))
+				return i;
+		}
+		return size_t(-1);
+	}
+
+	template<typename _func>
+	void
+	for_each_shard(_func f) const
+	{
+		for(size_t i(0); i < get_shard_num(); ++i)
+		{
+			auto& sd(shards[i]);
+			std::lock_guard<std::mutex> lck(sd.mutex);
+
+			f(sd);
+		}
+	}
+
+	shard&
+	get_shard(size_t h) const ynothrow
+	{
+		return shards[h & (get_shard_num() - 1)];
+	}
+
+	const mapped_type&
+	hit(shard& sd, size_t i) ynothrow
+	{
+		auto& s(sd.slots[i]);
+
+		s.referenced = true;
+		++sd.stat.hits;
+		return s.get().mapped;
+	}
+
+	//! \brief 索引的起始位置：分片使用散列值的低位，因此跳过这些位。
+	size_t
+	home(size_t h) const ynothrow
+	{
+		return h >> shard_bits;
+	}
+
+	template<typename _tParam>
+	bool
+	insert_unlocked(shard& sd, const key_type& k, size_t h, _tParam&& arg)
+	{
+		reserve_index(sd);
+		if(sd.free_head == size_t(-1))
+		{
+			sd.slots.emplace_back();
+			sd.slots.back().hash = size_t(-1);
+			sd.free_head = sd.slots.size() - 1;
+		}
+
+		const auto i(sd.free_head);
+		auto& s(sd.slots[i]);
+		const auto next_free(s.hash);
+		size_t w;
+
+		::new(&s.storage) node(k, yforward(arg));
+		try
+		{
+			// NOTE: The weight is computed on the constructed node, so the
+			//	argument is only forwarded once.
+			w = weigh ? weigh(k, s.get().mapped) : 1;
+		}
+		catch(...)
+		{
+			s.get().~node();
+			throw;
+		}
+		if(w > shard_budget)
+		{
+			s.get().~node();
+			return {};
+		}
+		// NOTE: The slot is taken off the free list before the eviction, and
+		//	it is neither used nor indexed yet, so it is never evicted.
+		sd.free_head = next_free;
+		evict(sd, w);
+		yunseq(s.hash = h, s.weight = w, s.used = true, s.referenced = {});
+		insert_index(sd, i);
+		yunseq(++sd.count, sd.weight += w);
+		return true;
+	}
+
+	void
+	insert_index(shard& sd, size_t i) ynothrow
+	{
+		const auto mask(sd.index.size() - 1);
+		auto p(home(sd.slots[i].hash) & mask);
+
+		while(sd.index[p] != 0)
+			p = (p + 1) & mask;
+		sd.index[p] = i + 1;
+	}
+
+	//! \brief 移除槽并使用后移删除维护线性探测的索引。
+	void
+	remove_slot(shard& sd, size_t i) ynothrow
+	{
+		auto& s(sd.slots[i]);
+		const auto mask(sd.index.size() - 1);
+		auto p(home(s.hash) & mask);
+
+		while(sd.index[p] != i + 1)
+			p = (p + 1) & mask;
+		for(auto q(p);;)
+		{
+			q = (q + 1) & mask;
+			if(sd.index[q] == 0)
+				break;
+
+			const auto r(home(sd.slots[sd.index[q] - 1].hash) & mask);
+
+			if(p <= q ? (r <= p || r > q) : (r <= p && r > q))
+			{
+				sd.index[p] = sd.index[q];
+				p = q;
+			}
+		}
+		sd.index[p] = 0;
+		s.get().~node();
+		yunseq(sd.weight -= s.weight, --sd.count, s.used = {},
+			s.hash = sd.free_head);
+		sd.free_head = i;
+	}
+
+	//! \brief 按需扩大索引使之可以再插入一项。
+	void
+	reserve_index(shard& sd)
+	{
+		if((sd.count + 1) * 2 > sd.index.size())
+		{
+			std::vector<size_t> idx(sd.index.size() * 2);
+
+			sd.index.swap(idx);
+			for(size_t j(0); j < idx.size(); ++j)
+				if(idx[j] != 0)
+					insert_index(sd, idx[j] - 1);
+		}
+	}
+};
+
+
 /*!
 \brief 以指定的关键字查找关联容器访问对应的元素并按需初始化其中的条目。
 \tparam _tMap 映射类型，可以是 std::map 、std::unordered_map
@@ -11,13 +11,13 @@
 /*!	\file concurrency.h
 \ingroup YStandardEx
 \brief 并发操作。
-\version r592
+\version r597
 \author FrankHB <frankhb1989@gmail.com>
 \since build 520
 \par 创建时间:
 	2014-07-21 18:57:13 +0800
 \par 修改时间:
-	2022-02-26 22:49 +0800
+	2026-10-17 17:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -37,6 +37,14 @@
 #include <condition_variable> // for std::condition_variable;
 #include "function.hpp" // for std::bind, function, ystdex::invoke;
 #include "cassert.h" // for yassume;
+#include <atomic> // for std::atomic;
+#include <memory> // for std::unique_ptr, std::shared_ptr;
+#include <initializer_list> // for std::initializer_list;
+#include <exception> // for std::exception_ptr;
+#include <type_traits> // for std::aligned_storage, std::is_nothrow_move_constructible,
+//	std::is_nothrow_move_assignable;
+#include <cstddef> // for std::ptrdiff_t;
+#include <algorithm> // for std::min;
 
 namespace ystdex
 {
@@ -81,6 +89,471 @@ get_this_thread_id()
 }
 
 
+//! \since build 955
+//@{
+/*!
+\brief 避免伪共享的填充大小。
+\note 不依赖 std::hardware_destructive_interference_size 。
+*/
+yconstexpr const size_t cache_line_size(yimpl(64));
+
+/*!
+\brief 单生产者单消费者的有界无锁环形缓冲区。
+\pre 元素类型可析构且析构不抛出异常。
+\note 容量向上取整为 2 的整数次幂。
+\warning 同时只能有一个线程调用生产操作，且同时只能有一个线程调用消费操作。
+
+前缀为 try_ 的操作不阻塞，以结果表示是否成功；
+	前缀为 spin_ 的操作自旋等待：在不能完成时让出当前线程并重试，直至完成。
+自旋等待不挂起线程，等待时仍占用处理器时间，不适用于等待时间可能较长的场合；
+	此时应组合 try_ 操作和其它同步机制。
+批量操作只发布一次位置。
+*/
+template<typename _type>
+class spsc_ring
+{
+public:
+	using value_type = _type;
+
+private:
+	using storage_t = typename std::aligned_storage<sizeof(_type),
+		yalignof(_type)>::type;
+
+	size_t mask;
+	std::unique_ptr<storage_t[]> slots;
+	char pad0[cache_line_size]{};
+	//! \brief 消费者的位置。
+	std::atomic<size_t> head{0};
+	//! \brief 消费者缓存的生产者位置。
+	size_t cached_tail = 0;
+	char pad1[cache_line_size]{};
+	//! \brief 生产者的位置。
+	std::atomic<size_t> tail{0};
+	//! \brief 生产者缓存的消费者位置。
+	size_t cached_head = 0;
+	char pad2[cache_line_size]{};
+
+public:
+	//! \pre 参数非零。
+	explicit
+	spsc_ring(size_t n)
+		: mask(ceil_capacity(n) - 1), slots(new storage_t[mask + 1])
+	{}
+	spsc_ring(const spsc_ring&) = delete;
+	~spsc_ring()
+	{
+		for(auto i(head.load()), e(tail.load()); i != e; ++i)
+			at(i).~_type();
+	}
+
+	spsc_ring&
+	operator=(const spsc_ring&) = delete;
+
+	size_t
+	capacity() const ynothrow
+	{
+		return mask + 1;
+	}
+
+	//! \note 结果在返回时可能已经过时。
+	bool
+	empty() const ynothrow
+	{
+		return head.load() == tail.load();
+	}
+
+	//! \note 结果在返回时可能已经过时。
+	size_t
+	size() const ynothrow
+	{
+		return tail.load() - head.load();
+	}
+
+	//! \note 生产操作。
+	//@{
+	template<typename... _tParams>
+	bool
+	try_emplace(_tParams&&... args)
+	{
+		const auto t(tail.load(std::memory_order_relaxed));
+
+		if(t - cached_head > mask)
+		{
+			cached_head = head.load(std::memory_order_acquire);
+			if(t - cached_head > mask)
+				return {};
+		}
+		::new(&slots[t & mask]) _type(yforward(args)...);
+		tail.store(t + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool
+	try_push(const _type& x)
+	{
+		return try_emplace(x);
+	}
+	bool
+	try_push(_type&& x)
+	{
+		return try_emplace(std::move(x));
+	}
+
+	/*!
+	\brief 批量添加元素。
+	\return 添加的元素数。
+	*/
+	template<typename _tIn>
+	size_t
+	try_push_n(_tIn first, size_t n)
+	{
+		const auto t(tail.load(std::memory_order_relaxed));
+
+		if(mask + 1 - (t - cached_head) < n)
+			cached_head = head.load(std::memory_order_acquire);
+
+		const auto k(std::min(n, mask + 1 - (t - cached_head)));
+		size_t i(0);
+
+		try
+		{
+			for(; i < k; yunseq(++i, ++first))
+				::new(&slots[(t + i) & mask]) _type(*first);
+		}
+		catch(...)
+		{
+			tail.store(t + i, std::memory_order_release);
+			throw;
+		}
+		tail.store(t + k, std::memory_order_release);
+		return k;
+	}
+
+	template<typename _tParam>
+	void
+	spin_push(_tParam&& x)
+	{
+		while(!try_emplace(yforward(x)))
+			std::this_thread::yield();
+	}
+	//@}
+
+	//! \note 消费操作。
+	//@{
+	bool
+	try_pop(_type& x)
+	{
+		const auto h(head.load(std::memory_order_relaxed));
+
+		if(h == cached_tail)
+		{
+			cached_tail = tail.load(std::memory_order_acquire);
+			if(h == cached_tail)
+				return {};
+		}
+
+		auto& y(at(h));
+
+		x = std::move(y);
+		y.~_type();
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+	\brief 批量移除元素并输出到迭代器。
+	\return 移除的元素数。
+	*/
+	template<typename _tOut>
+	size_t
+	try_pop_n(_tOut dst, size_t n)
+	{
+		const auto h(head.load(std::memory_order_relaxed));
+
+		if(cached_tail - h < n)
+			cached_tail = tail.load(std::memory_order_acquire);
+
+		const auto k(std::min(n, cached_tail - h));
+		size_t i(0);
+
+		try
+		{
+			for(; i < k; yunseq(++i, ++dst))
+			{
+				auto& y(at(h + i));
+
+				*dst = std::move(y);
+				y.~_type();
+			}
+		}
+		catch(...)
+		{
+			head.store(h + i, std::memory_order_release);
+			throw;
+		}
+		head.store(h + k, std::memory_order_release);
+		return k;
+	}
+
+	_type
+	spin_pop()
+	{
+		const auto h(head.load(std::memory_order_relaxed));
+
+		while(h == cached_tail)
+		{
+			cached_tail = tail.load(std::memory_order_acquire);
+			if(h == cached_tail)
+				std::this_thread::yield();
+		}
+
+		auto& y(at(h));
+		_type res(std::move(y));
+
+		y.~_type();
+		head.store(h + 1, std::memory_order_release);
+		return res;
+	}
+	//@}
+
+private:
+	_type&
+	at(size_t i) ynothrow
+	{
+		return *static_cast<_type*>(static_cast<void*>(&slots[i & mask]));
+	}
+
+	static size_t
+	ceil_capacity(size_t n) ynothrow
+	{
+		size_t res(1);
+
+		while(res < n)
+			res <<= 1;
+		return res;
+	}
+};
+
+
+/*!
+\brief 多生产者多消费者的有界无锁环形缓冲区。
+\pre 元素类型的转移构造、转移赋值和析构不抛出异常。
+\note 容量向上取整为 2 的整数次幂且不小于 2 。
+\see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue 。
+
+每个单元具有序列号，生产者和消费者通过比较序列号和位置判断单元是否可用。
+前缀为 try_ 的操作不阻塞，以结果表示是否成功；
+	前缀为 spin_ 的操作自旋等待：在不能完成时让出当前线程并重试，直至完成。
+自旋等待不挂起线程，等待时仍占用处理器时间，不适用于等待时间可能较长的场合；
+	此时应组合 try_ 操作和其它同步机制。
+批量操作逐个处理元素，其它线程的操作可能穿插其中。
+*/
+template<typename _type>
+class mpmc_ring
+{
+	static_assert(std::is_nothrow_move_constructible<_type>(),
+		"Invalid type found.");
+	static_assert(std::is_nothrow_move_assignable<_type>(),
+		"Invalid type found.");
+
+public:
+	using value_type = _type;
+
+private:
+	struct cell
+	{
+		std::atomic<size_t> sequence;
+		typename std::aligned_storage<sizeof(_type), yalignof(_type)>::type
+			data;
+	};
+
+	size_t mask;
+	std::unique_ptr<cell[]> cells;
+	char pad0[cache_line_size]{};
+	std::atomic<size_t> enqueue_pos{0};
+	char pad1[cache_line_size]{};
+	std::atomic<size_t> dequeue_pos{0};
+	char pad2[cache_line_size]{};
+
+public:
+	//! \pre 参数非零。
+	explicit
+	mpmc_ring(size_t n)
+		: mask(ceil_capacity(n) - 1), cells(new cell[mask + 1])
+	{
+		for(size_t i(0); i <= mask; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	mpmc_ring(const mpmc_ring&) = delete;
+	~mpmc_ring()
+	{
+		for(auto i(dequeue_pos.load()), e(enqueue_pos.load()); i != e; ++i)
+			static_cast<_type*>(static_cast<void*>(&cells[i & mask].data))
+				->~_type();
+	}
+
+	mpmc_ring&
+	operator=(const mpmc_ring&) = delete;
+
+	size_t
+	capacity() const ynothrow
+	{
+		return mask + 1;
+	}
+
+	//! \note 结果在返回时可能已经过时。
+	bool
+	empty() const ynothrow
+	{
+		return size() == 0;
+	}
+
+	//! \note 结果在返回时可能已经过时。
+	size_t
+	size() const ynothrow
+	{
+		const auto d(dequeue_pos.load());
+		const auto e(enqueue_pos.load());
+
+		return e > d ? e - d : 0;
+	}
+
+	bool
+	try_push(const _type& x)
+	{
+		// NOTE: The copy is made before a cell is claimed, since a claimed
+		//	cell cannot be given up.
+		return try_push(_type(x));
+	}
+	bool
+	try_push(_type&& x) ynothrow
+	{
+		cell* p;
+		auto pos(enqueue_pos.load(std::memory_order_relaxed));
+
+		while(true)
+		{
+			p = &cells[pos & mask];
+
+			const auto dif(std::ptrdiff_t(p->sequence.load(
+				std::memory_order_acquire) - pos));
+
+			if(dif == 0)
+			{
+				if(enqueue_pos.compare_exchange_weak(pos, pos + 1,
+					std::memory_order_relaxed))
+					break;
+			}
+			else if(dif < 0)
+				return {};
+			else
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+		}
+		::new(&p->data) _type(std::move(x));
+		p->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool
+	try_pop(_type& x) ynothrow
+	{
+		cell* p;
+		auto pos(dequeue_pos.load(std::memory_order_relaxed));
+
+		while(true)
+		{
+			p = &cells[pos & mask];
+
+			const auto dif(std::ptrdiff_t(p->sequence.load(
+				std::memory_order_acquire) - (pos + 1)));
+
+			if(dif == 0)
+			{
+				if(dequeue_pos.compare_exchange_weak(pos, pos + 1,
+					std::memory_order_relaxed))
+					break;
+			}
+			else if(dif < 0)
+				return {};
+			else
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+		}
+
+		auto& y(*static_cast<_type*>(static_cast<void*>(&p->data)));
+
+		x = std::move(y);
+		y.~_type();
+		p->sequence.store(pos + mask + 1, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+	\brief 批量添加元素。
+	\return 添加的元素数。
+	*/
+	template<typename _tIn>
+	size_t
+	try_push_n(_tIn first, size_t n)
+	{
+		size_t i(0);
+
+		for(; i < n && try_push(*first); yunseq(++i, ++first))
+			;
+		return i;
+	}
+
+	/*!
+	\brief 批量移除元素并输出到迭代器。
+	\pre 元素类型可默认构造。
+	\return 移除的元素数。
+	*/
+	template<typename _tOut>
+	size_t
+	try_pop_n(_tOut dst, size_t n)
+	{
+		size_t i(0);
+		_type x;
+
+		for(; i < n && try_pop(x); yunseq(++i, ++dst))
+			*dst = std::move(x);
+		return i;
+	}
+
+	template<typename _tParam>
+	void
+	spin_push(_tParam&& x)
+	{
+		_type y(yforward(x));
+
+		while(!try_push(std::move(y)))
+			std::this_thread::yield();
+	}
+
+	//! \pre 元素类型可默认构造。
+	_type
+	spin_pop()
+	{
+		_type res;
+
+		while(!try_pop(res))
+			std::this_thread::yield();
+		return res;
+	}
+
+private:
+	static size_t
+	ceil_capacity(size_t n) ynothrow
+	{
+		size_t res(2);
+
+		while(res < n)
+			res <<= 1;
+		return res;
+	}
+};
+//@}
+
+
 #	if !__GLIBCXX__ || (defined(_GLIBCXX_HAS_GTHREADS) \
 	&& defined(_GLIBCXX_USE_C99_STDINT_TR1) && (ATOMIC_INT_LOCK_FREE > 1))
 /*!
@@ -202,27 +675,229 @@ public:
 };
 
 
+/*!
+\brief 工作窃取线程池。
+\note 除非另行指定，所有公开成员函数线程安全。
+\note 未控制任务的数量。
+\since build 955
+
+每个工作线程具有一个 Chase-Lev 双端队列。
+在工作线程中提交的任务进入当前线程的队列；
+	其它线程提交的任务进入无锁的注入队列，由工作线程成批取出。
+工作线程依次从自身的队列、注入队列和其它工作线程的队列中取得任务。
+没有任务时，工作线程先让出有限的次数，然后阻塞等待提交新的任务。
+*/
+class YB_API work_stealing_pool
+{
+public:
+	//! \brief 任务：单独分配，在执行后释放。
+	class YB_API task_base
+	{
+		friend class work_stealing_pool;
+
+	private:
+		//! \brief 注入队列中的下一个任务。
+		task_base* next = {};
+
+	public:
+		task_base() = default;
+		task_base(const task_base&) = delete;
+		virtual
+		~task_base();
+
+		task_base&
+		operator=(const task_base&) = delete;
+
+		virtual void
+		operator()() = 0;
+	};
+
+private:
+	template<typename _func>
+	class task final : public task_base
+	{
+	private:
+		_func func;
+
+	public:
+		template<typename _fCallable>
+		explicit
+		task(_fCallable&& f)
+			: func(yforward(f))
+		{}
+
+		void
+		operator()() override
+		{
+			func();
+		}
+	};
+	//! \brief 工作线程数据：定义在实现中。
+	class worker;
+
+	std::vector<std::unique_ptr<worker>> workers{};
+	std::vector<std::thread> threads{};
+	//! \brief 注入队列：后进先出的单链表，由工作线程整体取出。
+	std::atomic<task_base*> injected{};
+	//! \brief 已提交但未开始执行的任务数。
+	std::atomic<size_t> pending{};
+	//! \brief 阻塞等待的工作线程数。
+	std::atomic<size_t> sleeping{};
+	std::mutex park_mutex{};
+	std::condition_variable park_condition{};
+	//! \note 仅在析构和重置时设置停止。
+	std::atomic<bool> stopped{};
+
+public:
+	/*!
+	\brief 构造：使用指定的初始化和退出回调指定数量的工作线程。
+	\note 若回调为空则忽略。
+	\note 线程数为 0 时无任务，不提供特别的检查。
+	\warning 回调的执行不提供顺序和并发安全保证。
+	*/
+	work_stealing_pool(size_t, function<void()> = {}, function<void()> = {});
+	/*!
+	\brief 析构：设置停止状态并等待所有执行中的线程结束。
+	\note 可能阻塞。已提交的任务在工作线程退出前被执行。
+	\note 没有工作线程时，未执行的任务被直接释放。
+	*/
+	~work_stealing_pool() ynothrow;
+
+	/*!
+	\brief 提交任务。
+	\return 任务共享状态。
+	\warning 需要确保未被停止（未进入析构），否则不保证任务被运行。
+	*/
+	template<typename _fCallable, typename... _tParams>
+	future_result_t<_fCallable, _tParams...>
+	enqueue(_fCallable&& f, _tParams&&... args)
+	{
+		auto bound(ystdex::pack_task(yforward(f), yforward(args)...));
+		auto res(bound.get_future());
+
+		post(std::move(bound));
+		return res;
+	}
+
+	//! \brief 取工作线程数。
+	size_t
+	get_thread_num() const ynothrow
+	{
+		return threads.size();
+	}
+
+	/*!
+	\brief 提交不需要结果的任务。
+	\note 不创建共享状态。任务抛出的异常调用 std::terminate 。
+	\warning 需要确保未被停止（未进入析构），否则不保证任务被运行。
+	*/
+	//@{
+	template<typename _fCallable>
+	void
+	post(_fCallable&& f)
+	{
+		submit(std::unique_ptr<task_base>(
+			new task<decay_t<_fCallable>>(yforward(f))));
+	}
+	template<typename _fCallable, typename _tParam, typename... _tParams>
+	void
+	post(_fCallable&& f, _tParam&& arg, _tParams&&... args)
+	{
+		post(std::bind(yforward(f), yforward(arg), yforward(args)...));
+	}
+	//@}
+
+	/*!
+	\brief 取已提交但未开始执行的任务数。
+	\note 结果在返回时可能已经过时。
+	*/
+	size_t
+	size() const ynothrow
+	{
+		return pending.load();
+	}
+
+	/*!
+	\brief 重置：停止并等待所有执行中的线程结束后，重新创建指定数量的工作线程。
+	\note 参数和构造函数相同。停止的操作同析构函数。
+	\warning 非线程安全。
+	*/
+	void
+	reset(size_t, function<void()> = {}, function<void()> = {});
+
+private:
+	//! \brief 创建指定数量的工作线程。
+	void
+	start(size_t, const function<void()>&, const function<void()>&);
+
+	//! \brief 设置停止状态并等待所有执行中的线程结束。
+	void
+	stop() ynothrow;
+
+	//! \pre 参数非空。
+	void
+	submit(std::unique_ptr<task_base>);
+
+	//! \brief 取得任务：依次尝试自身的队列、注入队列和其它工作线程的队列。
+	task_base*
+	find_task(worker&, size_t) ynothrow;
+
+	//! \brief 判断是否存在未被取得的任务。
+	bool
+	has_task() const ynothrow;
+
+	//! \brief 执行并释放任务。
+	void
+	run_task(task_base*) ynothrow;
+
+	void
+	run_worker(size_t, const function<void()>&, const function<void()>&);
+};
+
+
 /*!
 \brief 任务池：带有队列大小限制的线程池。
 \note 除非另行指定，所有公开成员函数线程安全。
 \since build 538
 \todo 允许调整队列大小限制。
 */
-class YB_API task_pool : private thread_pool
+class YB_API task_pool : private work_stealing_pool
 {
 private:
+	//! \since build 955
+	template<typename _func>
+	struct notified_task
+	{
+		task_pool& pool;
+		_func func;
+
+		void
+		operator()()
+		{
+			{
+				// NOTE: This prevents the notification from being lost between
+				//	the check and the wait in %wait_to_enqueue.
+				std::lock_guard<std::mutex> lck(pool.queue_mutex);
+			}
+			pool.enqueue_condition.notify_one();
+			func();
+		}
+	};
+
 	size_t max_tasks;
+	//! \since build 955
+	mutable std::mutex queue_mutex{};
 	std::condition_variable enqueue_condition{};
 
 public:
 	/*!
 	\brief 构造：使用指定的初始化和退出回调指定数量的工作线程和最大任务数。
-	\sa thread_pool::thread_pool
+	\sa work_stealing_pool::work_stealing_pool
 	\since build 852
 	*/
 	task_pool(size_t n, function<void()> on_enter = {},
 		function<void()> on_exit = {})
-		: thread_pool(std::max<size_t>(n, 1), on_enter, on_exit),
+		: work_stealing_pool(std::max<size_t>(n, 1), on_enter, on_exit),
 		max_tasks(std::max<size_t>(n, 1))
 	{}
 
@@ -230,7 +905,7 @@ public:
 	bool
 	can_enqueue_unlocked() const ynothrow
 	{
-		return size_unlocked() < max_tasks;
+		return size() < max_tasks;
 	}
 
 	size_t
@@ -300,7 +975,19 @@ public:
 	reset(size_t);
 	//@}
 
-	using thread_pool::size;
+	using work_stealing_pool::size;
+
+	/*!
+	\brief 取底层的工作窃取线程池。
+	\note 直接提交到结果的任务不受队列大小限制。
+	\sa task_graph::run
+	\since build 955
+	*/
+	work_stealing_pool&
+	get_pool() ynothrow
+	{
+		return *this;
+	}
 
 	//! \since build 623
 	//@{
@@ -322,24 +1009,29 @@ public:
 		}, duration, yforward(f), yforward(args)...);
 	}
 
+	/*!
+	\brief 等待操作进入队列。
+	\param f 准备进入队列的操作
+	\param args 进入队列操作时的参数。
+	\param waiter 等待操作。
+	\pre waiter 调用后满足条件变量后置条件；断言：持有锁。
+	\return 任务共享状态（若等待失败则无效）。
+	\warning 使用非递归锁，等待时不能再次锁定。
+	*/
 	template<typename _fWaiter, typename _fCallable, typename... _tParams>
 	future_result_t<_fCallable, _tParams...>
 	wait_to_enqueue(_fWaiter waiter, _fCallable&& f, _tParams&&... args)
 	{
-		return thread_pool::wait_to_enqueue(
-			[this, waiter](std::unique_lock<std::mutex>& lck) -> bool{
-			while(!can_enqueue_unlocked())
-				if(!waiter(lck))
-					return {};
-			return true;
-		}, [this, f](_tParams&&... f_args){
-			// TODO: Blocked. Use C++14 lambda initializers to implement
-			//	passing %f with %ystdex::decay_copy.
-			enqueue_condition.notify_one();
-			// XXX: Blocked. 'yforward' cause G++ 5.2 to fail (perhaps silently)
-			//	with exit code 1.
-			return ystdex::invoke(f, std::forward<_tParams>(f_args)...);
-		}, yforward(args)...);
+		auto bound(ystdex::pack_task(yforward(f), yforward(args)...));
+		auto res(bound.get_future());
+		std::unique_lock<std::mutex> lck(queue_mutex);
+
+		while(!can_enqueue_unlocked())
+			if(!waiter(lck))
+				return {};
+		yassume(lck.owns_lock());
+		post(notified_task<decltype(bound)>{*this, std::move(bound)});
+		return res;
 	}
 
 	template<typename _tTimePoint, typename _fCallable, typename... _tParams>
@@ -352,6 +1044,156 @@ public:
 	}
 	//@}
 };
+
+
+/*!
+\brief 取消标记。
+\note 副本共享状态。所有成员函数线程安全。
+\since build 955
+*/
+class YB_API cancellation_token
+{
+private:
+	std::shared_ptr<std::atomic<bool>> p_cancelled;
+
+public:
+	cancellation_token();
+
+	//! \brief 请求取消。
+	void
+	cancel() const ynothrow
+	{
+		p_cancelled->store(true);
+	}
+
+	bool
+	is_cancelled() const ynothrow
+	{
+		return p_cancelled->load();
+	}
+};
+
+
+/*!
+\brief 任务图：依赖任务构成的有向无环图。
+\warning 除非另行指定，非线程安全。
+\since build 955
+
+节点的任务在所有前驱节点结束后被提交到工作窃取线程池，
+	不阻塞工作线程等待前驱节点。
+取消标记被设置后，未开始的节点的任务被跳过，但节点仍视为结束。
+节点的任务抛出异常时，保存第一个异常并设置取消标记。
+*/
+class YB_API task_graph
+{
+public:
+	using node_id = size_t;
+
+private:
+	struct node
+	{
+		function<void()> task;
+		std::vector<node_id> successors{};
+		size_t predecessor_num = 0;
+		std::atomic<size_t> remained{0};
+
+		explicit
+		node(function<void()> f)
+			: task(std::move(f))
+		{}
+	};
+
+	std::vector<std::unique_ptr<node>> nodes{};
+	cancellation_token token;
+	work_stealing_pool* p_pool = {};
+	std::atomic<size_t> unfinished{0};
+	mutable std::mutex state_mutex{};
+	std::condition_variable finished{};
+	bool running = {};
+	std::exception_ptr exception{};
+
+public:
+	//! \brief 构造：使用指定的取消标记。
+	explicit
+	task_graph(cancellation_token = {});
+	task_graph(const task_graph&) = delete;
+	//! \brief 析构：等待运行中的节点结束。
+	~task_graph();
+
+	task_graph&
+	operator=(const task_graph&) = delete;
+
+	//! \note 线程安全。
+	bool
+	is_running() const;
+
+	const cancellation_token&
+	get_token() const ynothrow
+	{
+		return token;
+	}
+
+	//! \pre 未运行。
+	//@{
+	//! \brief 添加没有前驱的节点。
+	node_id
+	add(function<void()>);
+
+	/*!
+	\brief 添加第一参数指定节点作为唯一前驱的节点。
+	\pre 断言：第一参数是已添加的节点。
+	*/
+	node_id
+	then(node_id, function<void()>);
+
+	/*!
+	\brief 添加以第一参数中的所有节点作为前驱的节点。
+	\pre 断言：第一参数中的节点都是已添加的节点。
+	*/
+	node_id
+	when_all(std::initializer_list<node_id>, function<void()> = {});
+
+	/*!
+	\brief 添加依赖：第一参数指定的节点是第二参数指定的节点的前驱。
+	\pre 断言：参数都是已添加的节点。
+	*/
+	void
+	precede(node_id, node_id);
+
+	/*!
+	\brief 提交所有没有前驱的节点并开始运行。
+	\exception std::invalid_argument 存在环。
+	\note 运行结束前，线程池不能被析构。
+	\note 已运行结束的图可被再次运行。
+	*/
+	void
+	run(work_stealing_pool&);
+	//@}
+
+	size_t
+	size() const ynothrow
+	{
+		return nodes.size();
+	}
+
+	/*!
+	\brief 等待运行结束。
+	\throw 节点的任务抛出的第一个异常。
+	\note 线程安全。未运行时直接返回。
+	\warning 在线程池的工作线程中调用可能死锁。
+	*/
+	void
+	wait();
+
+private:
+	//! \brief 执行节点的任务并提交其后继中可运行的节点。
+	void
+	run_node(node_id) ynothrow;
+
+	//! \note 若不能提交，直接执行节点的任务。
+	void
+	schedule(node_id) ynothrow;
+};
 #	endif
 
 } // namespace ystdex;
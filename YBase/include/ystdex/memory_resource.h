@@ -11,13 +11,13 @@
 /*!	\file memory_resource.h
 \ingroup YStandardEx
 \brief 存储资源。
-\version r1570
+\version r1572
 \author FrankHB <frankhb1989@gmail.com>
 \since build 842
 \par 创建时间:
 	2018-10-27 19:30:12 +0800
 \par 修改时间:
-	2022-07-10 17:57 +0800
+	2026-10-17 15:44 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -112,21 +112,22 @@ pmr::polymorphic_allocator 对 is_bitwise_swappable 特化。
 #include "algorithm.hpp" // for ystdex::max;
 #include <unordered_map> // for std::unordered_map;
 #include <vector> // for std::vector;
-#if YB_Has_memory_resource != 1
-#	if (defined(__GLIBCXX__) && !(defined(_GLIBCXX_USE_C99_STDINT_TR1) \
+#if (defined(__GLIBCXX__) && !(defined(_GLIBCXX_USE_C99_STDINT_TR1) \
 	&& defined(_GLIBCXX_HAS_GTHREADS))) \
 	|| (defined(_LIBCPP_VERSION) && defined(_LIBCPP_HAS_NO_THREADS))
 // XXX: The synchonization does not work. However, this still makes
 //	%synchronized_pool_resource different than %unsynchronized_pool_resource in
 //	%ystdex::pmr. Preserving %ystdex::single_thread pseudo implementation
 //	introduces some basic checks of sanity on mutex types.
-#		include "pseudo_mutex.h" // for ystdex::single_thread::mutex,
+#	include "pseudo_mutex.h" // for ystdex::single_thread::mutex,
 //	ystdex::single_thread::lock_guard;
-#		define YB_Impl_mutex_ns ystdex::single_thread
-#	else
-#		include <mutex> // for std::mutex, std::lock_guard;
-#		define YB_Impl_mutex_ns std
-#	endif
+#	define YB_Impl_mutex_ns ystdex::single_thread
+#else
+#	include <mutex> // for std::mutex, std::lock_guard;
+#	define YB_Impl_mutex_ns std
+#endif
+#include <atomic> // for std::atomic;
+#if YB_Has_memory_resource != 1
 #	include "type_pun.hpp" // for pun_ref;
 #endif
 
@@ -967,12 +968,107 @@ protected:
 };
 //@}
 
-#	undef YB_Impl_mutex_ns
-
 #endif
 
 } // inline namespace cpp2017;
 
+/*!
+\brief 线程缓存的池资源。
+\note 所有成员函数线程安全。
+\warning 调用 release 时，其它线程不应同时分配或去配。
+\sa synchronized_pool_resource
+\since build 955
+
+接口同 synchronized_pool_resource ，但在池中分配的区块按大小分类保存在
+	每个线程的缓存中，使通常的分配和去配不需要锁。
+每个线程的缓存的每一类区块保存在容量有限的弹匣中。
+弹匣为空时从共享的池中成批分配，满时将一半区块成批归还共享的池。
+此外，线程去配时周期性地将在上一周期内未被使用的区块归还共享的池。
+若支持 thread_local ，线程退出时其缓存中的区块被归还共享的池；
+	但线程局部对象析构时去配的区块仍可被保留在缓存中。
+否则，线程退出后，其缓存中的区块保留至被复用线程局部存储的线程取得、
+	调用 release 或析构。
+使用 flush 可显式归还当前线程缓存的区块。
+*/
+class YB_API thread_cached_pool_resource : yimpl(public pool_resource)
+{
+private:
+	using mutex = YB_Impl_mutex_ns::mutex;
+	template<typename _tMutex>
+	using lock_guard = YB_Impl_mutex_ns::lock_guard<_tMutex>;
+	class local_cache;
+	//! \brief 线程退出时归还缓存的区块的资源的注册表。
+	class exit_registry;
+	using caches_t = std::vector<local_cache*>;
+
+	mutable mutex mtx{};
+	//! \brief 资源标识：不被不同的对象复用的非零值。
+	size_t id = next_id();
+	/*!
+	\brief 线程缓存的代：调用 release 时递增以丢弃缓存中的区块。
+	\note 线程缓存在下次使用时检查。
+	*/
+	std::atomic<size_t> generation{0};
+	//! \brief 被缓存的区块大小的以 2 为底的对数的上界。
+	size_t class_limit = get_class_limit(options());
+	/*!
+	\brief 被资源所有的线程缓存。
+	\note 通过 mtx 同步访问。
+	*/
+	caches_t caches{};
+
+public:
+	yimpl(using) pool_resource::pool_resource;
+	~thread_cached_pool_resource() override;
+
+	/*!
+	\brief 将当前线程缓存的区块归还共享的池。
+	\note 不影响其它线程的缓存。
+	*/
+	void
+	flush() ynothrow;
+
+	//! \post 所有线程缓存中的区块在下次使用前被丢弃。
+	void
+	release() yimpl(ynothrow);
+
+protected:
+	YB_ALLOCATOR YB_ATTR(alloc_align(3), alloc_size(2)) YB_ATTR_returns_nonnull
+		void*
+	do_allocate(size_t, size_t) override;
+
+	void
+	do_deallocate(void*, size_t, size_t) yimpl(ynothrowv) override;
+
+private:
+	//! \return 被缓存的区块的分类，或 class_limit 表示不被缓存。
+	YB_ATTR_nodiscard YB_PURE size_t
+	find_class(size_t, size_t) const ynothrow;
+
+	//! \brief 归还弹匣底部的指定数量的区块。
+	void
+	flush_blocks(local_cache&, size_t, size_t) ynothrow;
+
+	YB_ATTR_nodiscard YB_PURE static size_t
+	get_class_limit(const pool_options&) ynothrow;
+
+	//! \return 当前线程的缓存，或空指针表示不可用。
+	YB_ATTR_nodiscard local_cache*
+	get_local() ynothrow;
+
+	YB_ATTR_nodiscard local_cache*
+	get_local_slow() ynothrow;
+
+	YB_ATTR_nodiscard static size_t
+	next_id() ynothrow;
+
+	//! \brief 归还在上一周期内未被使用的区块。
+	void
+	trim(local_cache&) ynothrow;
+};
+
+#undef YB_Impl_mutex_ns
+
 } // namespace pmr;
 
 /*!
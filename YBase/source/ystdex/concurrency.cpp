@@ -11,13 +11,13 @@
 /*!	\file concurrency.cpp
 \ingroup YStandardEx
 \brief 并发操作。
-\version r169
+\version r172
 \author FrankHB <frankhb1989@gmail.com>
 \since build 520
 \par 创建时间:
 	2014-07-21 19:09:18 +0800
 \par 修改时间:
-	2019-08-01 18:14 +0800
+	2026-10-17 17:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -30,7 +30,10 @@
 	&& defined(_GLIBCXX_HAS_GTHREADS) && defined(_GLIBCXX_USE_C99_STDINT_TR1)) \
 	|| (defined(_LIBCPP_VERSION) && !defined(_LIBCPP_HAS_NO_THREADS))
 #include <sstream>
-#include "ystdex/concurrency.h"
+#include "ystdex/concurrency.h" // for std::atomic, std::unique_ptr;
+#include "ystdex/swap.hpp" // for ystdex::exchange;
+#include <cstddef> // for std::ptrdiff_t;
+#include <stdexcept> // for std::invalid_argument;
 
 namespace ystdex
 {
@@ -125,13 +128,551 @@ thread_pool::size() const
 	return size_unlocked();
 }
 
+
+//! \since build 955
+namespace
+{
+
+//! \brief 工作线程在阻塞等待前让出的次数。
+yconstexpr const size_t spin_count(yimpl(64));
+
+} // unnamed namespace;
+
+/*!
+\brief 工作线程数据：包含 Chase-Lev 双端队列。
+\see https://doi.org/10.1145/1073970.1073974 。
+\see https://doi.org/10.1145/2442516.2442524 。
+\since build 955
+
+只有所有者线程调用 push 和 pop ；任意线程可调用 steal 和 empty 。
+替换的环形缓冲区保留至析构，因为并发的窃取可能仍在读取。
+*/
+class work_stealing_pool::worker
+{
+private:
+	struct ring
+	{
+		size_t mask;
+		std::unique_ptr<std::atomic<task_base*>[]> data;
+
+		explicit
+		ring(size_t n)
+			: mask(n - 1), data(new std::atomic<task_base*>[n])
+		{}
+
+		task_base*
+		get(std::ptrdiff_t i) const ynothrow
+		{
+			return data[size_t(i) & mask].load(std::memory_order_relaxed);
+		}
+
+		void
+		put(std::ptrdiff_t i, task_base* p) ynothrow
+		{
+			data[size_t(i) & mask].store(p, std::memory_order_relaxed);
+		}
+	};
+
+	// NOTE: The fences in the cited implementation are replaced by
+	//	sequentially consistent operations on the indices. This also makes
+	//	the synchronization visible to the sanitizers.
+	std::atomic<std::ptrdiff_t> top{0};
+	std::atomic<std::ptrdiff_t> bottom{0};
+	std::atomic<ring*> p_ring{};
+	std::vector<std::unique_ptr<ring>> rings{};
+
+public:
+	worker()
+	{
+		rings.emplace_back(new ring(yimpl(64)));
+		p_ring.store(rings.back().get());
+	}
+
+	bool
+	empty() const ynothrow
+	{
+		return bottom.load() <= top.load();
+	}
+
+	task_base*
+	pop() ynothrow
+	{
+		const auto b(bottom.load(std::memory_order_relaxed) - 1);
+		const auto p(p_ring.load(std::memory_order_relaxed));
+
+		bottom.store(b);
+
+		auto t(top.load());
+
+		if(t <= b)
+		{
+			auto res(p->get(b));
+
+			if(t == b)
+			{
+				if(!top.compare_exchange_strong(t, t + 1))
+					res = {};
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return res;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return {};
+	}
+
+	void
+	push(task_base* p_task)
+	{
+		const auto b(bottom.load(std::memory_order_relaxed));
+		const auto t(top.load(std::memory_order_acquire));
+		auto p(p_ring.load(std::memory_order_relaxed));
+
+		if(size_t(b - t) > p->mask)
+		{
+			rings.emplace_back(new ring((p->mask + 1) * 2));
+
+			const auto p_new(rings.back().get());
+
+			for(auto i(t); i != b; ++i)
+				p_new->put(i, p->get(i));
+			p_ring.store(p_new, std::memory_order_release);
+			p = p_new;
+		}
+		p->put(b, p_task);
+		// NOTE: This is sequentially consistent to be ordered before the check
+		//	of sleeping workers in %work_stealing_pool::submit.
+		bottom.store(b + 1);
+	}
+
+	//! \note 若队列为空或和其它线程竞争失败，结果为空指针。
+	task_base*
+	steal() ynothrow
+	{
+		auto t(top.load());
+
+		if(t < bottom.load())
+		{
+			const auto res(p_ring.load(std::memory_order_acquire)->get(t));
+
+			if(top.compare_exchange_strong(t, t + 1))
+				return res;
+		}
+		return {};
+	}
+};
+
+
+work_stealing_pool::task_base::~task_base() = default;
+
+
+work_stealing_pool::work_stealing_pool(size_t n, function<void()> on_enter,
+	function<void()> on_exit)
+{
+	start(n, on_enter, on_exit);
+}
+work_stealing_pool::~work_stealing_pool() ynothrow
+{
+	stop();
+}
+
+void
+work_stealing_pool::reset(size_t n, function<void()> on_enter,
+	function<void()> on_exit)
+{
+	stop();
+	workers.clear();
+	threads.clear();
+	// NOTE: The tasks not run are released by %stop.
+	pending.store(0);
+	sleeping.store(0);
+	stopped.store({});
+	start(n, on_enter, on_exit);
+}
+
+void
+work_stealing_pool::start(size_t n, const function<void()>& on_enter,
+	const function<void()>& on_exit)
+{
+	workers.reserve(n);
+	for(size_t i = 0; i < n; ++i)
+		workers.emplace_back(new worker());
+	threads.reserve(n);
+	for(size_t i = 0; i < n; ++i)
+		threads.emplace_back([=]{
+			run_worker(i, on_enter, on_exit);
+		});
+}
+
+void
+work_stealing_pool::stop() ynothrow
+{
+	try
+	{
+		try
+		{
+			std::lock_guard<std::mutex> lck(park_mutex);
+
+			stopped.store(true);
+		}
+		catch(std::system_error&)
+		{
+			yassume(false);
+		}
+		park_condition.notify_all();
+		for(auto& thrd : threads)
+			try
+			{
+				thrd.join();
+			}
+			catch(std::system_error&)
+			{}
+	}
+	catch(...)
+	{
+		yassume(false);
+	}
+	// NOTE: Only the injected tasks can remain, when there is no worker.
+	for(auto p = injected.exchange({}); p;)
+		delete ystdex::exchange(p, p->next);
+}
+
+namespace
+{
+
+//! \since build 955
+//@{
+ythread work_stealing_pool* p_current_pool;
+ythread size_t current_index;
+//@}
+
+} // unnamed namespace;
+
+void
+work_stealing_pool::submit(std::unique_ptr<task_base> p_task)
+{
+	yassume(p_task);
+	pending.fetch_add(1);
+	if(p_current_pool == this)
+	{
+		try
+		{
+			workers[current_index]->push(p_task.get());
+		}
+		catch(...)
+		{
+			pending.fetch_sub(1);
+			throw;
+		}
+	}
+	else
+	{
+		auto& next(p_task->next);
+
+		next = injected.load(std::memory_order_relaxed);
+		while(!injected.compare_exchange_weak(next, p_task.get()))
+			;
+	}
+	p_task.release();
+	if(sleeping.load() != 0)
+	{
+		{
+			std::lock_guard<std::mutex> lck(park_mutex);
+		}
+		park_condition.notify_one();
+	}
+}
+
+work_stealing_pool::task_base*
+work_stealing_pool::find_task(worker& w, size_t idx) ynothrow
+{
+	if(const auto p = w.pop())
+		return p;
+	if(auto p = injected.exchange(nullptr))
+	{
+		// NOTE: The injected list is in LIFO order. The remained tasks are
+		//	moved to the local queue to be stolen by other workers.
+		task_base* p_rev{};
+
+		while(p)
+			p_rev = ystdex::exchange(p, ystdex::exchange(p->next, p_rev));
+
+		const auto res(p_rev);
+
+		for(p = res->next; p; p = p->next)
+			try
+			{
+				w.push(p);
+			}
+			catch(...)
+			{
+				// XXX: Put the remained tasks back on allocation failure.
+				auto p_last(p);
+
+				while(p_last->next)
+					p_last = p_last->next;
+				p_last->next = injected.load(std::memory_order_relaxed);
+				while(!injected.compare_exchange_weak(p_last->next, p))
+					;
+				break;
+			}
+		return res;
+	}
+
+	const auto n(workers.size());
+
+	for(size_t i(1); i < n; ++i)
+		if(const auto p = workers[(idx + i) % n]->steal())
+			return p;
+	return {};
+}
+
+bool
+work_stealing_pool::has_task() const ynothrow
+{
+	if(injected.load())
+		return true;
+	for(const auto& p_worker : workers)
+		if(!p_worker->empty())
+			return true;
+	return {};
+}
+
+void
+work_stealing_pool::run_task(task_base* p_task) ynothrow
+{
+	const std::unique_ptr<task_base> p(p_task);
+
+	pending.fetch_sub(1);
+	(*p)();
+}
+
+void
+work_stealing_pool::run_worker(size_t idx, const function<void()>& on_enter,
+	const function<void()>& on_exit)
+{
+	auto& w(*workers[idx]);
+
+	yunseq(p_current_pool = this, current_index = idx);
+	if(on_enter)
+		on_enter();
+	while(true)
+	{
+		auto p_task(find_task(w, idx));
+
+		for(size_t i(0); !p_task && i < spin_count; ++i)
+		{
+			std::this_thread::yield();
+			p_task = find_task(w, idx);
+		}
+		if(p_task)
+			run_task(p_task);
+		else
+		{
+			std::unique_lock<std::mutex> lck(park_mutex);
+
+			sleeping.fetch_add(1);
+			park_condition.wait(lck, [this]{
+				return stopped.load() || has_task();
+			});
+			sleeping.fetch_sub(1);
+			if(stopped.load() && !has_task())
+				break;
+		}
+	}
+	if(on_exit)
+		on_exit();
+	p_current_pool = {};
+}
+
+
 void
 task_pool::reset(size_t tasks_num)
 {
-	auto& threads(static_cast<thread_pool&>(*this));
+	work_stealing_pool::reset(tasks_num);
+}
+
+
+cancellation_token::cancellation_token()
+	: p_cancelled(std::make_shared<std::atomic<bool>>(false))
+{}
+
+
+task_graph::task_graph(cancellation_token tok)
+	: token(std::move(tok))
+{}
+task_graph::~task_graph()
+{
+	std::unique_lock<std::mutex> lck(state_mutex);
+
+	finished.wait(lck, [this]() ynothrow{
+		return !running;
+	});
+}
+
+bool
+task_graph::is_running() const
+{
+	std::lock_guard<std::mutex> lck(state_mutex);
+
+	return running;
+}
+
+task_graph::node_id
+task_graph::add(function<void()> f)
+{
+	yconstraint(!running);
+	nodes.emplace_back(new node(std::move(f)));
+	return nodes.size() - 1;
+}
+
+task_graph::node_id
+task_graph::then(node_id pred, function<void()> f)
+{
+	const auto id(add(std::move(f)));
+
+	precede(pred, id);
+	return id;
+}
+
+task_graph::node_id
+task_graph::when_all(std::initializer_list<node_id> preds, function<void()> f)
+{
+	const auto id(add(std::move(f)));
 
-	threads.~thread_pool();
-	::new(&threads) thread_pool(tasks_num);
+	for(const auto pred : preds)
+		precede(pred, id);
+	return id;
+}
+
+void
+task_graph::precede(node_id pred, node_id succ)
+{
+	yconstraint(!running);
+	yconstraint(pred < nodes.size() && succ < nodes.size());
+	nodes[pred]->successors.push_back(succ);
+	++nodes[succ]->predecessor_num;
+}
+
+void
+task_graph::run(work_stealing_pool& pool)
+{
+	yconstraint(!running);
+
+	const auto n(nodes.size());
+	std::vector<size_t> indegrees;
+	std::vector<node_id> ready;
+
+	// NOTE: A cyclic graph would never finish, so it is rejected by
+	//	Kahn's algorithm before any task is submitted.
+	indegrees.reserve(n);
+	for(node_id i(0); i < n; ++i)
+	{
+		indegrees.push_back(nodes[i]->predecessor_num);
+		if(indegrees.back() == 0)
+			ready.push_back(i);
+	}
+
+	const auto roots(ready);
+	size_t visited(0);
+
+	while(!ready.empty())
+	{
+		const auto i(ready.back());
+
+		ready.pop_back();
+		++visited;
+		for(const auto j : nodes[i]->successors)
+			if(--indegrees[j] == 0)
+				ready.push_back(j);
+	}
+	if(visited != n)
+		throw std::invalid_argument("Cyclic task graph found.");
+	if(n != 0)
+	{
+		for(const auto& p_node : nodes)
+			p_node->remained.store(p_node->predecessor_num);
+		p_pool = &pool;
+		unfinished.store(n);
+		{
+			std::lock_guard<std::mutex> lck(state_mutex);
+
+			yunseq(running = true, exception = {});
+		}
+		for(const auto i : roots)
+			schedule(i);
+	}
+}
+
+void
+task_graph::wait()
+{
+	std::unique_lock<std::mutex> lck(state_mutex);
+
+	finished.wait(lck, [this]() ynothrow{
+		return !running;
+	});
+	if(exception)
+		std::rethrow_exception(exception);
+}
+
+void
+task_graph::run_node(node_id id) ynothrow
+{
+	auto& nd(*nodes[id]);
+
+	if(!token.is_cancelled() && nd.task)
+		try
+		{
+			nd.task();
+		}
+		catch(...)
+		{
+			{
+				std::lock_guard<std::mutex> lck(state_mutex);
+
+				if(!exception)
+					exception = std::current_exception();
+			}
+			token.cancel();
+		}
+	for(const auto i : nd.successors)
+		if(nodes[i]->remained.fetch_sub(1) == 1)
+			schedule(i);
+	if(unfinished.fetch_sub(1) == 1)
+	{
+		// NOTE: The notification is under the lock, as the graph can be
+		//	destroyed by the waiter once it is unlocked.
+		std::lock_guard<std::mutex> lck(state_mutex);
+
+		running = {};
+		finished.notify_all();
+	}
+}
+
+void
+task_graph::schedule(node_id id) ynothrow
+{
+	struct runner final
+	{
+		task_graph& graph;
+		node_id id;
+
+		void
+		operator()() const ynothrow
+		{
+			graph.run_node(id);
+		}
+	};
+
+	try
+	{
+		p_pool->post(runner{*this, id});
+	}
+	catch(...)
+	{
+		// NOTE: The node is run in place when it cannot be submitted.
+		run_node(id);
+	}
 }
 #	endif
 
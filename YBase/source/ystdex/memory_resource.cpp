@@ -11,13 +11,13 @@
 /*!	\file memory_resource.cpp
 \ingroup YStandardEx
 \brief 存储资源。
-\version r1844
+\version r1846
 \author FrankHB <frankhb1989@gmail.com>
 \since build 842
 \par 创建时间:
 	2018-10-27 19:30:12 +0800
 \par 修改时间:
-	2022-09-05 22:07 +0800
+	2026-10-17 15:44 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -30,14 +30,13 @@
 //	::operator new, ::operator delete, std::unique_ptr, make_observer, YAssert,
 //	lref, yassume, ystdex::destruct_in, yverify, yconstraint, CHAR_BIT,
 //	is_power_of_2_positive, ceiling_lb, std::swap, std::piecewise_construct,
-//	std::forward_as_tuple, PTRDIFF_MAX, ystdex::aligned_store_cast;
-#if YB_Has_memory_resource != 1
-#	include <atomic> // for std::atomic;
-#endif
+//	std::forward_as_tuple, PTRDIFF_MAX, ystdex::aligned_store_cast, std::atomic,
+//	std::memory_order_acquire, std::memory_order_release, std::nothrow;
 #include "ystdex/pointer.hpp" // for tidy_ptr;
 #include "ystdex/scope_guard.hpp" // for unique_guard, ystdex::dismiss;
 #include "ystdex/algorithm.hpp" // for std::min, std::max,
-//	ystdex::lower_bound_n;
+//	ystdex::lower_bound_n, std::any_of, std::copy, std::find, std::find_if,
+//	std::remove_if;
 
 namespace ystdex
 {
@@ -886,6 +885,431 @@ YB_Impl_do_is_equal(, monotonic_buffer_resource::)
 
 #endif
 
+namespace
+{
+
+//! \since build 955
+//@{
+struct local_entry
+{
+	size_t id;
+	void* p_cache;
+};
+
+//! \brief 每个线程直接访问的缓存数。
+yconstexpr const size_t local_entry_num = yimpl(4);
+//! \brief 周期性归还区块的去配次数间隔。
+yconstexpr const size_t trim_interval = yimpl(4096);
+
+// NOTE: These objects are trivially destructible to make them also work with
+//	'__thread'. The address of %local_next also identifies the owner thread of
+//	the caches. Once the owner thread has exited, the cache is reused by the
+//	thread having the same address, if any.
+ythread local_entry local_entries[local_entry_num];
+ythread size_t local_next;
+#if YB_HAS_THREAD_LOCAL
+//! \brief 当前线程的退出时的归还是否已被进行。
+ythread bool local_exited;
+#endif
+//@}
+
+} // unnamed namespace;
+
+//! \since build 955
+class thread_cached_pool_resource::local_cache final
+{
+public:
+	class magazine final
+	{
+	public:
+		std::unique_ptr<void*[]> blocks{};
+		size_t count = 0;
+		//! \brief 本周期内保留在弹匣底部的区块数。
+		size_t low = 0;
+		size_t capacity;
+
+		//! \note 较大的区块使用较小的容量，但容量不小于 2 。
+		explicit
+		magazine(size_t lb) ynothrow
+			: capacity(lb < 15 ? std::max(std::min(size_t(yimpl(64)),
+			size_t(yimpl(1) << 15) >> lb), size_t(2)) : 2)
+		{}
+		magazine(magazine&&) = default;
+
+		//! \brief 按需分配弹匣的存储。
+		YB_ATTR_nodiscard bool
+		reserve() ynothrow
+		{
+			if(YB_UNLIKELY(!blocks))
+				blocks.reset(new(std::nothrow) void*[capacity]);
+			return bool(blocks);
+		}
+	};
+
+	const void* owner = &local_next;
+	size_t generation;
+	size_t ops = 0;
+	std::vector<magazine> magazines{};
+
+	local_cache(size_t n, size_t gen)
+		: generation(gen)
+	{
+		magazines.reserve(n);
+		for(size_t lb(0); lb < n; ++lb)
+			magazines.emplace_back(lb);
+	}
+
+	//! \brief 丢弃所有区块。
+	void
+	reset(size_t gen) ynothrow
+	{
+		for(auto& mag : magazines)
+			yunseq(mag.count = 0, mag.low = 0);
+		generation = gen;
+	}
+};
+
+#if YB_HAS_THREAD_LOCAL
+//! \since build 955
+class thread_cached_pool_resource::exit_registry final
+{
+private:
+	//! \brief 线程退出时归还当前线程缓存的区块。
+	class hook final
+	{
+	public:
+		//! \brief 当前线程具有缓存的资源标识。
+		std::vector<size_t> ids{};
+
+		~hook()
+		{
+			local_exited = true;
+			get().flush_local(ids);
+		}
+	};
+
+	mutex mtx{};
+	//! \brief 被注册的资源的标识和指针。
+	std::vector<std::pair<size_t, thread_cached_pool_resource*>> resources{};
+
+public:
+	/*!
+	\note 对象不被销毁，以允许在静态对象析构后退出的线程访问。
+	\throw std::bad_alloc 第一次调用时分配失败。
+	*/
+	YB_ATTR_nodiscard static exit_registry&
+	get()
+	{
+		static auto& r(*new exit_registry());
+
+		return r;
+	}
+
+	/*!
+	\brief 注册资源，使当前线程退出时归还其缓存的区块。
+	\pre 未持有资源的锁。
+	\throw std::bad_alloc 分配失败。
+	\note 当前线程的归还被进行后忽略。
+	*/
+	void
+	add(thread_cached_pool_resource& rsrc)
+	{
+		if(YB_UNLIKELY(local_exited))
+			return;
+
+		static ythread hook h;
+		auto& ids(h.ids);
+
+		if(std::find(ids.cbegin(), ids.cend(), rsrc.id) == ids.cend())
+		{
+			lock_guard<mutex> gd(mtx);
+
+			// NOTE: Identifiers of the destroyed resources are removed to keep
+			//	the list small in long-running threads.
+			ids.erase(std::remove_if(ids.begin(), ids.end(), [&](size_t i)
+				ynothrow{
+				return !registered(i);
+			}), ids.end());
+			if(!registered(rsrc.id))
+				resources.emplace_back(rsrc.id, &rsrc);
+			ids.push_back(rsrc.id);
+		}
+	}
+
+	//! \note 持有锁时调用 flush 以和 remove 互斥。
+	void
+	flush_local(const std::vector<size_t>& ids) ynothrow
+	{
+		lock_guard<mutex> gd(mtx);
+
+		for(const auto& pr : resources)
+			if(std::find(ids.cbegin(), ids.cend(), pr.first) != ids.cend())
+				pr.second->flush();
+	}
+
+	void
+	remove(size_t i) ynothrow
+	{
+		lock_guard<mutex> gd(mtx);
+
+		resources.erase(std::remove_if(resources.begin(), resources.end(),
+			[=](const std::pair<size_t, thread_cached_pool_resource*>& pr)
+			ynothrow{
+			return pr.first == i;
+		}), resources.end());
+	}
+
+private:
+	//! \pre 持有锁。
+	YB_ATTR_nodiscard YB_PURE bool
+	registered(size_t i) const ynothrow
+	{
+		return std::find_if(resources.cbegin(), resources.cend(),
+			[=](const std::pair<size_t, thread_cached_pool_resource*>& pr)
+			ynothrow{
+			return pr.first == i;
+		}) != resources.cend();
+	}
+};
+#endif
+
+thread_cached_pool_resource::~thread_cached_pool_resource()
+{
+#if YB_HAS_THREAD_LOCAL
+	// NOTE: The resource is not registered if no cache has been created.
+	if(!caches.empty())
+		exit_registry::get().remove(id);
+#endif
+	for(const auto p_cache : caches)
+		delete p_cache;
+}
+
+void
+thread_cached_pool_resource::flush() ynothrow
+{
+	const auto gen(generation.load(std::memory_order_acquire));
+	lock_guard<mutex> gd(mtx);
+
+	for(const auto p_cache : caches)
+		if(p_cache->owner == &local_next)
+		{
+			auto& c(*p_cache);
+
+			if(c.generation == gen)
+				for(size_t lb(0); lb < c.magazines.size(); ++lb)
+					flush_blocks(c, lb, c.magazines[lb].count);
+			c.reset(gen);
+			break;
+		}
+}
+
+void
+thread_cached_pool_resource::release() yimpl(ynothrow)
+{
+	lock_guard<mutex> gd(mtx);
+
+	pool_resource::release();
+	generation.fetch_add(1, std::memory_order_release);
+}
+
+void*
+thread_cached_pool_resource::do_allocate(size_t bytes, size_t alignment)
+{
+	const auto lb(find_class(bytes, alignment));
+
+	if(lb != class_limit)
+		if(const auto p_cache = get_local())
+		{
+			auto& mag(p_cache->magazines[lb]);
+
+			if(YB_LIKELY(mag.count != 0))
+			{
+				--mag.count;
+				mag.low = std::min(mag.low, mag.count);
+				return mag.blocks[mag.count];
+			}
+			if(mag.reserve())
+			{
+				lock_guard<mutex> gd(mtx);
+
+				// NOTE: Refill a half of the magazine. Blocks allocated before
+				//	an exception thrown are kept in the magazine.
+				while(mag.count + 1 < mag.capacity / 2)
+					mag.blocks[mag.count++]
+						= pool_resource::do_allocate(bytes, alignment);
+				return pool_resource::do_allocate(bytes, alignment);
+			}
+		}
+
+	lock_guard<mutex> gd(mtx);
+
+	return pool_resource::do_allocate(bytes, alignment);
+}
+
+void
+thread_cached_pool_resource::do_deallocate(void* p, size_t bytes,
+	size_t alignment) yimpl(ynothrowv)
+{
+	const auto lb(find_class(bytes, alignment));
+
+	if(lb != class_limit)
+		if(const auto p_cache = get_local())
+		{
+			auto& c(*p_cache);
+			auto& mag(c.magazines[lb]);
+
+			if(mag.reserve())
+			{
+				if(YB_UNLIKELY(mag.count == mag.capacity))
+				{
+					lock_guard<mutex> gd(mtx);
+
+					flush_blocks(c, lb, mag.capacity / 2);
+				}
+				mag.blocks[mag.count++] = p;
+				if(YB_UNLIKELY(++c.ops == trim_interval))
+					trim(c);
+				return;
+			}
+		}
+
+	lock_guard<mutex> gd(mtx);
+
+	pool_resource::do_deallocate(p, bytes, alignment);
+}
+
+size_t
+thread_cached_pool_resource::find_class(size_t bytes, size_t alignment) const
+	ynothrow
+{
+	if(bytes <= options().largest_required_pool_block)
+	{
+		const auto
+			lb(ceiling_lb(resource_pool::adjust_for_block(bytes, alignment)));
+
+		if(lb < class_limit)
+			return lb;
+	}
+	return class_limit;
+}
+
+void
+thread_cached_pool_resource::flush_blocks(local_cache& c, size_t lb, size_t n)
+	ynothrow
+{
+	auto& mag(c.magazines[lb]);
+
+	yassume(n <= mag.count);
+	for(size_t i(0); i < n; ++i)
+		// NOTE: Any arguments mapped to the pool of the class work. Since
+		//	%lb is no less than the binary logarithm of the size of the block
+		//	metadata, the alignment determines the pool.
+		pool_resource::do_deallocate(mag.blocks[i], 0, size_t(1) << lb);
+	std::copy(&mag.blocks[n], &mag.blocks[mag.count], &mag.blocks[0]);
+	yunseq(mag.count -= n, mag.low = mag.low > n ? mag.low - n : 0);
+}
+
+size_t
+thread_cached_pool_resource::get_class_limit(const pool_options& opts)
+	ynothrow
+{
+	return ceiling_lb(resource_pool::adjust_for_block(
+		opts.largest_required_pool_block, 1)) + 1;
+}
+
+thread_cached_pool_resource::local_cache*
+thread_cached_pool_resource::get_local() ynothrow
+{
+	local_cache* p_cache{};
+
+	for(const auto& entry : local_entries)
+		if(entry.id == id)
+		{
+			p_cache = static_cast<local_cache*>(entry.p_cache);
+			break;
+		}
+	if(YB_UNLIKELY(!p_cache))
+		p_cache = get_local_slow();
+	if(YB_LIKELY(p_cache))
+	{
+		const auto gen(generation.load(std::memory_order_acquire));
+
+		if(YB_UNLIKELY(p_cache->generation != gen))
+			p_cache->reset(gen);
+	}
+	return p_cache;
+}
+
+thread_cached_pool_resource::local_cache*
+thread_cached_pool_resource::get_local_slow() ynothrow
+{
+	local_cache* p_cache{};
+
+	{
+		lock_guard<mutex> gd(mtx);
+
+		for(const auto p : caches)
+			if(p->owner == &local_next)
+			{
+				p_cache = p;
+				break;
+			}
+		if(!p_cache)
+			try
+			{
+				std::unique_ptr<local_cache> p(new local_cache(class_limit,
+					generation.load(std::memory_order_acquire)));
+
+				caches.push_back(p.get());
+				p_cache = p.release();
+			}
+			catch(std::bad_alloc&)
+			{
+				return {};
+			}
+	}
+#if YB_HAS_THREAD_LOCAL
+	// NOTE: The registry is locked after the resource is unlocked, as the
+	//	order in %exit_registry::flush_local. If the registration fails, the
+	//	blocks are kept in the cache after the thread exits.
+	try
+	{
+		exit_registry::get().add(*this);
+	}
+	catch(std::bad_alloc&)
+	{}
+#endif
+	local_entries[local_next] = {id, p_cache};
+	local_next = (local_next + 1) % local_entry_num;
+	return p_cache;
+}
+
+size_t
+thread_cached_pool_resource::next_id() ynothrow
+{
+	static std::atomic<size_t> last_id(0);
+
+	return ++last_id;
+}
+
+void
+thread_cached_pool_resource::trim(local_cache& c) ynothrow
+{
+	c.ops = 0;
+	if(std::any_of(c.magazines.cbegin(), c.magazines.cend(),
+		[](const local_cache::magazine& mag) ynothrow{
+		return mag.low != 0;
+	}))
+	{
+		lock_guard<mutex> gd(mtx);
+
+		for(size_t lb(0); lb < c.magazines.size(); ++lb)
+			flush_blocks(c, lb, c.magazines[lb].low);
+	}
+	for(auto& mag : c.magazines)
+		mag.low = mag.count;
+}
+
 #undef YB_Impl_do_is_equal
 #undef YB_Impl_do_is_equal_impl
 
@@ -11,13 +11,13 @@
 /*!	\file Environment.h
 \ingroup Helper
 \brief 环境。
-\version r1160
+\version r1161
 \author FrankHB <frankhb1989@gmail.com>
 \since build 521
 \par 创建时间:
 	2013-02-08 01:28:03 +0800
 \par 修改时间:
-	2022-09-13 06:37 +0800
+	2026-10-17 14:55 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -101,7 +101,8 @@ public:
 
 private:
 #	if YF_Helper_Environment_NPL_UseBacktrace
-	NPL::ContextNode::ReducerSequence backtrace{Global.Allocator};
+	// NOTE: The frames are shifted from the current actions of %Main.
+	NPL::ContextNode::ReducerSequence backtrace{Main.GetFrameAllocator()};
 #	endif
 	//@}
 
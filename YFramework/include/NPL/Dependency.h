@@ -11,13 +11,13 @@
 /*!	\file Dependency.h
 \ingroup NPL
 \brief 依赖管理。
-\version r640
+\version r648
 \author FrankHB <frankhb1989@gmail.com>
 \since build 623
 \par 创建时间:
 	2015-08-09 22:12:37 +0800
 \par 修改时间:
-	2022-09-14 01:32 +0800
+	2026-10-17 16:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -29,9 +29,12 @@
 #define NPL_INC_Dependency_h_
 
 #include "YModules.h"
-#include YFM_NPL_NPLA1 // for string, vector, GlobalState, YSLib::unique_ptr;
+#include YFM_NPL_NPLA1 // for string, vector, TermNode, byte, GlobalState,
+//	YSLib::unique_ptr;
 #include <istream> // for std::istream;
 #include <ystdex/scope_guard.hpp> // for ystdex::guard;
+#include <regex> // for std::regex;
+#include <ystdex/cache.hpp> // for ystdex::used_list_cache;
 
 namespace NPL
 {
@@ -70,6 +73,282 @@ FilterMakefileDependencies(vector<string>&);
 namespace A1
 {
 
+/*!
+\brief 字符串构建器：作为 NPLA1 对象语言的字符串构建器类型的值的宿主类型。
+\warning 非虚析构。
+\sa LoadModule_std_strings
+\since build 955
+
+保存字符串片段的序列，追加片段的均摊时间复杂度为 O(1) 。
+片段在首次读取结果时被合并为一个字符串，之后的读取不再复制片段。
+*/
+class YF_API StringBuilder final
+{
+public:
+	using allocator_type = vector<string>::allocator_type;
+
+private:
+	//! \invariant 片段的长度之和等于 length 。
+	mutable vector<string> pieces;
+	size_t length = 0;
+
+public:
+	explicit
+	StringBuilder(allocator_type a = allocator_type())
+		: pieces(a)
+	{}
+	StringBuilder(const StringBuilder& sb, allocator_type a)
+		: pieces(sb.pieces, a), length(sb.length)
+	{}
+	DefDeCopyMoveCtorAssignment(StringBuilder)
+
+	YB_ATTR_nodiscard
+		PDefH(allocator_type, get_allocator, ) const ynothrow
+		ImplRet(pieces.get_allocator())
+
+	DefGetter(const ynothrow, size_t, Length, length)
+	/*!
+	\brief 取合并的字符串。
+	\note 合并片段，不影响可观察的值。
+	*/
+	YB_ATTR_nodiscard const string&
+	GetString() const;
+
+	//! \brief 追加字符串片段。
+	//@{
+	void
+	Append(string&&);
+	void
+	Append(string_view);
+	//@}
+
+	void
+	clear() ynothrow;
+};
+
+/*!
+\brief 正则表达式缓存：保存按模式串编译的正则表达式。
+\note 使用最近最少使用策略替换超出容量的项。
+\sa GlobalState::RegexCachePtr
+\sa LoadModule_std_strings
+\since build 955
+
+对相同的模式串，避免重复编译正则表达式。
+*/
+class YF_API RegexCache final
+{
+public:
+	//! \brief 缓存的统计。
+	struct Statistics final
+	{
+		size_t Hits = 0;
+		size_t Misses = 0;
+		size_t Evictions = 0;
+	};
+
+	//! \brief 默认容量。
+	static yconstexpr const size_t DefaultCapacity = yimpl(64);
+
+private:
+	ystdex::used_list_cache<string, std::regex> cache;
+	Statistics statistics{};
+
+public:
+	explicit
+	RegexCache(size_t = DefaultCapacity);
+	//! \note 刷新函数引用此对象，因此不可复制和转移。
+	DefDelCopyCtor(RegexCache)
+	DefDelCopyAssignment(RegexCache)
+
+	YB_ATTR_nodiscard
+		PDefH(size_t, GetCapacity, ) const ynothrow
+		ImplRet(cache.get_max_use())
+	DefGetter(const ynothrow, size_t, Size, cache.size())
+	DefGetter(const ynothrow, const Statistics&, Statistics, statistics)
+	/*!
+	\brief 取模式串对应的正则表达式，若不存在则编译并插入缓存。
+	\exception std::regex_error 模式串无效。
+	\note 结果在之后插入其它项的调用后可能失效。
+	*/
+	YB_ATTR_nodiscard const std::regex&
+	Get(const string&);
+
+	//! \note 移除超出容量的项。
+	void
+	SetCapacity(size_t);
+
+	//! \note 不影响统计。
+	PDefH(void, clear, ) ynothrow
+		ImplExpr(cache.clear())
+};
+
+/*!
+\brief 向量类型。
+\sa LoadModule_std_vectors
+\since build 955
+
+元素为项节点的连续存储的向量，作为 NPLA1 对象语言的向量类型的值的宿主类型。
+*/
+using TermVector = vector<TermNode>;
+
+/*!
+\brief 字节向量类型。
+\sa LoadModule_std_vectors
+\since build 955
+
+元素为字节的连续存储的向量，作为 NPLA1 对象语言的字节向量类型的值的宿主类型。
+*/
+using ByteVector = vector<byte>;
+
+/*!
+\brief 散列表：作为 NPLA1 对象语言的散列表类型的值的宿主类型。
+\warning 非虚析构。
+\sa LoadModule_std_hashtables
+\since build 955
+
+以插入顺序保存键和值的关联容器，使用开放寻址的散列索引查找。
+键的等价关系由构造时指定的比较方式决定，和对应的 NPLA1 比较操作的结果一致。
+插入元素不使迭代器和元素的引用失效。移除元素只使被移除的元素的迭代器和引用失效。
+*/
+class YF_API HashTable final
+{
+public:
+	//! \brief 键的比较方式：分别和 eq? 、eqv? 与 equal? 的结果一致。
+	enum class Comparison : yimpl(size_t)
+	{
+		Eq,
+		Eqv,
+		Equal
+	};
+
+	//! \brief 元素：保存键、值和键的散列值。
+	struct Entry final
+	{
+		TermNode Key;
+		TermNode Value;
+		//! \brief 散列值：值 0 保留表示索引中的空槽。
+		size_t Hash = 0;
+
+		Entry(TermNode&& k, TermNode&& v)
+			: Key(std::move(k)), Value(std::move(v))
+		{}
+	};
+
+private:
+	using container_type = YSLib::list<Entry>;
+
+public:
+	using value_type = Entry;
+	using allocator_type = container_type::allocator_type;
+	using size_type = container_type::size_type;
+	using iterator = container_type::iterator;
+	using const_iterator = container_type::const_iterator;
+
+	//! \brief 最小的索引大小。
+	static yconstexpr const size_t MinIndexSize = yimpl(8);
+
+private:
+	//! \brief 索引槽：散列值为 0 表示空槽。
+	struct Slot final
+	{
+		size_t Hash;
+		iterator Position;
+	};
+
+	Comparison comparison;
+	container_type container;
+	//! \invariant 大小是 2 的幂，且至少为元素数的 2 倍。
+	vector<Slot> index;
+
+public:
+	explicit
+	HashTable(Comparison cmp = Comparison::Equal,
+		allocator_type a = allocator_type())
+		: HashTable(cmp, 0, a)
+	{}
+	//! \note 第二参数指定预期的元素数。
+	HashTable(Comparison, size_type, allocator_type = allocator_type());
+	HashTable(const HashTable& tbl)
+		: HashTable(tbl, tbl.get_allocator())
+	{}
+	HashTable(const HashTable&, allocator_type);
+	DefDeMoveCtor(HashTable)
+
+	PDefHOp(HashTable&, =, const HashTable& tbl)
+		ImplRet(ystdex::copy_and_swap(*this, tbl))
+	HashTable&
+	operator=(HashTable&&);
+
+	YB_ATTR_nodiscard
+		PDefH(allocator_type, get_allocator, ) const ynothrow
+		ImplRet(container.get_allocator())
+
+	YB_ATTR_nodiscard PDefH(iterator, begin, ) ynothrow
+		ImplRet(container.begin())
+	YB_ATTR_nodiscard PDefH(const_iterator, begin, ) const ynothrow
+		ImplRet(container.begin())
+
+	YB_ATTR_nodiscard PDefH(bool, empty, ) const ynothrow
+		ImplRet(container.empty())
+
+	YB_ATTR_nodiscard PDefH(iterator, end, ) ynothrow
+		ImplRet(container.end())
+	YB_ATTR_nodiscard PDefH(const_iterator, end, ) const ynothrow
+		ImplRet(container.end())
+
+	DefGetter(const ynothrow, Comparison, Comparison, comparison)
+
+	YB_ATTR_nodiscard PDefH(size_type, size, ) const ynothrow
+		ImplRet(container.size())
+
+	void
+	clear() ynothrow;
+
+	iterator
+	erase(const_iterator) ynothrowv;
+	//! \return 移除的元素数。
+	size_type
+	erase(const TermNode&);
+
+	YB_ATTR_nodiscard YB_PURE iterator
+	find(const TermNode&);
+	YB_ATTR_nodiscard YB_PURE const_iterator
+	find(const TermNode&) const;
+
+	/*!
+	\brief 插入或替换元素。
+	\return 插入或被替换值的元素的位置，以及是否插入了新的元素。
+	\note 键和值被转移，不进行其它提升或转换。
+
+	若存在等价的键，替换对应的值；否则，插入新的元素。
+	*/
+	pair<iterator, bool>
+	insert_or_assign(TermNode&&, TermNode&&);
+
+	//! \brief 预留至少可保存参数指定数量元素的索引。
+	void
+	reserve(size_type);
+
+private:
+	//! \brief 计算和比较方式一致的键的散列值。
+	YB_ATTR_nodiscard YB_PURE size_t
+	HashKey(const TermNode&) const;
+
+	//! \brief 以比较方式判断键等价。
+	YB_ATTR_nodiscard YB_PURE bool
+	KeyEquals(const TermNode&, const TermNode&) const;
+
+	//! \brief 重新建立至少指定大小的散列索引。
+	void
+	Reindex(size_t);
+
+public:
+	friend PDefH(void, swap, HashTable& x, HashTable& y) ynothrow
+		ImplExpr(std::swap(x.comparison, y.comparison),
+			x.container.swap(y.container), x.index.swap(y.index))
+};
+
+
 /*!
 \brief 打开指定路径的文件作为 NPL 输入流。
 \throw 嵌套异常：文件打开失败。
@@ -85,6 +364,30 @@ OpenFile(const char*);
 YB_ATTR_nodiscard YF_API YSLib::unique_ptr<std::istream>
 OpenUnique(ContextState&, string);
 
+//! \brief 翻译单元映像文件名后缀。
+yconstexpr const char UnitImageSuffix[]{".a1i"};
+
+/*!
+\brief 使用翻译单元映像缓存加载外部翻译单元。
+\exception 异常中立：由 GlobalState::DefaultLoad 抛出。
+\sa GlobalState::DefaultLoad
+\sa GlobalState::Load
+\sa OpenUnique
+\sa UnitImageSuffix
+
+可作为 GlobalState::Load 的值，加载参数指定的文件名的源代码。
+翻译单元映像保存源代码的语法分析结果中的节点结构和叶节点词素，
+	路径为源代码文件名后添加 UnitImageSuffix 。
+映像以源代码文件的大小和修改时间、映像格式的版本及是否使用源代码位置作为键。
+映像有效时，映射映像文件并从中直接构造节点，代替读取和分析源代码；
+	否则，分析源代码并尝试更新映像，忽略写入映像的错误。
+叶节点词素以 GlobalState::LeafConverter 转换，因此映像不依赖转换器。
+不能映射源代码时，调用 GlobalState::DefaultLoad 。
+同 GlobalState::DefaultLoad ，加载时在上下文设置源代码名称。
+*/
+YB_ATTR_nodiscard YF_API TermNode
+LoadWithUnitImage(ContextState&, string);
+
 
 /*!
 \brief 在 REPL 上下文中加载指定名称的外部翻译单元。
@@ -170,12 +473,52 @@ LoadModule_std_math(ContextState&);
 
 /*!
 \brief 加载字符串模块。
+\sa RegexCache
+\sa StringBuilder
 
-加载字符串库操作。
+加载字符串库操作，包括字符串构建器类型及相关操作。
+若上下文的全局状态中不存在正则表达式缓存，初始化缓存。
 */
 YF_API void
 LoadModule_std_strings(ContextState&);
 
+/*!
+\brief 加载向量模块。
+\sa ByteVector
+\sa TermVector
+\since build 955
+
+加载向量和字节向量类型及相关操作。
+向量和字节向量对象使用规约时的项的分配器分配存储。
+*/
+YF_API void
+LoadModule_std_vectors(ContextState&);
+
+/*!
+\brief 加载散列表模块。
+\sa HashTable
+\since build 955
+
+加载散列表类型及相关操作。
+散列表对象使用规约时的项的分配器分配存储。
+*/
+YF_API void
+LoadModule_std_hashtables(ContextState&);
+
+#if YF_Multithread == 1
+/*!
+\brief 加载线程模块。
+\sa LoadStandardContext
+\since build 955
+
+加载在线程池中并行求值的操作和通道类型。
+每个工作线程具有独立的上下文状态，初始化时加载标准上下文，并导入标准库模块中的绑定。
+线程之间只传递值的副本，不共享环境。
+*/
+YF_API void
+LoadModule_std_threads(ContextState&);
+#endif
+
 /*!
 \pre 当前派生实现：已加载和初始化依赖的模块，在当前环境可访问的指定的模块名称。
 \exception NPLException 违反加载模块的前置条件而无法成功初始化。
@@ -234,12 +577,15 @@ LoadModule_SHBuild(ContextState&);
 /*!
 \brief 加载 NPLA1 基础上下文和标准模块。
 \sa LoadGroundContext
+\sa LoadModule_std_hashtables
 \sa LoadModule_std_io
 \sa LoadModule_std_math
 \sa LoadModule_std_modules
 \sa LoadModule_std_promises
 \sa LoadModule_std_strings
 \sa LoadModule_std_system
+\sa LoadModule_std_threads
+\sa LoadModule_std_vectors
 \since build 955
 
 调用 LoadGroundContext 并加载标准库模块。
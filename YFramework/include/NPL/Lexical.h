@@ -11,13 +11,13 @@
 /*!	\file Lexical.h
 \ingroup NPL
 \brief NPL 词法处理。
-\version r2369
+\version r2372
 \author FrankHB <frankhb1989@gmail.com>
 \since build 335
 \par 创建时间:
 	2012-08-03 23:04:28 +0800
 \par 修改时间:
-	2021-12-21 21:27 +0800
+	2026-10-17 13:51 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -363,6 +363,31 @@ YB_ATTR_nodiscard YF_API YB_PURE string
 EscapeLiteral(string_view);
 //@}
 
+/*!
+\brief 附加编码转义的字符串。
+\since build 955
+*/
+//@{
+/*!
+\note 附加的内容和 Escape 的结果相同。
+\sa Escape
+*/
+YF_API void
+AppendEscaped(string&, string_view);
+
+/*!
+\note 若第三参数是空字符，附加的内容和 EscapeLiteral 的结果相同；
+	否则，和以第三参数调用 Literalize 字面量化 EscapeLiteral 的结果相同。
+\sa EscapeLiteral
+\sa Literalize
+
+编码转义字符串字面量并附加到第一参数。
+不创建中间结果的字符串。
+*/
+YF_API void
+AppendEscapedLiteral(string&, string_view, char = char());
+//@}
+
 /*!
 \brief 编码 XML 字符串。
 \see http://www.w3.org/TR/2006/REC-xml11-20060816/#charsets 。
@@ -396,6 +421,25 @@ YB_ATTR_nodiscard YB_PURE inline PDefH(bool, IsDelimiter, char c) ynothrow
 	ImplRet(ystdex::isspace(c) || IsGraphicalDelimiter(c))
 //@}
 
+/*!
+\brief 取字节序列中的普通字符构成的前缀的长度。
+\pre 断言：指针参数非空且指定有效的范围。
+\sa LexicalAnalyzer
+\since build 955
+
+第三参数指定字面分隔符状态，同 LexicalAnalyzer::GetDelimiter 的结果。
+第四参数指定是否以分隔符(IsDelimiter) 划分词素。
+普通字符是除反斜杠以外的以下字符：
+当字面分隔符状态为空字符时，除引号、被 LexicalAnalyzer::UpdateBack 替换为空格的字符
+	和第四参数为 true 时的分隔符以外的字符；
+否则，除字面分隔符以外的字符。
+不处理转义序列时，逐字节解析普通字符只向缓冲区添加字符，而不改变分析器的状态，
+	因此解析器可成块地处理普通字符。
+若实现支持，使用 SIMD 指令一次检查多个字节。
+*/
+YB_ATTR_nodiscard YF_API YB_PURE size_t
+ScanOrdinaryBytes(const char*, const char*, char, bool = true) ynothrowv;
+
 
 /*!
 \brief 分解字符串为记号。
@@ -571,6 +615,18 @@ public:
 			&& lexer.UpdateBack(GetBackRef(), c));
 	}
 
+	/*!
+	\brief 解析字节序列并更新字符解析结果。
+	\pre 断言：指针参数非空且指定有效的范围。
+	\note 使用默认的反转义算法，结果和逐字节解析相同。
+	\sa ScanOrdinaryBytes
+	\since build 955
+
+	成块地处理普通字符，其它字符逐字节解析。
+	*/
+	void
+	operator()(const char*, const char*);
+
 	//! \since build 899
 	DefPred(const ynothrow, Updating, update_current)
 
@@ -656,6 +712,16 @@ public:
 			source_location.Newline();
 	}
 
+	/*!
+	\brief 解析字节序列并更新字符解析结果。
+	\pre 断言：指针参数非空且指定有效的范围。
+	\note 使用默认的反转义算法，结果和逐字节解析相同。
+	\sa ScanOrdinaryBytes
+	\since build 955
+	*/
+	void
+	operator()(const char*, const char*);
+
 	//! \since build 899
 	DefPred(const ynothrow, Updating, update_current)
 
@@ -681,6 +747,110 @@ public:
 };
 
 
+/*!
+\ingroup LexicalParsers
+\brief 视图字节解析器：解析结果引用输入的字节序列的字节解析器。
+\warning 解析结果引用输入和解析器保存的字符串，使用时需保证这些对象的生存期。
+\sa ByteParser
+\since build 955
+
+处理逻辑和 ByteParser 一致的解析器，但只支持成块地解析字节序列。
+解析结果中的词素在内容和输入中的子序列相同时直接引用输入，不复制字节序列；
+	否则，词素被反转义算法改变，其内容被保存在解析器中。
+多次调用成块解析的输入应为相同序列中的相邻的子序列，否则跨越不同输入的词素被保存。
+*/
+class YF_API ViewByteParser : private BufferedByteParserBase
+{
+public:
+	using ParseResult = vector<string_view>;
+
+private:
+	//! \invariant <tt>!(lexemes.empty() && update_current)</tt> 。
+	//@{
+	mutable ParseResult lexemes{};
+	bool update_current = {};
+	//@}
+	//! \brief 内容被改变的词素。
+	list<string> materialized;
+	//! \brief 最后的词素是否被保存在 materialized 中。
+	bool current_materialized = {};
+
+public:
+	ViewByteParser(LexicalAnalyzer& lexer,
+		pmr::polymorphic_allocator<yimpl(byte)> a = {})
+		: BufferedByteParserBase(lexer, a), lexemes(a), materialized(a)
+	{}
+	//! \note 解析结果可能引用被保存的词素，因此不可复制。
+	DefDelCopyCtor(ViewByteParser)
+	DefDeMoveCtor(ViewByteParser)
+
+	DefDelCopyAssignment(ViewByteParser)
+
+	/*!
+	\brief 解析字节序列并更新字符解析结果。
+	\pre 断言：指针参数非空且指定有效的范围。
+	\note 使用默认的反转义算法，结果和 ByteParser 逐字节解析的内容相同。
+	\sa ScanOrdinaryBytes
+	*/
+	void
+	operator()(const char*, const char*);
+
+	DefPred(const ynothrow, Updating, update_current)
+
+	using BufferedByteParserBase::GetBuffer;
+	using BufferedByteParserBase::GetLexerRef;
+	DefGetter(const ynothrow, const ParseResult&, Result, lexemes)
+};
+
+
+/*!
+\ingroup LexicalParsers
+\brief 记录源代码位置的视图字节解析器。
+\warning 解析结果引用输入和解析器保存的字符串，使用时需保证这些对象的生存期。
+\sa SourcedByteParser
+\sa ViewByteParser
+\since build 955
+
+处理逻辑和 ViewByteParser 一致的解析器，但解析结果保存元素在源代码位置。
+*/
+class YF_API SourcedViewByteParser : private BufferedByteParserBase
+{
+public:
+	using ParseResult = vector<pair<SourceLocation, string_view>>;
+
+private:
+	//! \invariant <tt>!(lexemes.empty() && update_current)</tt> 。
+	//@{
+	mutable ParseResult lexemes{};
+	bool update_current = {};
+	//@}
+	SourceLocation source_location{0, 0};
+	list<string> materialized;
+	bool current_materialized = {};
+
+public:
+	SourcedViewByteParser(LexicalAnalyzer& lexer,
+		pmr::polymorphic_allocator<yimpl(byte)> a = {})
+		: BufferedByteParserBase(lexer, a), lexemes(a), materialized(a)
+	{}
+	DefDelCopyCtor(SourcedViewByteParser)
+	DefDeMoveCtor(SourcedViewByteParser)
+
+	DefDelCopyAssignment(SourcedViewByteParser)
+
+	void
+	operator()(const char*, const char*);
+
+	DefPred(const ynothrow, Updating, update_current)
+
+	using BufferedByteParserBase::GetBuffer;
+	using BufferedByteParserBase::GetLexerRef;
+	DefGetter(const ynothrow, const ParseResult&, Result, lexemes)
+	DefGetter(const ynothrow, const SourceLocation&, SourceLocation,
+		source_location)
+};
+
+
 /*!
 \ingroup LexicalParsers
 \brief 保存分隔符中间结果字节解析器。
@@ -731,6 +901,15 @@ public:
 				qlist.push_back(QueryLastDelimited(lexer.GetDelimiter()));
 		}
 	}
+	/*!
+	\brief 解析字节序列并添加至字符解析结果。
+	\pre 断言：指针参数非空且指定有效的范围。
+	\note 使用默认的反转义算法，结果和逐字节解析相同。
+	\sa ScanOrdinaryBytes
+	\since build 955
+	*/
+	void
+	operator()(const char*, const char*);
 
 	using BufferedByteParserBase::GetBuffer;
 	using BufferedByteParserBase::GetBufferRef;
@@ -11,13 +11,13 @@
 /*!	\file NPLA.h
 \ingroup NPL
 \brief NPLA 公共接口。
-\version r9807
+\version r9817
 \author FrankHB <frankhb1989@gmail.com>
 \since build 663
 \par 创建时间:
 	2016-01-07 10:32:34 +0800
 \par 修改时间:
-	2022-09-05 08:44 +0800
+	2026-10-17 17:36 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -41,8 +41,8 @@
 //	ystdex::get_equal_to, NPL::IsMovable, pair, std::declval,
 //	ystdex::invoke_value_or, ystdex::expand_proxy, Access, ystdex::ref_eq,
 //	ValueObject, NPL::SetContentWith, std::for_each, TNIter, AccessFirstSubterm,
-//	AssertBranch, NPL::Deref, YSLib::EmplaceCallResult, ystdex::less,
-//	YSLib::map, pmr, ystdex::copy_and_swap, NoContainer, ystdex::try_emplace,
+//	AssertBranch, NPL::Deref, YSLib::EmplaceCallResult, YSLib::list,
+//	std::hash, pmr, ystdex::copy_and_swap, NoContainer, ystdex::try_emplace,
 //	ystdex::try_emplace_hint, ystdex::insert_or_assign, type_info,
 //	ystdex::expanded_function, ystdex::enable_if_same_param_t,
 //	ystdex::exclude_self_t, ystdex::make_obj_using_allocator,
@@ -178,6 +178,8 @@ PrintContainedNodes(_func print_bound, _fCallable f)
 \sa PrintNodeString
 \sa TraverseNodeChildAndPrint
 
+若第三参数和第四参数分别是 EscapeNodeLiteral 或 LiteralizeEscapeNodeLiteral
+	和 DefaultGenerateIndent ，使用 NodePrinter 打印；否则，
 调用第四参数输出最后一个参数决定的缩进作为前缀和一个空格，然后打印节点内容：
 先尝试调用 PrintNodeString 打印节点字符串，若成功直接返回；
 否则打印换行，并调用 PrintContainedNodes 逐个打印子节点内容。
@@ -206,6 +208,67 @@ PrintNodeString(std::ostream&, const ValueNode&,
 //@}
 //@}
 
+/*!
+\brief 缓冲的 NPLA 节点打印器。
+\sa PrintNode
+\since build 955
+
+以和 PrintNode 相同的格式打印节点。
+节点字符串的转换同 EscapeNodeLiteral 或 LiteralizeEscapeNodeLiteral ，
+	使用 AppendEscapedLiteral 直接写入缓冲区，不创建每个节点的中间字符串；
+	缩进同 DefaultGenerateIndent 的结果，从预先生成的缩进表中复制。
+缓冲区的大小不小于阈值时，其内容被写入输出流。析构时写入剩余的内容。
+*/
+class YF_API NodePrinter final
+{
+public:
+	//! \brief 默认的缓冲区写入阈值。
+	static yconstexpr const size_t DefaultThreshold = yimpl(16384);
+
+	std::ostream& Stream;
+	//! \brief 是否字面量化节点字符串。
+	bool LiteralizeString;
+	//! \brief 缓冲区写入阈值。
+	size_t Threshold = DefaultThreshold;
+
+private:
+	string buffer;
+
+public:
+	NodePrinter(std::ostream&, bool = {});
+	//! \note 缓冲区引用输出流，因此不可复制和转移。
+	DefDelCopyCtor(NodePrinter)
+	DefDelCopyAssignment(NodePrinter)
+	/*!
+	\brief 析构：写入缓冲区的剩余内容，忽略异常。
+	\note 需要处理写入的错误时，应在析构前调用 Flush 。
+	*/
+	~NodePrinter();
+
+	/*!
+	\brief 打印节点到缓冲区。
+	\note 第二参数指定缩进的层数。
+	*/
+	void
+	operator()(const ValueNode&, size_t = 0);
+
+	DefGetter(const ynothrow, const string&, Buffer, buffer)
+
+	/*!
+	\brief 写入缓冲区的内容到输出流并清空缓冲区。
+	\note 写入失败时也清空缓冲区。
+	*/
+	void
+	Flush();
+
+private:
+	void
+	PrintIndent(size_t);
+
+	bool
+	PrintString(const ValueNode&);
+};
+
 
 /*!
 \brief 解析 NPLA 项节点字符串。
@@ -439,6 +502,16 @@ static_assert(ystdex::is_nothrow_move_constructible<AnchorPtr>(),
 	"Invalid type found.");
 //@}
 
+/*!
+\brief 判断锚对象是否被冻结。
+\sa Environment::Freeze
+\since build 955
+
+空锚对象指针视为未被冻结。
+*/
+YB_ATTR_nodiscard YF_API YB_PURE bool
+IsFrozenAnchor(const AnchorPtr&) ynothrow;
+
 
 /*!
 \brief 清除参数中作为规约合并项而非一等对象的表示的标签。
@@ -887,13 +960,15 @@ public:
 
 	/*!
 	\brief 判断被引用的对象是否可通过引用被修改。
+	\sa GetTags
 	\since build 856
 	*/
-	DefPred(const ynothrow, Modifiable, !bool(tags & TermTags::Nonmodifying))
+	DefPred(const ynothrow, Modifiable,
+		!bool(GetTags() & TermTags::Nonmodifying))
 	//! \since build 857
 	//@{
 	//! \brief 判断被引用的对象是否可通过引用值被转移。
-	DefPred(const ynothrow, Movable, NPL::IsMovable(tags))
+	DefPred(const ynothrow, Movable, NPL::IsMovable(GetTags()))
 	/*!
 	\brief 判断引用值是否表示被引用的被绑定对象左值。
 
@@ -946,7 +1021,17 @@ public:
 	*/
 	DefGetter(const ynothrow, const EnvironmentReference&, EnvironmentReference,
 		r_env)
-	DefGetter(const ynothrow, TermTags, Tags, tags)
+	/*!
+	\brief 取标签。
+	\note 若关联的环境的锚对象被冻结，结果包含 TermTags::Nonmodifying 。
+	\sa IsFrozenAnchor
+	\since build 955
+
+	关联的环境被冻结后，即使引用在冻结前被创建，也不能修改被引用的对象。
+	*/
+	PDefH(TermTags, GetTags, ) const ynothrow
+		ImplRet(IsFrozenAnchor(r_env.GetAnchorPtr())
+			? tags | TermTags::Nonmodifying : tags)
 
 	//! \since build 873
 	DefSetter(ynothrow, TermNode&, Referent, term_ref)
@@ -2117,6 +2202,265 @@ EmplaceCallResultOrReturn(TermNode& term, array<ValueObject, _vN> arg)
 
 //! \warning 非虚析构。
 //@{
+/*!
+\brief 绑定映射：保存名称和被绑定对象的关联容器。
+\warning 非虚析构。
+\since build 955
+
+以插入顺序保存元素的散列映射，接口和 YSLib::unordered_map 类似。
+插入元素不使迭代器和元素的引用失效。移除元素只使被移除的元素的迭代器和引用失效。
+使用可转换为 string_view 的透明键查找。
+元素数不超过 IndexThreshold 时线性查找；否则使用开放寻址的散列索引查找。
+映射可具有共享的基础映射，其中的元素视为映射的元素。
+基础映射中的元素在第一次被查找时复制到映射的容器中，之后的访问和修改不影响基础映射。
+复制映射时只复制已在容器中的元素并共享基础映射。
+遍历或移除元素前，复制基础映射中剩余的元素并释放基础映射；
+	此时元素的顺序是基础映射中的顺序，之后是其它被插入的元素的顺序。
+复制基础映射中的元素不改变修订号，也不使迭代器和元素的引用失效。
+*/
+class YF_API BindingMap final
+{
+public:
+	using key_type = string;
+	using mapped_type = TermNode;
+	using value_type = pair<const string, TermNode>;
+
+private:
+	using container_type = YSLib::list<value_type>;
+
+public:
+	using allocator_type = container_type::allocator_type;
+	using size_type = container_type::size_type;
+	using difference_type = container_type::difference_type;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using iterator = container_type::iterator;
+	using const_iterator = container_type::const_iterator;
+	using hasher = std::hash<string_view>;
+
+	//! \brief 使用散列索引的最小元素数。
+	static yconstexpr const size_t IndexThreshold = yimpl(8);
+
+private:
+	//! \brief 索引槽：散列值为 0 表示空槽。
+	struct Slot final
+	{
+		size_t Hash;
+		iterator Position;
+	};
+
+	container_type container;
+	//! \invariant 若非空，大小是 2 的幂，且至少为元素数的 2 倍。
+	vector<Slot> index;
+	//! \brief 修订号：插入或移除元素时改变。
+	size_t revision = 0;
+	/*!
+	\brief 基础映射。
+	\invariant 若非空，不具有基础映射。
+	*/
+	shared_ptr<const BindingMap> p_base{};
+	//! \brief 已从基础映射复制到容器中的元素数。
+	size_t copied = 0;
+
+public:
+	BindingMap()
+		: BindingMap(allocator_type())
+	{}
+	explicit
+	BindingMap(allocator_type a)
+		: container(a), index(a)
+	{}
+	/*!
+	\brief 构造：使用基础映射。
+	\pre 断言：参数非空且不具有基础映射。
+	*/
+	BindingMap(shared_ptr<const BindingMap> p, allocator_type a)
+		: container(a), index(a), p_base(std::move(p))
+	{
+		YAssert(p_base && !p_base->p_base, "Invalid base map found.");
+	}
+	BindingMap(const BindingMap& m)
+		: container(m.container), index(container.get_allocator()),
+		p_base(m.p_base), copied(m.copied)
+	{
+		Reindex();
+	}
+	BindingMap(const BindingMap& m, allocator_type a)
+		: container(m.container, a), index(a), p_base(m.p_base),
+		copied(m.copied)
+	{
+		Reindex();
+	}
+	BindingMap(BindingMap&& m) ynothrow
+		: container(std::move(m.container)), index(std::move(m.index)),
+		revision(m.revision), p_base(std::move(m.p_base)),
+		copied(ystdex::exchange(m.copied, size_t()))
+	{
+		++m.revision;
+	}
+
+	PDefHOp(BindingMap&, =, const BindingMap& m)
+		ImplRet(ystdex::copy_and_swap(*this, m))
+	BindingMap&
+	operator=(BindingMap&&);
+
+	YB_ATTR_nodiscard
+		PDefH(allocator_type, get_allocator, ) const ynothrow
+		ImplRet(container.get_allocator())
+
+	//! \note 复制基础映射中剩余的元素。
+	//@{
+	YB_ATTR_nodiscard PDefH(iterator, begin, )
+		ImplRet(Materialize(), container.begin())
+	YB_ATTR_nodiscard PDefH(const_iterator, begin, ) const
+		ImplRet(Materialize(), container.begin())
+
+	YB_ATTR_nodiscard PDefH(const_iterator, cbegin, ) const
+		ImplRet(Materialize(), container.cbegin())
+	//@}
+
+	YB_ATTR_nodiscard PDefH(const_iterator, cend, ) const ynothrow
+		ImplRet(container.cend())
+
+	YB_ATTR_nodiscard PDefH(bool, empty, ) const ynothrow
+		ImplRet(size() == 0)
+
+	YB_ATTR_nodiscard PDefH(iterator, end, ) ynothrow
+		ImplRet(container.end())
+	YB_ATTR_nodiscard PDefH(const_iterator, end, ) const ynothrow
+		ImplRet(container.end())
+
+	//! \brief 取基础映射。
+	DefGetter(const ynothrow, const shared_ptr<const BindingMap>&, BasePtr,
+		p_base)
+	//! \brief 取修订号：在对象生存期内，元素的集合改变时修订号不同。
+	DefGetter(const ynothrow, size_t, Revision, revision)
+
+	YB_ATTR_nodiscard PDefH(size_type, size, ) const ynothrow
+		ImplRet(container.size() + (p_base ? p_base->size() - copied : 0))
+
+	void
+	clear() ynothrow;
+
+	//! \note 键在元素被构造后比较。
+	template<typename... _tParams>
+	pair<iterator, bool>
+	emplace(_tParams&&... args)
+	{
+		container.emplace_back(yforward(args)...);
+		return Insert(std::prev(container.end()));
+	}
+	//! \note 键在元素被构造前比较，不存在时构造元素。
+	template<typename _tKey, typename... _tParams>
+	pair<iterator, bool>
+	emplace(std::piecewise_construct_t, std::tuple<_tKey> k,
+		std::tuple<_tParams...> args)
+	{
+		const string_view id(std::get<0>(k));
+		const auto i(find(id));
+
+		if(i == container.end())
+		{
+			container.emplace_back(std::piecewise_construct, std::move(k),
+				std::move(args));
+			return Insert(std::prev(container.end()));
+		}
+		return {i, false};
+	}
+
+	//! \note 复制基础映射中剩余的元素。
+	//@{
+	iterator
+	erase(const_iterator);
+	iterator
+	erase(const_iterator, const_iterator);
+	//! \return 移除的元素数。
+	size_type
+	erase(string_view);
+	//@}
+
+	/*!
+	\pre 断言：参数的数据指针非空。
+	\note 若元素仅在基础映射中，复制这个元素。
+	*/
+	//@{
+	YB_ATTR_nodiscard iterator
+	find(string_view);
+	YB_ATTR_nodiscard const_iterator
+	find(string_view) const;
+	//@}
+
+	/*!
+	\brief 以容器中的元素调用参数。
+	\note 不访问基础映射中未被复制的元素。
+	*/
+	template<typename _func>
+	void
+	ForEachLocal(_func f) const
+	{
+		for(const auto& pr : container)
+			f(pr);
+	}
+
+	/*!
+	\brief 复制为可作为基础映射的共享映射。
+	\note 使用映射的分配器。
+	*/
+	YB_ATTR_nodiscard shared_ptr<const BindingMap>
+	Share() const;
+
+private:
+	//! \brief 复制基础映射中的元素到容器的末尾并索引。
+	iterator
+	CopyBase(const_reference, size_t);
+
+	//! \brief 在容器中查找指定键和散列值的元素。
+	YB_ATTR_nodiscard YB_PURE iterator
+	FindLocal(string_view, size_t) ynothrowv;
+
+	/*!
+	\brief 索引容器中的最后的元素。
+	\note 若失败，移除这个元素。
+	*/
+	void
+	IndexLast(iterator, size_t);
+
+	/*!
+	\brief 插入索引：索引指定位置的元素。
+	\pre 间接断言：参数是最后的元素。
+	\note 若已存在相同键的元素，移除参数指定的元素并返回已存在的元素的位置。
+	*/
+	pair<iterator, bool>
+	Insert(iterator);
+
+	//! \brief 构造可保存指定元素数的空的散列索引。
+	YB_ATTR_nodiscard vector<Slot>
+	MakeIndex(size_t) const;
+
+	//! \brief 以容器中的元素填充空的散列索引。
+	void
+	FillIndex(vector<Slot>&) ynothrow;
+
+	/*!
+	\brief 复制基础映射中剩余的元素并释放基础映射。
+	\note 逻辑上不修改映射中的元素。
+	\note 强异常安全保证。
+	*/
+	void
+	Materialize() const;
+
+	//! \brief 重新建立散列索引。
+	void
+	Reindex();
+
+public:
+	friend PDefH(void, swap, BindingMap& x, BindingMap& y) ynothrow
+		ImplExpr(x.container.swap(y.container), x.index.swap(y.index),
+			x.p_base.swap(y.p_base), std::swap(x.copied, y.copied),
+			++x.revision, ++y.revision)
+};
+
+
 /*!
 \brief 环境列表。
 \since build 798
@@ -2136,7 +2480,7 @@ class YF_API Environment : private ystdex::equality_comparable<Environment>
 {
 public:
 	//! \since build 788
-	using BindingMap = YSLib::map<string, TermNode, ystdex::less<>>;
+	using BindingMap = NPL::BindingMap;
 	/*!
 	\brief 名称解析结果。
 	\since build 821
@@ -2169,6 +2513,7 @@ public:
 	ValueObject Parent{};
 	/*!
 	\brief 冻结状态。
+	\sa Freeze
 	\sa MakeTermTags
 	\since build 871
 	*/
@@ -2180,6 +2525,17 @@ private:
 	\since build 869
 	*/
 	AnchorPtr p_anchor{InitAnchor()};
+	/*!
+	\brief 共享的绑定映射。
+	\sa ShareBindings
+	\since build 955
+	*/
+	mutable shared_ptr<const BindingMap> p_shared{};
+	/*!
+	\brief 共享的绑定映射被创建时的绑定映射的修订号。
+	\since build 955
+	*/
+	mutable size_t shared_revision = 0;
 
 public:
 	//! \since build 845
@@ -2319,8 +2675,7 @@ public:
 	TermNode&
 	Bind(_tKey&& k, _tNode&& tm)
 	{
-		// XXX: %YSLib::map::insert_or_assign does not allows keys not of
-		//	%BindingMap::key_type to be directly forwarded.
+		// XXX: %BindingMap does not provide %insert_or_assign.
 		return NPL::Deref(ystdex::insert_or_assign(Bindings, yforward(k),
 			yforward(tm)).first).second;
 	}
@@ -2342,6 +2697,7 @@ public:
 	/*!
 	\brief 移除第一参数中名称和第二参数中重复的绑定项。
 	\return 移除后的目的结果中没有绑定。
+	\note 遍历元素数较少的绑定映射。
 	\since build 825
 	*/
 	static bool
@@ -2387,6 +2743,18 @@ private:
 	InitAnchor() const;
 
 public:
+	/*!
+	\brief 冻结环境。
+	\post \c Frozen 。
+	\sa IsFrozenAnchor
+	\since build 955
+
+	设置冻结状态并冻结锚对象。
+	此后，包括冻结前创建的引用值在内，关联此环境的引用值不能修改被引用的对象。
+	*/
+	void
+	Freeze() ynothrow;
+
 	/*!
 	\brief 查找名称。
 	\return 查找到的名称，或查找失败时的空值。
@@ -2406,6 +2774,24 @@ public:
 		PDefH(TermTags, MakeTermTags, const TermNode& term) const ynothrow
 		ImplRet(Frozen ? term.Tags | TermTags::Nonmodifying : term.Tags)
 
+	/*!
+	\brief 取共享的绑定映射：可作为基础映射的绑定映射的副本。
+	\pre 若环境被冻结，不通过对象语言中的引用值以外的方式修改被绑定的对象。
+	\sa BindingMap::Share
+	\sa Freeze
+	\since build 955
+
+	若环境被冻结，在绑定映射的元素的集合未改变时复用之前创建的副本；
+		因此，复制冻结的环境的绑定的平摊开销和元素数无关。
+	冻结的环境中的被绑定对象不能通过引用值修改（包括冻结前取得的引用值），
+		因此复用的副本不会和被绑定对象不一致。
+	共享的绑定映射不被修改，可被不同的上下文同时作为基础映射。
+	被绑定的对象可能具有非线程安全的状态，共享的绑定映射不应在不同的线程中访问；
+		不同线程的上下文之间只传递值的副本，不共享环境。
+	*/
+	YB_ATTR_nodiscard shared_ptr<const BindingMap>
+	ShareBindings() const;
+
 	/*!
 	\pre 断言：第一参数的数据指针非空。
 	\warning 应避免对被替换或移除的值的悬空引用。
@@ -2468,7 +2854,8 @@ public:
 	*/
 	friend PDefH(void, swap, Environment& x, Environment& y) ynothrow
 		ImplExpr(swap(x.Bindings, y.Bindings), swap(x.Parent, y.Parent),
-			swap(x.p_anchor, y.p_anchor))
+			swap(x.p_anchor, y.p_anchor), swap(x.p_shared, y.p_shared),
+			std::swap(x.shared_revision, y.shared_revision))
 };
 
 inline
@@ -2478,6 +2865,115 @@ EnvironmentReference::EnvironmentReference(const shared_ptr<Environment>& p_env)
 {}
 
 
+/*!
+\brief 环境回收器：回收仅被环境之间的循环引用保持的环境。
+\warning 非线程安全。
+\sa AllocateEnvironment
+\since build 955
+
+回收器被激活时，当前线程中由 Track 分配的环境被追踪。
+回收使用试探删除：对每个被追踪的环境，统计被追踪的环境中的值持有的引用数，
+	和环境的强引用计数以及锚对象的引用计数比较。
+若存在没有被统计的引用，环境被视为被外部引用的根。
+从根通过被统计的引用不可达的环境被视为垃圾，其绑定和父环境被清除以断开循环引用。
+值中的引用以 shared_ptr<Environment> 、 EnvironmentReference 、 TermReference 、
+	EnvironmentList 和项的子项中的值识别；其它类型的值由 Trace 识别。
+只访问被唯一所有的值对象持有的对象；未被识别的引用使环境保守地被视为根而不被回收。
+因此，被回收的环境不能在之后通过回收前未被识别的引用访问。
+*/
+class YF_API EnvironmentCollector final
+{
+public:
+	/*!
+	\brief 追踪例程：识别值对象中的环境引用。
+	\return 是否识别值对象中的对象类型。
+
+	对识别的对象中的被唯一所有的值对象或项调用第二参数的 Visit 。
+	*/
+	using Tracer = function<bool(const ValueObject&, EnvironmentCollector&)>;
+	//! \brief 统计：回收次数、被回收的环境数和估计的被回收的字节数。
+	struct Statistics final
+	{
+		size_t Collections = 0;
+		size_t Environments = 0;
+		size_t Bytes = 0;
+	};
+
+	//! \brief 追踪例程：识别 NPLA 以外的类型。
+	Tracer Trace{};
+	/*!
+	\brief 阈值：自上次回收后追踪的环境数达到此值时回收。
+	\note 值为 0 时不自动回收。
+	*/
+	size_t Threshold = 0;
+
+private:
+	struct TraceState;
+
+	vector<weak_ptr<Environment>> tracked{};
+	//! \brief 上次修剪后的被追踪的环境数，用于平摊修剪的开销。
+	size_t last_size = 0;
+	//! \brief 上次回收后追踪的环境数。
+	size_t allocated = 0;
+	Statistics stats{};
+	//! \brief 回收中的追踪状态。
+	observer_ptr<TraceState> p_state{};
+
+public:
+	DefDeCtor(EnvironmentCollector)
+	DefDelCopyCtor(EnvironmentCollector)
+	//! \brief 析构：若被激活则取消激活。
+	~EnvironmentCollector();
+
+	DefDelCopyAssignment(EnvironmentCollector)
+
+	DefGetter(const ynothrow, const Statistics&, Statistics, stats)
+	//! \brief 取被追踪的环境数，包括已被销毁但未被修剪的环境。
+	DefGetter(const ynothrow, size_t, TrackedCount, tracked.size())
+
+	//! \brief 追踪参数指定的环境。
+	void
+	Add(const shared_ptr<Environment>&);
+
+	/*!
+	\brief 回收被追踪的环境中的循环引用。
+	\return 估计的被回收的字节数。
+	\note 重入时无作用而返回 0 。
+	*/
+	size_t
+	Collect();
+
+	/*!
+	\brief 取当前线程被激活的回收器。
+	\return 若不存在被激活的回收器，空指针。
+	*/
+	YB_ATTR_nodiscard YB_PURE static observer_ptr<EnvironmentCollector>
+	GetActive() ynothrow;
+
+	/*!
+	\brief 切换当前线程被激活的回收器。
+	\return 之前被激活的回收器。
+	*/
+	static observer_ptr<EnvironmentCollector>
+	SwitchActive(observer_ptr<EnvironmentCollector>) ynothrow;
+
+	//! \brief 使用当前线程被激活的回收器追踪参数指定的环境，并返回参数。
+	static shared_ptr<Environment>
+	Track(shared_ptr<Environment>);
+
+	/*!
+	\brief 访问被追踪的值中的引用。
+	\pre 在追踪例程中调用。
+	*/
+	//@{
+	void
+	Visit(const ValueObject&);
+	void
+	Visit(const TermNode&);
+	//@}
+};
+
+
 //! \since build 877
 class ContextNode;
 
@@ -2526,6 +3022,135 @@ ToReducer(const _tAlloc& a, _tParam&& arg, _tParams&&... args)
 //@}
 
 
+/*!
+\brief 名称解析缓存。
+\warning 非线程安全。
+\sa ContextNode::ResolveCached
+\since build 955
+
+在名称解析时按环境在重定向中的深度缓存名称查找的结果。
+缓存项以环境对象的所有者和绑定映射的修订号验证；环境被替换或其中的绑定改变时不命中。
+被缓存的结果包括查找失败的结果。
+因为不保存对象的所有权，缓存不改变环境的生存期。
+*/
+class YF_API NameResolutionCache final
+{
+public:
+	//! \brief 统计：缓存命中和未命中的次数。
+	struct Statistics final
+	{
+		size_t Hits = 0;
+		size_t Misses = 0;
+	};
+
+	//! \brief 缓存的最大深度。
+	static yconstexpr const size_t MaxDepth = yimpl(4);
+
+private:
+	struct Entry final
+	{
+		weak_ptr<Environment> Owner{};
+		size_t Revision = 0;
+		Environment::NameResolution::first_type Binding{};
+	};
+
+	array<Entry, MaxDepth> entries{};
+
+public:
+	/*!
+	\brief 在指定深度的环境中查找名称。
+	\pre 断言：第一参数非空。
+	\pre 断言：第二参数小于 MaxDepth 。
+	\pre 间接断言：第三参数的数据指针非空。
+	\sa Environment::LookupName
+	*/
+	YB_ATTR_nodiscard Environment::NameResolution::first_type
+	Lookup(const shared_ptr<Environment>&, size_t, string_view, Statistics&);
+};
+
+
+/*!
+\brief 规约器帧资源：分配动作序列的节点和规约器目标的池资源。
+\warning 非线程安全。
+\sa ContextNode
+\since build 955
+
+按大小类别分配不超过 MaxBlockSize 字节且对齐不超过 Granularity 的块。
+每个大小类别的块从上游资源分配的不超过 ChunkSize 字节的块组（slab）中切分，
+	释放时放回空闲列表而不返回上游资源，以被之后相同大小类别的分配请求复用。
+其它请求直接转发到上游资源。
+析构或调用 release 时释放所有从上游资源分配的块组。
+*/
+class YF_API ReducerFrameResource final : public pmr::memory_resource
+{
+public:
+	//! \brief 统计：分配请求和从上游资源分配的次数。
+	struct Statistics final
+	{
+		size_t Allocations = 0;
+		size_t UpstreamAllocations = 0;
+	};
+
+	//! \brief 块大小和对齐的粒度。
+	static yconstexpr const size_t Granularity = yalignof(std::max_align_t);
+	//! \brief 池中分配的最大块大小。
+	static yconstexpr const size_t MaxBlockSize = yimpl(256);
+	//! \brief 从上游资源分配的块组大小。
+	static yconstexpr const size_t ChunkSize = yimpl(4096);
+
+private:
+	struct Block final
+	{
+		Block* Next;
+	};
+	struct Chunk final
+	{
+		Chunk* Next;
+		size_t Size;
+	};
+
+	lref<pmr::memory_resource> upstream;
+	array<Block*, MaxBlockSize / Granularity> free_lists{};
+	Chunk* chunks = {};
+	Statistics stats{};
+
+public:
+	ReducerFrameResource(pmr::memory_resource& r) ynothrow
+		: upstream(r)
+	{}
+	DefDelCopyCtor(ReducerFrameResource)
+	//! \brief 析构：释放所有从上游资源分配的块组。
+	~ReducerFrameResource() override;
+
+	DefDelCopyAssignment(ReducerFrameResource)
+
+	DefGetter(const ynothrow, const Statistics&, Statistics, stats)
+	DefGetter(const ynothrow, pmr::memory_resource&, UpstreamRef, upstream)
+
+	/*!
+	\brief 释放所有从上游资源分配的块组。
+	\pre 所有从池中分配的块已被释放。
+	*/
+	void
+	release() ynothrow;
+
+protected:
+	YB_ALLOCATOR YB_ATTR_returns_nonnull void*
+	do_allocate(size_t, size_t) override;
+
+	void
+	do_deallocate(void*, size_t, size_t) override;
+
+	YB_ATTR_nodiscard YB_PURE bool
+	do_is_equal(const memory_resource&) const ynothrow override;
+
+private:
+	//! \brief 从上游资源分配块组并切分为指定大小类别的空闲块。
+	void
+	Refill(size_t);
+};
+
+
 /*!
 \brief 上下文节点。
 \since build 782
@@ -2666,8 +3291,9 @@ private:
 	\invariant p_record 。
 	\since build 788
 	*/
-	shared_ptr<Environment> p_record{YSLib::allocate_shared<Environment>(
-		Environment::allocator_type(&memory_rsrc.get()))};
+	shared_ptr<Environment> p_record{EnvironmentCollector::Track(
+		YSLib::allocate_shared<Environment>(
+		Environment::allocator_type(&memory_rsrc.get())))};
 
 public:
 	/*!
@@ -2757,6 +3383,14 @@ public:
 	*/
 	ContextNode(pmr::memory_resource&);
 	/*!
+	\brief 构造：使用指定的存储资源和规约器帧的存储资源。
+	\sa GetFrameAllocator
+	\since build 955
+
+	第二参数指定动作序列的节点和 SetupFront 创建的规约器使用的存储资源。
+	*/
+	ContextNode(pmr::memory_resource&, pmr::memory_resource&);
+	/*!
 	\brief 构造：使用对象副本和环境指针。
 	\throw std::invalid_argument 参数指针为空。
 	\sa Environment::ThrowForInvalidValue
@@ -2802,6 +3436,12 @@ public:
 	DefGetter(const ynothrow, const ReducerSequence&, Current, current)
 	//! \since build 943
 	DefGetter(ynothrow, ReducerSequence&, CurrentRef, current)
+	/*!
+	\brief 取规约器帧的分配器：动作序列使用的分配器。
+	\since build 955
+	*/
+	DefGetter(const ynothrow, ReducerSequence::allocator_type, FrameAllocator,
+		current.get_allocator())
 	DefGetter(const ynothrow
 		-> decltype(std::declval<Reducer>().target_type()), auto,
 		CurrentActionType, IsAlive() ? current.front().target_type()
@@ -2904,6 +3544,21 @@ public:
 	YB_ATTR_nodiscard static Environment::NameResolution
 	DefaultResolve(shared_ptr<Environment>, string_view);
 
+	/*!
+	\brief 使用名称解析缓存解析名称。
+	\pre 断言：第二参数的数据指针非空。
+	\sa DefaultResolve
+	\sa Resolve
+	\since build 955
+
+	若 Resolve 调用 DefaultResolve ，以和 DefaultResolve 相同的规则解析名称，
+		但使用第三参数缓存第一参数以外的被重定向的环境中的查找结果；
+		否则，同调用 Resolve 。
+	*/
+	YB_ATTR_nodiscard Environment::NameResolution
+	ResolveCached(shared_ptr<Environment>, string_view, NameResolutionCache&,
+		NameResolutionCache::Statistics&) const;
+
 	/*!
 	\post \c IsAlive() 。
 	\exception std::bad_function_call Reducer 参数为空。
@@ -2987,7 +3642,7 @@ public:
 	YB_FLATTEN inline void
 	SetupFront(_tParams&&... args)
 	{
-		SetupFront(NPL::ToReducer(get_allocator(), yforward(args)...));
+		SetupFront(NPL::ToReducer(GetFrameAllocator(), yforward(args)...));
 	}
 	//@}
 
@@ -3008,7 +3663,7 @@ public:
 	*/
 	//@{
 	PDefH(ReducerSequence, Switch, ) ynothrowv
-		ImplRet(Switch(ReducerSequence(get_allocator())))
+		ImplRet(Switch(ReducerSequence(GetFrameAllocator())))
 	//! \pre 参数的分配器和当前动作的分配器相等。
 	PDefH(ReducerSequence, Switch, ReducerSequence acts) ynothrowv
 		ImplRet(ystdex::exchange(current, std::move(acts)))
@@ -3095,6 +3750,7 @@ YB_NONNULL(3) inline PDefH(void, AssertMatchedAllocators,
 /*!
 \brief 分配环境。
 \return 新创建环境的非空指针。
+\note 使用 EnvironmentCollector::Track 追踪新创建的环境。
 \relates Environment
 \since build 847
 */
@@ -3104,7 +3760,8 @@ template<typename... _tParams>
 YB_ATTR_nodiscard inline shared_ptr<Environment>
 AllocateEnvironment(const Environment::allocator_type& a, _tParams&&... args)
 {
-	return YSLib::allocate_shared<Environment>(a, yforward(args)...);
+	return EnvironmentCollector::Track(
+		YSLib::allocate_shared<Environment>(a, yforward(args)...));
 }
 template<typename... _tParams>
 YB_ATTR_nodiscard inline shared_ptr<Environment>
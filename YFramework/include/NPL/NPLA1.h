@@ -11,13 +11,13 @@
 /*!	\file NPLA1.h
 \ingroup NPL
 \brief NPLA1 公共接口。
-\version r10005
+\version r10020
 \author FrankHB <frankhb1989@gmail.com>
 \since build 472
 \par 创建时间:
 	2014-02-02 17:58:24 +0800
 \par 修改时间:
-	2022-09-14 02:53 +0800
+	2026-10-17 17:13 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -51,6 +51,7 @@
 #include <ystdex/cast.hpp> // for ystdex::polymorphic_downcast;
 #include <ystdex/scope_guard.hpp> // for ystdex::guard;
 #include <iosfwd> // for std::ostream;
+#include <chrono> // for std::chrono::steady_clock;
 
 namespace NPL
 {
@@ -298,8 +299,180 @@ using GuardPasses = YSLib::GEvent<Guard(TermNode&, ContextNode&),
 //@}
 
 
+/*!
+\brief 求值剖析器：记录通过合并项调用的合并子的统计。
+\warning 非线程安全。
+\sa ContextState::ProfilerPtr
+\since build 955
+
+记录合并子的调用次数、包含和不包含被调用的合并子的时间以及分配次数，
+	并按调用路径记录不包含被调用的合并子的时间。
+合并子以调用时的操作符名称区分；不以名称调用的合并子视为相同的匿名合并子。
+尾调用的合并子的记录作为调用者的记录的内层记录，并替换之前尾调用的合并子的记录，
+	使尾调用的循环中的记录数有界。
+剖析器自身的存储不使用上下文的存储资源，以避免影响分配的计数。
+*/
+class YF_API Profiler final
+{
+public:
+	// NOTE: %YSLib::Timers::HighResolutionClock is not used to avoid the
+	//	dependency on YCLib timer implementation in the bootstrap.
+	using Clock = std::chrono::steady_clock;
+	using Duration = Clock::duration;
+	using TimePoint = Clock::time_point;
+
+	//! \brief 合并子的统计项。
+	struct Entry final
+	{
+		//! \brief 调用次数。
+		size_t Calls = 0;
+		//! \brief 包含被调用的合并子的时间：递归的调用不重复计入。
+		Duration Inclusive{};
+		//! \brief 不包含被调用的合并子的时间。
+		Duration Exclusive{};
+		//! \brief 不包含被调用的合并子的分配次数。
+		size_t Allocations = 0;
+		//! \brief 未退出的调用数。
+		size_t Active = 0;
+	};
+
+	/*!
+	\brief 计数的存储资源：转发分配到上游资源，并在剖析器中计数。
+	\note 使用此资源作为上下文的存储资源，以记录分配次数。
+	*/
+	class YF_API CountingResource : public pmr::memory_resource
+	{
+	private:
+		lref<pmr::memory_resource> upstream;
+		lref<Profiler> profiler;
+
+	public:
+		CountingResource(pmr::memory_resource& r, Profiler& pf) ynothrow
+			: upstream(r), profiler(pf)
+		{}
+
+	protected:
+		YB_ALLOCATOR YB_ATTR_returns_nonnull void*
+		do_allocate(size_t, size_t) override;
+
+		void
+		do_deallocate(void*, size_t, size_t) override;
+
+		YB_ATTR_nodiscard YB_PURE bool
+		do_is_equal(const memory_resource&) const ynothrow override;
+	};
+
+private:
+	//! \brief 调用记录。
+	struct Frame final
+	{
+		//! \brief 名称索引。
+		size_t Name;
+		//! \brief 调用路径节点索引。
+		size_t Node;
+		TimePoint Start;
+		//! \brief 是否为尾调用。
+		bool Tail;
+	};
+	//! \brief 调用路径节点。
+	struct PathNode final
+	{
+		size_t Parent;
+		size_t Name;
+		Duration Time;
+		size_t Allocations;
+	};
+
+	//! \invariant <tt>names.size() == entries.size()</tt> 。
+	//@{
+	vector<string> names;
+	YSLib::map<string, size_t, ystdex::less<>> name_index;
+	vector<Entry> entries;
+	//@}
+	//! \invariant <tt>!nodes.empty()</tt> ：第一个元素是根节点。
+	vector<PathNode> nodes;
+	YSLib::map<pair<size_t, size_t>, size_t> children;
+	vector<Frame> frames;
+	//! \brief 最后更新统计的时刻。
+	TimePoint last{};
+	size_t allocations = 0;
+	//! \brief 最后更新统计时的分配次数。
+	size_t last_allocations = 0;
+
+public:
+	Profiler();
+	DefDelCopyCtor(Profiler)
+
+	DefDelCopyAssignment(Profiler)
+
+	//! \brief 取分配次数。
+	DefGetter(const ynothrow, size_t, Allocations, allocations)
+	//! \brief 取未退出的调用的深度。
+	DefGetter(const ynothrow, size_t, Depth, frames.size())
+
+	/*!
+	\brief 取名称对应的统计项。
+	\return 若不存在，空指针。
+	*/
+	YB_ATTR_nodiscard YB_PURE const Entry*
+	Find(string_view) const;
+
+	/*!
+	\brief 进入调用。
+	\return 进入调用后的深度。
+	*/
+	size_t
+	Enter(string_view);
+
+	/*!
+	\brief 退出深度不小于参数的调用。
+	\note 因异常等未正常退出的内层调用同时被退出。
+	*/
+	void
+	Exit(size_t) ynothrow;
+
+	/*!
+	\brief 尾调用：进入调用，并退出最内层调用中之前的尾调用。
+	\note 进入的调用和最内层调用同时被 Exit 退出。
+	*/
+	void
+	Replace(string_view);
+
+	//! \brief 输出按不包含被调用的合并子的时间降序排列的统计表。
+	void
+	PrintSummary(std::ostream&) const;
+
+	/*!
+	\brief 输出折叠的调用栈。
+	\note 格式和火焰图工具的输入兼容：每行为分号分隔的调用路径和以微秒计的时间。
+	*/
+	void
+	PrintCollapsedStacks(std::ostream&) const;
+
+	//! \brief 清除所有记录。
+	void
+	clear() ynothrow;
+
+private:
+	YB_ATTR_nodiscard size_t
+	Intern(string_view);
+
+	void
+	Pop(TimePoint) ynothrow;
+
+	void
+	Push(size_t, TimePoint, bool);
+
+	//! \brief 更新最内层调用的统计。
+	void
+	Update(TimePoint) ynothrow;
+};
+
+
 //! \since build 955
 class GlobalState;
+//! \since build 955
+class RegexCache;
 
 /*!
 \brief NPLA1 上下文状态。
@@ -348,6 +521,13 @@ public:
 	\since build 955
 	*/
 	SourceName CurrentSource{};
+	/*!
+	\brief 剖析器指针。
+	\note 非空时，记录通过合并项调用的合并子；否则，不记录。
+	\sa Profiler
+	\since build 955
+	*/
+	shared_ptr<Profiler> ProfilerPtr{};
 
 	/*!
 	\brief 构造：使用指定的全局状态引用。
@@ -470,6 +650,8 @@ public:
 	调用 Guard 进行必要的上下文重置守卫；
 	调用 UnwindCurrent 回滚当前动作的守卫；
 	调用 Rewrite 。
+	重写结束（包括因异常退出）时，若剖析器指针非空，
+		退出剖析器中重写开始后进入且未退出的调用。
 	*/
 	ReductionStatus
 	RewriteGuarded(TermNode&, Reducer);
@@ -1590,7 +1772,7 @@ GetModuleFor(ContextNode& ctx, _fCallable&& f, _tParams&&... args)
 
 	AssignParent(ctx, std::move(parent));
 	ystdex::invoke(yforward(f), yforward(args)...);
-	ctx.GetRecordRef().Frozen = true;
+	ctx.GetRecordRef().Freeze();
 	return ctx.ShareRecord();
 }
 
@@ -1866,6 +2048,20 @@ using Tokenizer = GTokenizer<ByteParser>;
 //! \brief 标记器：分析带有源代码位置信息的词素转换为可能包含记号的节点。
 using SourcedTokenizer = GTokenizer<SourcedByteParser, ContextState&>;
 
+/*!
+\brief 视图标记器：分析引用输入的词素转换为可能包含记号的节点。
+\sa ViewByteParser
+\since build 955
+*/
+using ViewTokenizer = GTokenizer<ViewByteParser>;
+
+/*!
+\brief 视图标记器：分析带有源代码位置信息的引用输入的词素转换为可能包含记号的节点。
+\sa SourcedViewByteParser
+\since build 955
+*/
+using SourcedViewTokenizer = GTokenizer<SourcedViewByteParser, ContextState&>;
+
 
 //! \ingroup NPLDiagnostics
 //@{
@@ -2054,6 +2250,15 @@ MoveKeptGuard(_tGuard&& gd)
 //@}
 
 
+/*!
+\brief 纯合并子表：名称映射到被标记为纯的合并子的处理器。
+\sa MarkPureCombiners
+\sa SetupConstantFolding
+\since build 955
+*/
+using PureCombinerTable = YSLib::map<string, ContextHandler, ystdex::less<>>;
+
+
 /*
 \brief 全局状态。
 \warning 非虚析构。
@@ -2096,8 +2301,15 @@ public:
 	*/
 	using Loader = function<TermNode(ContextState&, string)>;
 
-private:
-	//! \since build 891
+	/*!
+	\brief 叶节点转换器：按全局状态的设置转换分析结果中的词素为叶节点。
+	\sa ConvertLeaf
+	\sa ConvertLeafSourced
+	\sa ConvertLeafView
+	\sa ConvertLeafViewSourced
+	\sa Prepare
+	\since build 891
+	*/
 	struct LeafConverter final
 	{
 		//! \since build 955
@@ -2109,9 +2321,15 @@ private:
 		YB_ATTR_nodiscard PDefHOp(TermNode, (),
 			const GParsedValue<SourcedByteParser>& val) const
 			ImplRet(Context.Global.get().ConvertLeafSourced(val, Context))
+		//! \since build 955
+		//@{
+		YB_ATTR_nodiscard TermNode
+		operator()(const GParsedValue<ViewByteParser>&) const;
+		YB_ATTR_nodiscard TermNode
+		operator()(const GParsedValue<SourcedViewByteParser>&) const;
+		//@}
 	};
 
-public:
 	/*!
 	\brief 节点分配器。
 	\since build 845
@@ -2149,6 +2367,26 @@ public:
 	SourcedTokenizer ConvertLeafSourced;
 	//@}
 	/*!
+	\brief 引用输入的叶节点词素转换器。
+	\note 默认为空。
+	\sa ViewByteParser
+	\since build 955
+
+	若为空且 ConvertLeaf 是默认构造时设置的值，直接转换词素；
+	否则，若为空，复制词素后使用 ConvertLeaf 转换。
+	替换 ConvertLeaf 后，若需转换时不复制词素，需同时设置此转换器。
+	*/
+	ViewTokenizer ConvertLeafView{};
+	/*!
+	\brief 带有源代码信息的引用输入的叶节点词素转换器。
+	\note 默认为空。
+	\sa SourcedViewByteParser
+	\since build 955
+
+	同 ConvertLeafView ，但对应 ConvertLeafSourced 。
+	*/
+	SourcedViewTokenizer ConvertLeafViewSourced{};
+	/*!
 	\brief 默认启用源代码位置。
 	\sa Perform
 	*/
@@ -2168,6 +2406,54 @@ public:
 	\since build 901
 	*/
 	observer_ptr<std::ostream> OutputStreamPtr{};
+	/*!
+	\brief 缓存名称解析。
+	\sa EvaluateIdentifier
+	\sa SetupNameResolutionCache
+	\since build 955
+
+	若为 true ，求值标识符时使用 AnnotateNameResolutionCache 在记号值上标注的名称解析缓存。
+	*/
+	bool CacheNameResolution = {};
+	/*!
+	\brief 名称解析缓存的统计。
+	\sa CacheNameResolution
+	\since build 955
+	*/
+	mutable NameResolutionCache::Statistics NameCacheStatistics{};
+	/*!
+	\brief 常量折叠。
+	\sa SetupConstantFolding
+	\since build 955
+
+	若为 true ，求值列表时使用 AnnotateConstantFolding 在合并子名称上标注的常量折叠缓存。
+	*/
+	bool FoldConstants = {};
+	/*!
+	\brief 纯合并子表。
+	\note 可变以允许加载模块时通过上下文状态标记纯合并子。
+	\sa MarkPureCombiners
+	\since build 955
+	*/
+	mutable PureCombinerTable PureCombiners{};
+	/*!
+	\brief 正则表达式缓存。
+	\note 类型在 Dependency.h 中定义；非空时被 std.strings 模块的正则表达式操作使用。
+	\sa LoadModule_std_strings
+	\since build 955
+	*/
+	mutable shared_ptr<RegexCache> RegexCachePtr{};
+	/*!
+	\brief 规约器帧资源。
+	\pre 非空。
+	\sa ContextState::ContextState
+	\since build 955
+
+	以 Allocator 的存储资源作为上游资源，
+		被使用此对象构造的上下文状态的动作序列和规约器共享。
+	*/
+	shared_ptr<ReducerFrameResource> FrameResourcePtr{YSLib::allocate_shared<
+		ReducerFrameResource>(Allocator, NPL::Deref(Allocator.resource()))};
 
 	/*!
 	\sa ListTermPreprocess
@@ -2179,7 +2465,10 @@ public:
 	\sa ParseLeaf
 	*/
 	GlobalState(pmr::memory_resource& = NPL::Deref(pmr::new_delete_resource()));
-	//! \brief 构造：使用默认解释、指定的存储资源和叶节点词素转换器。
+	/*!
+	\brief 构造：使用默认解释、指定的存储资源和叶节点词素转换器。
+	\note 不设置引用输入的叶节点词素转换器，以使用参数指定的转换器转换所有词素。
+	*/
 	GlobalState(Tokenizer, SourcedTokenizer,
 		pmr::memory_resource& = NPL::Deref(pmr::new_delete_resource()));
 	//@}
@@ -2317,6 +2606,74 @@ public:
 	//@}
 };
 
+/*!
+\brief 标注名称解析缓存：在参数指定的项中的记号值叶节点上添加名称解析缓存。
+\note 保留记号值中的源代码信息。
+\sa GlobalState::CacheNameResolution
+\sa QuerySourceInformation
+\since build 955
+
+已被标注的记号值不被重复标注。
+项的副本共享被标注的缓存。
+*/
+YF_API void
+AnnotateNameResolutionCache(TermNode&);
+
+/*!
+\brief 设置名称解析缓存。
+\relates GlobalState
+\since build 955
+
+在 GlobalState::Preprocess 之后添加调用 AnnotateNameResolutionCache 的遍，
+	并启用 GlobalState::CacheNameResolution 。
+之后预处理的项中的标识符求值使用名称解析缓存。
+*/
+YF_API void
+SetupNameResolutionCache(GlobalState&);
+
+/*!
+\brief 标记纯合并子：在纯合并子表中记录当前环境中以指定名称绑定的合并子。
+\pre 间接断言：名称的数据指针非空。
+\sa GlobalState::PureCombiners
+\since build 955
+
+对每个名称，若当前环境中解析的对象是合并子，以名称和合并子的处理器作为纯合并子表的项；
+	否则，忽略这个名称。
+被标记的合并子应在以相同的操作数调用时总是求值为相等的值，且不具有副作用。
+*/
+YF_API void
+MarkPureCombiners(ContextState&, std::initializer_list<string_view>);
+
+/*!
+\brief 标注常量折叠：在参数指定的项中可被折叠的合并项的合并子名称上添加常量折叠缓存。
+\note 保留记号值中的源代码信息。
+\sa GlobalState::FoldConstants
+\since build 955
+
+可被折叠的合并项是第一个子项为纯合并子表中的名称，且其它子项都是非符号的叶节点
+	或可被折叠的合并项的列表。
+这些合并项的合并子名称被标注包含名称解析缓存的常量折叠缓存；
+	已被标注常量折叠缓存的记号值不被重复标注，项的副本共享被标注的缓存。
+第一次求值合并项得到的不包含引用值的结果被保存在缓存中；
+	之后求值时，若合并项中的合并子名称在当前环境中解析的对象仍是纯合并子表中对应的合并子，
+	以缓存的值替换合并项，而不求值子项和调用合并子。
+因此，重新定义或遮蔽名称后，合并项被正常地求值。
+*/
+YF_API void
+AnnotateConstantFolding(TermNode&, const PureCombinerTable&);
+
+/*!
+\brief 设置常量折叠。
+\relates GlobalState
+\since build 955
+
+在 GlobalState::Preprocess 之后添加以全局状态的纯合并子表调用 AnnotateConstantFolding 的遍，
+	并启用 GlobalState::FoldConstants 。
+之后预处理的项中的纯合并子调用被折叠。
+*/
+YF_API void
+SetupConstantFolding(GlobalState&);
+
 //! \since build 955
 template<typename... _tParams>
 // XXX: No %YB_ATTR_nodiscard.
@@ -11,13 +11,13 @@
 /*!	\file NPLA1Forms.h
 \ingroup NPL
 \brief NPLA1 语法形式。
-\version r8880
+\version r8881
 \author FrankHB <frankhb1989@gmail.com>
 \since build 882
 \par 创建时间:
 	2020-02-15 11:19:21 +0800
 \par 修改时间:
-	2022-09-12 02:53 +0800
+	2026-10-17 12:10 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -1200,6 +1200,18 @@ GetCurrentEnvironment(TermNode&, ContextNode&);
 YF_API void
 LockCurrentEnvironment(TermNode&, ContextNode&);
 
+/*!
+\brief 追踪值对象中的合并子持有的环境引用。
+\return 值对象是否持有上下文处理器。
+\sa EnvironmentCollector::Tracer
+\since build 955
+
+识别 ContextHandler 中的 FormContextHandler 和 vau 抽象，访问其中的父环境。
+其它上下文处理器中的环境引用不被识别。
+*/
+YF_API bool
+TraceEnvironments(const ValueObject&, EnvironmentCollector&);
+
 
 /*!
 \exception ParameterMismatch 绑定匹配失败。
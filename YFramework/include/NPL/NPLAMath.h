@@ -11,13 +11,13 @@
 /*!	\file NPLAMath.h
 \ingroup NPL
 \brief NPLA 数学功能。
-\version r11412
+\version r11413
 \author FrankHB <frankhb1989@gmail.com>
 \since build 930
 \par 创建时间:
 	2021-11-03 12:49:54 +0800
 \par 修改时间:
-	2022-02-04 05:46 +0800
+	2026-10-17 09:25 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -30,8 +30,10 @@
 
 #include "YModules.h"
 #include YFM_NPL_NPLA // for NPL, any_ops, ValueObject, ResolvedArg, array,
-//	string_view, std::uint_fast8_t, TypedValueAccessor;
+//	string_view, std::uint_fast8_t, TypedValueAccessor, vector, string;
 #include <limits> // for std::numeric_limits;
+#include <ystdex/operators.hpp> // for ystdex::totally_ordered,
+//	ystdex::integer_arithmetic;
 
 namespace NPL
 {
@@ -90,6 +92,218 @@ struct NumberNode
 //@}
 
 
+/*!
+\brief 任意精度整数：作为 bignum 的本机表示。
+\note 除非另行指定，操作的结果使用第一操作数的分配器。
+\since build 955
+
+以符号和绝对值表示的整数。
+绝对值以 Limb 为单位，低位在前存储，且不保存高位的 0 ；零值的单位序列为空且非负。
+整数运算的结果同 ISO C++ 内建整数类型，除法向零截断，余数和被除数同号。
+乘法对较大的操作数使用 Karatsuba 算法。
+*/
+class YF_API BigInt final : private ystdex::totally_ordered<BigInt>,
+	private ystdex::integer_arithmetic<BigInt>
+{
+public:
+	//! \brief 单位类型。
+	using Limb = std::uint32_t;
+	using LimbVector = vector<Limb>;
+	using allocator_type = LimbVector::allocator_type;
+
+	/*!
+	\brief 使用 Karatsuba 算法的乘法的操作数的最小单位数。
+	\note 较小的操作数使用逐位乘法。
+	*/
+	static yconstexpr const size_t KaratsubaThreshold = yimpl(32);
+
+private:
+	LimbVector limbs;
+	bool negative = {};
+
+public:
+	BigInt() = default;
+	explicit
+	BigInt(allocator_type a)
+		: limbs(a)
+	{}
+	//! \note 不超过 64 位的整数类型的值被精确转换。
+	template<typename _type, yimpl(ystdex::enable_if_t<
+		std::is_integral<_type>::value && (std::numeric_limits<_type>::digits
+		<= 64), int> = 0)>
+	BigInt(_type x, allocator_type a = {})
+		: limbs(a)
+	{
+		AssignInt(x, std::is_signed<_type>());
+	}
+	/*!
+	\pre 参数是有限值。
+	\note 浮点数值被向零截断。
+	*/
+	template<typename _type, yimpl(ystdex::enable_if_t<
+		std::is_floating_point<_type>::value, long> = 0L)>
+	explicit
+	BigInt(_type x, allocator_type a = {})
+		: limbs(a)
+	{
+		AssignFloat(static_cast<long double>(x));
+	}
+	BigInt(const BigInt& x, allocator_type a)
+		: limbs(x.limbs, a), negative(x.negative)
+	{}
+	BigInt(BigInt&& x, allocator_type a)
+		: limbs(std::move(x.limbs), a), negative(x.negative)
+	{
+		x.negative = {};
+	}
+	BigInt(const BigInt&) = default;
+	BigInt(BigInt&& x) ynothrow
+		: limbs(std::move(x.limbs)), negative(x.negative)
+	{
+		x.negative = {};
+	}
+
+	BigInt&
+	operator=(const BigInt&) = default;
+	//! \note 不交换分配器；分配器不相等时复制单位序列。
+	BigInt&
+	operator=(BigInt&&);
+
+	/*!
+	\brief 从十进制数字序列读取整数。
+	\pre 参数的数据指针非空。
+	\throw std::invalid_argument 参数包含十进制数字以外的字符。
+
+	参数可具有一个前缀的符号 + 或 - 。
+	按 9 个十进制数字一组累积，使每组只需要一次单位乘法。
+	*/
+	YB_ATTR_nodiscard static BigInt
+	FromDecimal(string_view, allocator_type = {});
+
+	YB_ATTR_nodiscard YB_PURE BigInt
+	operator-() const&;
+	YB_ATTR_nodiscard YB_PURE BigInt
+	operator-() &&;
+
+	BigInt&
+	operator+=(const BigInt&);
+
+	BigInt&
+	operator-=(const BigInt&);
+
+	BigInt&
+	operator*=(const BigInt&);
+
+	//! \throw std::domain_error 除数为零。
+	//@{
+	BigInt&
+	operator/=(const BigInt&);
+
+	BigInt&
+	operator%=(const BigInt&);
+	//@}
+
+	PDefHOp(BigInt&, ++, )
+		ImplRet(*this += BigInt(1, get_allocator()))
+
+	PDefHOp(BigInt&, --, )
+		ImplRet(*this -= BigInt(1, get_allocator()))
+
+	friend bool
+	operator==(const BigInt&, const BigInt&) ynothrow;
+
+	friend bool
+	operator<(const BigInt&, const BigInt&) ynothrow;
+
+	//! \brief 转换为整数类型：同 ISO C++ 对无符号整数的转换，保留模 2^N 的值。
+	template<typename _type, yimpl(ystdex::enable_if_t<
+		std::is_integral<_type>::value && (std::numeric_limits<_type>::digits
+		<= 64), int> = 0)>
+	YB_ATTR_nodiscard YB_PURE explicit
+	operator _type() const ynothrow
+	{
+		const auto m(GetLow64());
+
+		return _type(negative ? std::uint64_t(0) - m : m);
+	}
+	/*!
+	\brief 转换为浮点类型：取最接近的值，超出范围时为无穷大。
+	\note 舍入方式未指定。
+	*/
+	template<typename _type, yimpl(ystdex::enable_if_t<
+		std::is_floating_point<_type>::value, long> = 0L)>
+	YB_ATTR_nodiscard YB_PURE explicit
+	operator _type() const ynothrow
+	{
+		return _type(ToFloat());
+	}
+
+	DefPred(const ynothrow, Negative, negative)
+	DefPred(const ynothrow, Odd, !limbs.empty() && (limbs[0] & 1) != 0)
+	DefPred(const ynothrow, Zero, limbs.empty())
+
+	//! \brief 取绝对值的单位序列。
+	DefGetter(const ynothrow, const LimbVector&, Limbs, limbs)
+	//! \brief 取绝对值的低 64 位。
+	YB_ATTR_nodiscard YB_PURE PDefH(std::uint64_t, GetLow64, ) const ynothrow
+		ImplRet(limbs.empty() ? 0 : (limbs.size() == 1 ? std::uint64_t(limbs[0])
+			: std::uint64_t(limbs[0]) | std::uint64_t(limbs[1]) << 32))
+
+	/*!
+	\brief 计算截断的整数除法的商和余数。
+	\throw std::domain_error 除数为零。
+	\note 商和余数使用第一参数的分配器。
+	*/
+	static void
+	DivRem(const BigInt&, const BigInt&, BigInt&, BigInt&);
+
+	//! \brief 取相反数。
+	PDefH(void, Negate, ) ynothrow
+		ImplExpr(negative = !limbs.empty() && !negative)
+
+	//! \brief 转换为十进制表示。
+	YB_ATTR_nodiscard YB_PURE string
+	ToString(string::allocator_type = {}) const;
+
+private:
+	void
+	Assign(std::uint64_t, bool);
+
+	template<typename _type>
+	inline void
+	AssignInt(_type x, std::true_type)
+	{
+		Assign(x < 0 ? std::uint64_t(0) - std::uint64_t(x) : std::uint64_t(x),
+			x < 0);
+	}
+	template<typename _type>
+	inline void
+	AssignInt(_type x, std::false_type)
+	{
+		Assign(std::uint64_t(x), {});
+	}
+
+	void
+	AssignFloat(long double);
+
+	//! \brief 移除高位的 0 ，并规范化零值的符号。
+	void
+	Trim() ynothrow;
+
+	YB_ATTR_nodiscard YB_PURE long double
+	ToFloat() const ynothrow;
+
+public:
+	YB_ATTR_nodiscard YB_PURE
+		PDefH(allocator_type, get_allocator, ) const ynothrow
+		ImplRet(limbs.get_allocator())
+
+	//! \pre 参数的分配器相等。
+	friend PDefH(void, swap, BigInt& x, BigInt& y) ynothrow
+		ImplExpr(x.limbs.swap(y.limbs), std::swap(x.negative, y.negative))
+};
+
+
 /*!
 \brief 判断参数表示精确数。
 
@@ -479,9 +693,11 @@ struct FPCharTraits<long double>
 第一参数指定保存结果的对象。
 第二参数指定输入的数值表示的完整形式。
 第三参数指定第二参数中开始解析的位置。
+第四参数指定超过 fixnum 范围的精确数使用的分配器。
 */
 void
-ReadDecimal(ValueObject&, string_view, string_view::const_iterator);
+ReadDecimal(ValueObject&, string_view, string_view::const_iterator,
+	BigInt::allocator_type = {});
 
 
 //! \since build 937
@@ -11,13 +11,13 @@
 /*!	\file SContext.h
 \ingroup NPL
 \brief S 表达式上下文。
-\version r4575
+\version r4577
 \author FrankHB <frankhb1989@gmail.com>
 \since build 304
 \par 创建时间:
 	2012-08-03 19:55:41 +0800
 \par 修改时间:
-	2022-08-17 22:05 +0800
+	2026-10-17 10:31 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -1254,6 +1254,15 @@ ToLexeme(const _type& val) ynothrow
 YB_ATTR_nodiscard YB_PURE inline PDefH(const string&, ToLexeme,
 	const SourcedByteParser::ParseResult::value_type& val) ynothrow
 	ImplRet(val.second)
+//! \since build 955
+//@{
+YB_ATTR_nodiscard YB_STATELESS yconstfn
+	PDefH(string_view, ToLexeme, string_view val) ynothrow
+	ImplRet(val)
+YB_ATTR_nodiscard YB_PURE inline PDefH(string_view, ToLexeme,
+	const SourcedViewByteParser::ParseResult::value_type& val) ynothrow
+	ImplRet(val.second)
+//@}
 //@}
 
 /*!
@@ -1273,9 +1282,22 @@ struct LexemeTokenizer
 	YB_ATTR_nodiscard YB_PURE TermNode
 	operator()(const _type& val) const
 	{
-		return NPL::AsTermNode(Allocator, std::allocator_arg, Allocator,
-			ToLexeme(val));
+		return MakeTerm(ToLexeme(val));
 	}
+
+private:
+	//! \since build 955
+	//@{
+	YB_ATTR_nodiscard YB_PURE PDefH(TermNode, MakeTerm, const string& lexeme)
+		const
+		ImplRet(NPL::AsTermNode(Allocator, std::allocator_arg, Allocator,
+			lexeme))
+	//! \note 复制引用的词素，使节点不依赖被解析的输入的生存期。
+	YB_ATTR_nodiscard YB_PURE PDefH(TermNode, MakeTerm, string_view lexeme)
+		const
+		ImplRet(NPL::AsTermNode(Allocator, std::allocator_arg, Allocator,
+			string(lexeme.data(), lexeme.size(), Allocator)))
+	//@}
 };
 
 
@@ -1308,8 +1330,9 @@ public:
 		UpdateLexeme(ToLexeme(val));
 	}
 
+	//! \since build 955
 	void
-	UpdateLexeme(const string&);
+	UpdateLexeme(string_view);
 };
 
 
@@ -1460,6 +1483,29 @@ private:
 	ProcessReserve(_tParams&&...)
 	{}
 
+	/*!
+	\brief 若解析器支持，使用解析器成块地处理字节序列；否则，逐字节处理。
+	\since build 955
+	*/
+	//@{
+	template<class _tParser>
+	static auto
+	ProcessBlock(_tParser& parse, const char* first, const char* last, int)
+		-> decltype(ystdex::unref(parse)(first, last), void())
+	{
+		// NOTE: The buffer of the parser processing the range as a whole is not
+		//	reserved, since it does not keep the whole input.
+		ystdex::unref(parse)(first, last);
+	}
+	template<class _tParser>
+	static void
+	ProcessBlock(_tParser& parse, const char* first, const char* last, ...)
+	{
+		ProcessReserve(parse, size_t(last - first));
+		std::for_each(first, last, parse);
+	}
+	//@}
+
 	//! \since build 899
 	//@{
 	template<typename _tIn, class _tTag>
@@ -1490,6 +1536,15 @@ private:
 		ProcessReserve(parse, size_t(last - first));
 		return ProcessSequence(first, last, parse, std::input_iterator_tag());
 	}
+	//! \since build 955
+	template<typename _fParse>
+	YB_ATTR_nodiscard inline _fParse
+	ProcessSequence(const char* first, const char* last, _fParse parse,
+		std::random_access_iterator_tag)
+	{
+		ProcessBlock(parse, first, last, 0);
+		return parse;
+	}
 
 	template<typename _tIn, class _tTag>
 	YB_ATTR_nodiscard inline pair<DefaultParser, _tIn>
@@ -11,13 +11,13 @@
 /*!	\file FileSystem.h
 \ingroup YCLib
 \brief 平台相关的文件系统接口。
-\version r4234
+\version r4235
 \author FrankHB <frankhb1989@gmail.com>
 \since build 312
 \par 创建时间:
 	2012-05-30 22:38:37 +0800
 \par 修改时间:
-	2022-01-13 22:17 +0800
+	2026-10-17 16:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -971,6 +971,16 @@ uunlink(const char*) ynothrowv;
 */
 YB_ATTR_nodiscard YF_API YB_NONNULL(1) bool
 uremove(const char*) ynothrowv;
+
+/*!
+\brief 按路径重命名一个文件，替换已存在的目标。
+\note 第一参数和第二参数分别为原路径和新路径。
+\note POSIX 平台：除路径和返回值外语义同 \c ::rename 。
+\note Win32 平台：使用 \c ::MoveFileExW 实现，替换已存在的非目录文件。
+\since build 955
+*/
+YB_ATTR_nodiscard YF_API YB_NONNULL(1, 2) bool
+urename(const char*, const char*) ynothrowv;
 //@}
 //@}
 
@@ -11,13 +11,13 @@
 /*!	\file YAdaptor.h
 \ingroup Adaptor
 \brief 外部库关联。
-\version r2464
+\version r2465
 \author FrankHB <frankhb1989@gmail.com>
 \since 早于 build 132
 \par 创建时间:
 	2010-02-22 20:16:21 +0800
 \par 修改时间:
-	2022-02-14 07:56 +0800
+	2026-10-17 16:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -285,6 +285,8 @@ using platform::urmdir;
 using platform::uunlink;
 //! \since build 476
 using platform::uremove;
+//! \since build 955
+using platform::urename;
 
 //! \since build 713
 using platform::FetchCurrentWorkingDirectory;
@@ -11,13 +11,13 @@
 /*!	\file ValueNode.h
 \ingroup Core
 \brief 值类型节点。
-\version r4291
+\version r4292
 \author FrankHB <frankhb1989@gmail.com>
 \since build 338
 \par 创建时间:
 	2012-08-03 23:03:44 +0800
 \par 修改时间:
-	2022-09-09 00:08 +0800
+	2026-10-17 13:51 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -1509,6 +1509,15 @@ IsPrefixedIndex(string_view, char = '$');
 YB_ATTR_nodiscard YF_API YB_PURE string
 MakeIndex(size_t);
 
+/*!
+\brief 判断字符串是否能被 DecodeIndex 解码为节点名称的前缀索引。
+\pre 断言：参数的数据指针非空。
+\sa DecodeIndex
+\since build 955
+*/
+YB_ATTR_nodiscard YF_API YB_PURE bool
+IsDecodableIndex(string_view) ynothrowv;
+
 //! \throw std::invalid_argument 存在子节点但名称不是前缀索引。
 //@{
 /*!
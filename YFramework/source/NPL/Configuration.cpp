@@ -11,13 +11,13 @@
 /*!	\file Configuration.cpp
 \ingroup NPL
 \brief 配置设置。
-\version r981
+\version r983
 \author FrankHB <frankhb1989@gmail.com>
 \since build 334
 \par 创建时间:
 	2012-08-27 15:15:06 +0800
 \par 修改时间:
-	2022-09-10 02:11 +0800
+	2026-10-17 17:36 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -26,7 +26,7 @@
 
 
 #include "NPL/YModules.h"
-#include YFM_NPL_Configuration // for PrintNode, LiteralizeEscapeNodeLiteral;
+#include YFM_NPL_Configuration // for NodePrinter;
 #include YFM_NPL_SContext // for Session, SContext::Analyze;
 #include <iterator> // for std::istreambuf_iterator;
 #include <ystdex/ios.hpp> // for ystdex::rethrow_badstate,
@@ -52,7 +52,11 @@ LoadNode(const TermNode& tree)
 std::ostream&
 operator<<(std::ostream& os, const Configuration& conf)
 {
-	PrintNode(os, conf.GetRoot(), LiteralizeEscapeNodeLiteral);
+	NodePrinter printer(os, true);
+
+	printer(conf.GetRoot());
+	// NOTE: See %PrintNode.
+	printer.Flush();
 	return os;
 }
 
@@ -11,13 +11,13 @@
 /*!	\file Dependency.cpp
 \ingroup NPL
 \brief 依赖管理。
-\version r7359
+\version r7376
 \author FrankHB <frankhb1989@gmail.com>
 \since build 623
 \par 创建时间:
 	2015-08-09 22:14:45 +0800
 \par 修改时间:
-	2022-09-14 01:45 +0800
+	2026-10-17 17:34 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -73,6 +73,17 @@
 #include <ystdex/string.hpp> // for ystdex::begins_with;
 #include <ystdex/cstdio.h> // for ystdex::fexists;
 #include <cerrno> // for errno, EEXIST, EPERM;
+#include <stdexcept> // for std::out_of_range;
+#include <limits> // for std::numeric_limits;
+#include <algorithm> // for std::copy_backward, std::copy, std::fill;
+#include <array> // for std::array;
+#include <cstring> // for std::memcpy;
+#include <sstream> // for YSLib::ostringstream;
+#if YF_Multithread == 1
+#	include <ystdex/concurrency.h> // for std::mutex, std::condition_variable,
+//	std::lock_guard, std::unique_lock, std::thread, ystdex::task_pool;
+#	include <future> // for std::future, std::shared_future;
+#endif
 
 namespace NPL
 {
@@ -219,6 +230,438 @@ OpenUnique(ContextState& cs, string filename)
 	return p_is;
 }
 
+//! \since build 955
+namespace
+{
+
+//! \brief 翻译单元映像的魔数。
+yconstexpr const char UnitImageMagic[]{'N', 'P', 'L', 'A', '1', 'I', 'M', 'G'};
+/*!
+\brief 翻译单元映像的格式版本。
+
+映像保存叶节点转换前的分析结果，叶节点在加载映像时按当前的全局状态转换，
+因此转换叶节点的实现改变时不需改变版本。
+映像格式或词法分析的结果改变时，需改变版本，使之前的映像失效。
+*/
+yconstexpr const std::uint64_t UnitImageFormatVersion(2);
+//! \brief 翻译单元映像的标志：叶节点包含源代码位置。
+yconstexpr const std::uint64_t UnitImageSourced(1);
+
+/*!
+\brief 翻译单元映像的头部的值的序列。
+
+映像依次包含魔数、头部的值和先序遍历的节点记录。
+头部的值依次为格式版本、标志、源代码文件的大小和修改时间。
+检查源代码文件的状态而不读取内容，因此在修改时间的精度内修改且不改变大小的源代码
+	不使映像失效。
+*/
+using UnitImageHeader = std::array<std::uint64_t, 4>;
+
+YB_ATTR_nodiscard UnitImageHeader
+MakeUnitImageHeader(bool sourced, const YSLib::MappedFile& src)
+{
+	return {{UnitImageFormatVersion, sourced ? UnitImageSourced : 0,
+		std::uint64_t(src.GetSize()), std::uint64_t(
+		YSLib::IO::GetFileModificationTimeOf(src.GetFile()).count())}};
+}
+
+/*!
+\brief 翻译单元映像的读取器。
+
+节点记录以可变长度的无符号整数起始，最低位为 1 时表示叶节点，否则表示分支节点，
+	其余位分别表示词素的长度和子节点的个数。
+包含源代码位置时，叶节点记录之后依次是行和列，最后是词素。
+*/
+class UnitImageReader final
+{
+private:
+	string_view buffer;
+
+public:
+	UnitImageReader(string_view buf) ynothrow
+		: buffer(buf)
+	{}
+
+	DefPred(const ynothrow, Empty, buffer.empty())
+
+	//! \note 读取缓冲区中的值，成功时移除已读取的前缀。
+	//@{
+	YB_ATTR_nodiscard bool
+	ReadFixed(std::uint64_t& val) ynothrow
+	{
+		if(buffer.size() >= sizeof(val))
+		{
+			std::memcpy(&val, buffer.data(), sizeof(val));
+			buffer.remove_prefix(sizeof(val));
+			return true;
+		}
+		return {};
+	}
+
+	YB_ATTR_nodiscard bool
+	ReadSize(size_t& val) ynothrow
+	{
+		size_t res(0);
+		size_t shift(0);
+
+		while(!buffer.empty() && shift < std::numeric_limits<size_t>::digits)
+		{
+			const auto c(static_cast<unsigned char>(buffer.front()));
+
+			buffer.remove_prefix(1);
+			res |= size_t(c & 0x7FU) << shift;
+			if(!(c & 0x80U))
+			{
+				val = res;
+				return true;
+			}
+			shift += 7;
+		}
+		return {};
+	}
+
+	//! \note 读取的词素引用缓冲区。
+	YB_ATTR_nodiscard bool
+	ReadLexeme(size_t n, string_view& lexeme) ynothrow
+	{
+		if(n <= buffer.size())
+		{
+			lexeme = buffer.substr(0, n);
+			buffer.remove_prefix(n);
+			return true;
+		}
+		return {};
+	}
+	//@}
+
+	/*!
+	\brief 读取并转换叶节点。
+	\return 是否读取成功。
+	*/
+	//@{
+	template<typename _fConv>
+	YB_ATTR_nodiscard bool
+	ReadLeaf(TermNode& parent, size_t n, _fConv conv, std::false_type)
+	{
+		string_view lexeme;
+
+		if(ReadLexeme(n, lexeme))
+		{
+			parent.Add(conv(lexeme));
+			return true;
+		}
+		return {};
+	}
+	template<typename _fConv>
+	YB_ATTR_nodiscard bool
+	ReadLeaf(TermNode& parent, size_t n, _fConv conv, std::true_type)
+	{
+		size_t line, col;
+		string_view lexeme;
+
+		if(ReadSize(line) && ReadSize(col) && ReadLexeme(n, lexeme))
+		{
+			parent.Add(conv(pair<SourceLocation, string_view>(
+				SourceLocation(line, col), lexeme)));
+			return true;
+		}
+		return {};
+	}
+	//@}
+
+	/*!
+	\brief 读取映像中的节点记录，构造参数指定的根节点的子节点。
+	\return 是否读取有效的记录。
+	*/
+	template<bool _bSourced, typename _fConv>
+	YB_ATTR_nodiscard bool
+	ReadTerm(TermNode& root, _fConv conv)
+	{
+		const auto a(root.get_allocator());
+		size_t n;
+
+		if(ReadSize(n) && (n & 1) == 0)
+		{
+			// NOTE: Each element is the branch being built and the number of
+			//	its subterms still to be read.
+			YSLib::stack<pair<TermNode*, size_t>> tms(a);
+
+			tms.emplace(&root, n >> 1);
+			while(!tms.empty())
+			{
+				auto& top(tms.top());
+
+				if(top.second != 0)
+				{
+					auto& parent(*top.first);
+
+					--top.second;
+					if(!ReadSize(n))
+						return {};
+					if(n & 1)
+					{
+						if(!ReadLeaf(parent, n >> 1, conv,
+							std::integral_constant<bool, _bSourced>()))
+							return {};
+					}
+					else
+					{
+						parent.Add(TermNode(a));
+						// XXX: The subterms are in a list, so the reference is
+						//	kept valid after the insertion.
+						tms.emplace(&parent.GetContainerRef().back(), n >> 1);
+					}
+				}
+				else
+					tms.pop();
+			}
+			return true;
+		}
+		return {};
+	}
+};
+
+
+/*!
+\brief 翻译单元映像的写入器。
+\sa UnitImageReader
+*/
+class UnitImageWriter final
+{
+private:
+	string buffer;
+
+public:
+	UnitImageWriter(string::allocator_type a)
+		: buffer(a)
+	{}
+
+	DefGetter(const ynothrow, const string&, Buffer, buffer)
+
+	void
+	WriteFixed(std::uint64_t val)
+	{
+		buffer.append(reinterpret_cast<const char*>(&val), sizeof(val));
+	}
+
+	void
+	WriteSize(size_t val)
+	{
+		for(; val >= 0x80U; val >>= 7)
+			buffer += char((val & 0x7FU) | 0x80U);
+		buffer += char(val);
+	}
+
+	//! \brief 写入叶节点记录。
+	//@{
+	void
+	WriteLeaf(string_view lexeme)
+	{
+		WriteSize(lexeme.size() << 1 | 1);
+		buffer.append(lexeme.data(), lexeme.size());
+	}
+	void
+	WriteLeaf(const pair<SourceLocation, string_view>& val)
+	{
+		WriteSize(val.second.size() << 1 | 1);
+		WriteSize(val.first.Line);
+		WriteSize(val.first.Column);
+		buffer.append(val.second.data(), val.second.size());
+	}
+	//@}
+
+	/*!
+	\brief 写入分析结果对应的节点记录。
+	\pre 分析结果中的圆括号匹配。
+
+	按 SContext::Reduce 的规则从分析结果确定子节点，以先序遍历写入节点记录。
+	*/
+	template<class _tResult>
+	void
+	WriteTerms(const _tResult& res)
+	{
+		const auto a(buffer.get_allocator());
+		// NOTE: Each element is the number of subterms of a branch, or the
+		//	index of the lexeme in %res for a leaf.
+		vector<pair<bool, size_t>> nodes(a);
+		YSLib::stack<size_t> branches(a);
+
+		nodes.emplace_back(false, 0);
+		branches.push(0);
+		for(size_t i(0); i != res.size(); ++i)
+		{
+			const auto& lexeme(ToLexeme(res[i]));
+
+			if(lexeme == ")")
+			{
+				YAssert(branches.size() > 1, "Invalid parse result found.");
+				branches.pop();
+			}
+			else
+			{
+				++nodes[branches.top()].second;
+				if(lexeme == "(")
+				{
+					branches.push(nodes.size());
+					nodes.emplace_back(false, 0);
+				}
+				else
+					nodes.emplace_back(true, i);
+			}
+		}
+		for(const auto& nd : nodes)
+			if(nd.first)
+				WriteLeaf(res[nd.second]);
+			else
+				WriteSize(nd.second << 1);
+	}
+};
+
+
+/*!
+\brief 读取翻译单元映像。
+\return 是否读取有效的映像。
+
+映射映像文件，检查头部和参数指定的头部一致，并从映射的内容读取节点记录，
+	使用第四参数转换叶节点。
+*/
+template<bool _bSourced, typename _fConv>
+YB_ATTR_nodiscard bool
+ReadUnitImage(const string& path, const UnitImageHeader& header,
+	TermNode& root, _fConv conv)
+{
+	if(YSLib::ufexists(path.c_str()))
+		try
+		{
+			const YSLib::MappedFile img(path);
+			const string_view buf(reinterpret_cast<const char*>(img.GetPtr()),
+				img.GetSize());
+			const string_view magic(UnitImageMagic, sizeof(UnitImageMagic));
+
+			if(ystdex::begins_with(buf, magic))
+			{
+				UnitImageReader reader(buf.substr(magic.size()));
+
+				for(const auto val : header)
+				{
+					std::uint64_t v;
+
+					if(!reader.ReadFixed(v) || v != val)
+						return {};
+				}
+				return reader.ReadTerm<_bSourced>(root, conv)
+					&& reader.IsEmpty();
+			}
+		}
+		// XXX: Any failure makes the image stale and it would be rebuilt.
+		CatchIgnore(std::exception&)
+	return {};
+}
+
+/*!
+\brief 写入翻译单元映像。
+\note 先写入临时文件再替换映像，避免其它进程读取不完整的映像。
+\note 忽略错误。
+*/
+template<class _tResult>
+void
+WriteUnitImage(const string& path, const UnitImageHeader& header,
+	const _tResult& res)
+{
+	const auto tmp(path + YSLib::RandomizeTemplatedString(string(".%%%%%%",
+		path.get_allocator()), '%', "0123456789abcdef"));
+
+	try
+	{
+		UnitImageWriter writer(path.get_allocator());
+
+		for(const auto val : header)
+			writer.WriteFixed(val);
+		writer.WriteTerms(res);
+		{
+			YSLib::ofstream ofs(tmp.c_str(), std::ios_base::out
+				| std::ios_base::binary | std::ios_base::trunc);
+
+			if(!ofs)
+				return;
+
+			const auto& buf(writer.GetBuffer());
+
+			ofs.write(UnitImageMagic, sizeof(UnitImageMagic));
+			ofs.write(buf.data(), std::streamsize(buf.size()));
+			ofs.flush();
+			if(!ofs)
+			{
+				ofs.close();
+				yunused(YSLib::uremove(tmp.c_str()));
+				return;
+			}
+		}
+		if(!YSLib::urename(tmp.c_str(), path.c_str()))
+			yunused(YSLib::uremove(tmp.c_str()));
+	}
+	catch(std::exception&)
+	{
+		yunused(YSLib::uremove(tmp.c_str()));
+	}
+}
+
+/*!
+\brief 从映像或源代码准备规约项。
+\note 映像有效时不读取源代码的内容。
+*/
+template<class _tParser>
+YB_ATTR_nodiscard TermNode
+PrepareUnitWithImage(ContextState& cs, const YSLib::MappedFile& src,
+	string_view unit, const string& path)
+{
+	const auto a(cs.get_allocator());
+	using sourced = std::is_same<_tParser, SourcedViewByteParser>;
+	const auto header(MakeUnitImageHeader(sourced(), src));
+	TermNode term(a);
+
+	if(ReadUnitImage<sourced::value>(path, header, term,
+		GlobalState::LeafConverter{cs}))
+		return term;
+
+	Session sess(a);
+	_tParser parse(sess.Lexer, a);
+
+	yunused(sess.Process(unit, ystdex::ref(parse)));
+	term = cs.Global.get().Prepare(cs, parse.GetResult());
+	// NOTE: The image is written only after the source is successfully
+	//	analyzed, so the parentheses are known balanced.
+	WriteUnitImage(path, header, parse.GetResult());
+	return term;
+}
+
+} // unnamed namespace;
+
+TermNode
+LoadWithUnitImage(ContextState& cs, string filename)
+{
+	YSLib::MappedFile src;
+
+	// NOTE: Empty files are not mapped. Failures are reported by
+	//	%GlobalState::DefaultLoad.
+	TryExpr(src = YSLib::MappedFile(filename))
+	CatchIgnore(std::exception&)
+	if(src && src.GetSize() != 0)
+	{
+		string_view unit(reinterpret_cast<const char*>(src.GetPtr()),
+			src.GetSize());
+		auto path(filename + UnitImageSuffix);
+
+		if(ystdex::begins_with(unit, YSLib::Text::BOM_UTF_8))
+			unit.remove_prefix(sizeof(YSLib::Text::BOM_UTF_8) - 1);
+		cs.CurrentSource = YSLib::share_move(filename);
+		return cs.Global.get().UseSourceLocation
+			? PrepareUnitWithImage<SourcedViewByteParser>(cs, src, unit, path)
+			: PrepareUnitWithImage<ViewByteParser>(cs, src, unit, path);
+	}
+	return GlobalState::DefaultLoad(cs, std::move(filename));
+}
+
 
 void
 PreloadExternal(ContextState& cs, const char* filename)
@@ -287,80 +730,516 @@ RelayToLoadExternal(ContextNode& ctx, TermNode& term)
 		std::ref(term), std::ref(ctx)), "load-external"));
 }
 
-namespace Forms
+//! \since build 955
+namespace
 {
 
-//! \since build 758
-namespace
+//! \brief 混合散列值的位，使对齐的地址等低位相同的值在索引中分散。
+YB_ATTR_nodiscard YB_STATELESS size_t
+MixHash(size_t h) ynothrow
 {
+	h = (h ^ (h >> 16)) * size_t(0x45D9F3BU);
+	return h ^ (h >> 16);
+}
 
-//! \since build 928
-YB_ATTR_nodiscard ReductionStatus
-DoMoveOrTransfer(TermNode& term, void(&f)(TermNode&, TermNode&, bool))
+template<typename _type>
+YB_ATTR_nodiscard bool
+TryHashValue(size_t& seed, const ValueObject& vo)
 {
-	return Forms::CallResolvedUnary(
-		[&](TermNode& nd, ResolvedTermReferencePtr p_ref){
-		// NOTE: Force move. No %IsMovable check is needed.
-		// XXX: Term tags are currently not respected in prvalues.
-		f(term, nd, !p_ref || p_ref->IsModifiable());
-		EnsureValueTags(term.Tags);
-		return ReductionStatus::Retained;
-	}, term);
+	if(const auto p = vo.AccessPtr<_type>())
+	{
+		ystdex::hash_combine(seed, *p);
+		return true;
+	}
+	return {};
 }
 
-//! \since build 914
-YB_ATTR_nodiscard ReductionStatus
-Qualify(TermNode& term, TermTags tag_add)
+YB_ATTR_nodiscard YB_PURE size_t
+HashTermStructure(const TermNode&, size_t);
+
+/*!
+\brief 计算和 ValueObject::Equals 一致的散列值。
+\note 第二参数指定向量元素的散列值被计算时访问子项的深度。
+*/
+YB_ATTR_nodiscard YB_PURE size_t
+HashValue(const ValueObject& vo, size_t depth = yimpl(4))
 {
-	return Forms::CallRawUnary([&](TermNode& tm){
-		if(const auto p = TryAccessLeafAtom<TermReference>(tm))
-			p->AddTags(tag_add);
-		LiftTerm(term, tm);
-		return ReductionStatus::Retained;
-	}, term);
+	size_t seed(vo.type().hash_code());
+
+	// NOTE: Values of other types are only distinguished by their types. This
+	//	is still consistent with %ValueObject::Equals, which never treats values
+	//	of different types equal.
+	if(const auto p = vo.AccessPtr<string>())
+		ystdex::hash_combine(seed, string_view(*p));
+	else if(const auto p_tok = vo.AccessPtr<TokenValue>())
+		ystdex::hash_combine(seed, string_view(*p_tok));
+	else if(const auto p_vt = vo.AccessPtr<ValueToken>())
+		ystdex::hash_combine(seed, size_t(*p_vt));
+	else if(const auto p_b = vo.AccessPtr<BigInt>())
+	{
+		ystdex::hash_combine(seed, p_b->IsNegative());
+		for(const auto l : p_b->GetLimbs())
+			ystdex::hash_combine(seed, l);
+	}
+	else if(const auto p_vec = vo.AccessPtr<TermVector>())
+	{
+		// NOTE: Same to the subterms in %HashTermStructure.
+		const auto n(p_vec->size());
+
+		ystdex::hash_combine(seed, n);
+		if(depth != 0)
+			for(size_t k(0); k != n && k != yimpl(8); ++k)
+				ystdex::hash_combine(seed, HashTermStructure(
+					ReferenceTerm((*p_vec)[k]), depth - 1));
+	}
+	else if(const auto p_bvec = vo.AccessPtr<ByteVector>())
+		ystdex::hash_combine(seed, string_view(
+			reinterpret_cast<const char*>(p_bvec->data()), p_bvec->size()));
+	else
+		yunused(TryHashValue<int>(seed, vo) || TryHashValue<bool>(seed, vo)
+			|| TryHashValue<double>(seed, vo)
+			|| TryHashValue<unsigned>(seed, vo)
+			|| TryHashValue<long long>(seed, vo)
+			|| TryHashValue<unsigned long long>(seed, vo)
+			|| TryHashValue<long>(seed, vo)
+			|| TryHashValue<unsigned long>(seed, vo)
+			|| TryHashValue<float>(seed, vo)
+			|| TryHashValue<long double>(seed, vo)
+			|| TryHashValue<char>(seed, vo));
+	return seed;
 }
 
-//! \since build 794
-//@{
-void
-CopyEnvironmentDFS(Environment& d, const Environment& e)
+/*!
+\brief 计算和 equal? 一致的散列值。
+\note 只访问有限深度和宽度的子项，以限制计算的开销且避免宿主实现的栈溢出。
+*/
+YB_ATTR_nodiscard YB_PURE size_t
+HashTermStructure(const TermNode& nd, size_t depth)
 {
-	auto& m(d.GetMapRef());
-	// TODO: Check environments allocator equality.
-	const auto a(m.get_allocator());
-	const auto copy_parent([&](Environment& dst, const Environment& parent){
-		auto p_env(NPL::AllocateEnvironment(a));
+	size_t seed(HashValue(nd.Value, depth));
+	const auto n(CountPrefix(nd));
 
-		CopyEnvironmentDFS(*p_env, parent);
-		dst.Parent = std::move(p_env);
+	ystdex::hash_combine(seed, n);
+	if(depth != 0)
+	{
+		auto i(nd.begin());
+
+		for(size_t k(0); k != n && k != yimpl(8); ++k)
+			ystdex::hash_combine(seed,
+				HashTermStructure(ReferenceTerm(NPL::Deref(i++)), depth - 1));
+	}
+	return seed;
+}
+
+//! \brief 判断项满足 equal? 的等价关系。
+YB_ATTR_nodiscard YB_PURE bool
+EqualTermStructure(const TermNode& x, const TermNode& y)
+{
+	// XXX: Same to %TermUnequal in %NPLA1Forms.cpp.
+	const auto unequal([](const TermNode& a, const TermNode& b){
+		return CountPrefix(a) != CountPrefix(b) || a.Value != b.Value;
 	});
-	const auto copy_parent_ptr(
-		[&](function<Environment&()> mdst, const ValueObject& vo) -> bool{
-		if(const auto p = AccessPtr<EnvironmentReference>(vo))
-		{
-			if(const auto p_parent = p->Lock())
-				copy_parent(mdst(), *p_parent);
-			// XXX: Failure of locking is ignored.
-			return true;
-		}
-		else if(const auto p_e = AccessPtr<shared_ptr<Environment>>(vo))
-		{
-			if(const auto p_parent = *p_e)
-				copy_parent(mdst(), *p_parent);
-			// XXX: Empty parent is ignored.
-			return true;
-		}
+
+	if(unequal(x, y))
 		return {};
-	});
 
-	copy_parent_ptr([&]() ynothrow -> Environment&{
-		return d;
-	}, e.Parent);
-	for(const auto& b : e.GetMapRef())
-		m.emplace(std::piecewise_construct, NPL::forward_as_tuple(b.first),
-			NPL::forward_as_tuple(b.second.CreateWith(
-			[&](const ValueObject& vo) -> ValueObject{
-			shared_ptr<Environment> p_env;
+	// NOTE: The traversal is not recursive to avoid the host stack overflow
+	//	on deeply nested lists.
+	vector<NPL::tuple<TNCIter, TNCIter, TNCIter>> remained;
+
+	remained.emplace_back(x.begin(), y.begin(), x.end());
+	while(!remained.empty())
+	{
+		auto& cur(remained.back());
+		auto& first1(std::get<0>(cur));
+
+		if(first1 != std::get<2>(cur))
+		{
+			auto& first2(std::get<1>(cur));
+			const auto& sx(ReferenceTerm(NPL::Deref(first1)));
+			const auto& sy(ReferenceTerm(NPL::Deref(first2)));
+
+			if(unequal(sx, sy))
+				return {};
+			yunseq(++first1, ++first2);
+			remained.emplace_back(sx.begin(), sy.begin(), sx.end());
+		}
+		else
+			remained.pop_back();
+	}
+	return true;
+}
+
+} // unnamed namespace;
+
+HashTable::HashTable(Comparison cmp, size_type n, allocator_type a)
+	: comparison(cmp), container(a), index(a)
+{
+	reserve(n);
+}
+HashTable::HashTable(const HashTable& tbl, allocator_type a)
+	: comparison(tbl.comparison), container(tbl.container, a), index(a)
+{
+	Reindex(container.size());
+}
+
+HashTable&
+HashTable::operator=(HashTable&& tbl)
+{
+	if(container.get_allocator() == tbl.container.get_allocator())
+		swap(*this, tbl);
+	else
+	{
+		// XXX: The elements are moved individually, so the positions in the
+		//	index are rebuilt.
+		comparison = tbl.comparison;
+		container.clear();
+		for(auto& e : tbl.container)
+			container.emplace_back(std::move(e));
+		Reindex(container.size());
+	}
+	tbl.clear();
+	return *this;
+}
+
+void
+HashTable::clear() ynothrow
+{
+	container.clear();
+	std::fill(index.begin(), index.end(), Slot());
+}
+
+HashTable::iterator
+HashTable::erase(const_iterator i) ynothrowv
+{
+	YAssert(i != container.cend(), "Invalid iterator found.");
+	YAssert(!index.empty(), "Invalid index found.");
+
+	const size_t mask(index.size() - 1);
+	size_t n(i->Hash & mask);
+
+	while(index[n].Hash == 0 || index[n].Position != i)
+	{
+		YAssert(index[n].Hash != 0, "Invalid index found.");
+		n = (n + 1) & mask;
+	}
+	// NOTE: As %BindingMap::erase, this is the backward shift deletion.
+	for(size_t j(n); ; )
+	{
+		j = (j + 1) & mask;
+		if(index[j].Hash == 0)
+			break;
+
+		const size_t k(index[j].Hash & mask);
+
+		if(n <= j ? k <= n || k > j : k <= n && k > j)
+		{
+			index[n] = index[j];
+			n = j;
+		}
+	}
+	index[n] = Slot();
+	return container.erase(i);
+}
+HashTable::size_type
+HashTable::erase(const TermNode& key)
+{
+	const auto i(find(key));
+
+	if(i != container.end())
+	{
+		erase(i);
+		return 1;
+	}
+	return 0;
+}
+
+HashTable::iterator
+HashTable::find(const TermNode& key)
+{
+	if(!index.empty())
+	{
+		const size_t h(HashKey(key)), mask(index.size() - 1);
+
+		for(size_t n(h & mask); index[n].Hash != 0; n = (n + 1) & mask)
+			if(index[n].Hash == h && KeyEquals(index[n].Position->Key, key))
+				return index[n].Position;
+	}
+	return container.end();
+}
+HashTable::const_iterator
+HashTable::find(const TermNode& key) const
+{
+	return const_cast<HashTable&>(*this).find(key);
+}
+
+pair<HashTable::iterator, bool>
+HashTable::insert_or_assign(TermNode&& key, TermNode&& value)
+{
+	container.emplace_back(std::move(key), std::move(value));
+
+	const auto i(std::prev(container.end()));
+
+	try
+	{
+		// NOTE: The hash value is calculated after the key is stored, because
+		//	it may depend on the identity of the stored key.
+		const size_t h(HashKey(i->Key));
+
+		i->Hash = h;
+		if(!index.empty())
+		{
+			const size_t mask(index.size() - 1);
+			size_t n(h & mask);
+
+			for(; index[n].Hash != 0; n = (n + 1) & mask)
+				if(index[n].Hash == h
+					&& KeyEquals(index[n].Position->Key, i->Key))
+				{
+					const auto j(index[n].Position);
+
+					j->Value = std::move(i->Value);
+					container.erase(i);
+					return {j, false};
+				}
+			if(container.size() * 2 <= index.size())
+			{
+				index[n] = {h, i};
+				return {i, true};
+			}
+		}
+		Reindex(container.size() * 2);
+	}
+	catch(...)
+	{
+		container.erase(i);
+		throw;
+	}
+	return {i, true};
+}
+
+void
+HashTable::reserve(size_type n)
+{
+	if(n * 2 > index.size())
+		Reindex(n);
+}
+
+size_t
+HashTable::HashKey(const TermNode& key) const
+{
+	const auto& nd(ReferenceTerm(key));
+	size_t h;
+
+	switch(comparison)
+	{
+	case Comparison::Eq:
+		h = std::hash<const void*>()(IsAtom(nd) ? nd.Value.GetContent().get()
+			: static_cast<const void*>(&nd));
+		break;
+	case Comparison::Eqv:
+		h = IsAtom(nd) ? HashValue(nd.Value)
+			: std::hash<const void*>()(static_cast<const void*>(&nd));
+		break;
+	default:
+		h = HashTermStructure(nd, yimpl(4));
+	}
+	h = MixHash(h);
+	// NOTE: The value 0 is reserved for empty slots in the index.
+	return h != 0 ? h : 1;
+}
+
+bool
+HashTable::KeyEquals(const TermNode& x, const TermNode& y) const
+{
+	const auto& nx(ReferenceTerm(x));
+	const auto& ny(ReferenceTerm(y));
+
+	// NOTE: Same to %Forms::Eq, %Forms::EqValue and %Forms::EqualTermValue,
+	//	respectively.
+	switch(comparison)
+	{
+	case Comparison::Eq:
+		return IsAtom(nx) && IsAtom(ny) ? YSLib::HoldSame(nx.Value, ny.Value)
+			: ystdex::ref_eq<>()(nx, ny);
+	case Comparison::Eqv:
+		return IsAtom(nx) && IsAtom(ny) ? nx.Value == ny.Value
+			: ystdex::ref_eq<>()(nx, ny);
+	default:
+		return EqualTermStructure(nx, ny);
+	}
+}
+
+void
+HashTable::Reindex(size_t n)
+{
+	size_t m(MinIndexSize);
+
+	while(m < n * 2)
+		m <<= 1;
+
+	vector<Slot> new_index(m, Slot(), index.get_allocator());
+	const size_t mask(m - 1);
+
+	for(auto i(container.begin()); i != container.end(); ++i)
+	{
+		size_t k(i->Hash & mask);
+
+		while(new_index[k].Hash != 0)
+			k = (k + 1) & mask;
+		new_index[k] = {i->Hash, i};
+	}
+	index.swap(new_index);
+}
+
+
+const string&
+StringBuilder::GetString() const
+{
+	if(pieces.size() != 1)
+	{
+		string res(pieces.get_allocator());
+
+		res.reserve(length);
+		for(const auto& s : pieces)
+			res += s;
+		pieces.clear();
+		pieces.push_back(std::move(res));
+	}
+	return pieces.front();
+}
+
+void
+StringBuilder::Append(string&& str)
+{
+	if(!str.empty())
+	{
+		length += str.length();
+		// NOTE: Short pieces are merged to reduce the allocations.
+		if(!pieces.empty() && pieces.back().length() < yimpl(256))
+			pieces.back() += str;
+		else
+			pieces.push_back(std::move(str));
+	}
+}
+void
+StringBuilder::Append(string_view sv)
+{
+	if(!sv.empty())
+	{
+		length += sv.size();
+		if(!pieces.empty() && pieces.back().length() < yimpl(256))
+			pieces.back().append(sv.data(), sv.size());
+		else
+			pieces.emplace_back(sv.data(), sv.size());
+	}
+}
+
+void
+StringBuilder::clear() ynothrow
+{
+	pieces.clear();
+	length = 0;
+}
+
+
+RegexCache::RegexCache(size_t n)
+	: cache(n)
+{
+	cache.flush = [this](decltype(cache)::value_type&) ynothrow{
+		++statistics.Evictions;
+	};
+}
+
+const std::regex&
+RegexCache::Get(const string& pat)
+{
+	const auto i(cache.find(pat));
+
+	if(i != cache.end())
+	{
+		++statistics.Hits;
+		return i->second;
+	}
+	++statistics.Misses;
+	return cache.emplace(pat, pat).first->second;
+}
+
+void
+RegexCache::SetCapacity(size_t n)
+{
+	cache.set_max_use(n);
+}
+
+namespace Forms
+{
+
+//! \since build 758
+namespace
+{
+
+//! \since build 928
+YB_ATTR_nodiscard ReductionStatus
+DoMoveOrTransfer(TermNode& term, void(&f)(TermNode&, TermNode&, bool))
+{
+	return Forms::CallResolvedUnary(
+		[&](TermNode& nd, ResolvedTermReferencePtr p_ref){
+		// NOTE: Force move. No %IsMovable check is needed.
+		// XXX: Term tags are currently not respected in prvalues.
+		f(term, nd, !p_ref || p_ref->IsModifiable());
+		EnsureValueTags(term.Tags);
+		return ReductionStatus::Retained;
+	}, term);
+}
+
+//! \since build 914
+YB_ATTR_nodiscard ReductionStatus
+Qualify(TermNode& term, TermTags tag_add)
+{
+	return Forms::CallRawUnary([&](TermNode& tm){
+		if(const auto p = TryAccessLeafAtom<TermReference>(tm))
+			p->AddTags(tag_add);
+		LiftTerm(term, tm);
+		return ReductionStatus::Retained;
+	}, term);
+}
+
+//! \since build 794
+//@{
+void
+CopyEnvironmentDFS(Environment& d, const Environment& e)
+{
+	auto& m(d.GetMapRef());
+	// TODO: Check environments allocator equality.
+	const auto a(m.get_allocator());
+	const auto copy_parent([&](Environment& dst, const Environment& parent){
+		auto p_env(NPL::AllocateEnvironment(a));
+
+		CopyEnvironmentDFS(*p_env, parent);
+		dst.Parent = std::move(p_env);
+	});
+	const auto copy_parent_ptr(
+		[&](function<Environment&()> mdst, const ValueObject& vo) -> bool{
+		if(const auto p = AccessPtr<EnvironmentReference>(vo))
+		{
+			if(const auto p_parent = p->Lock())
+				copy_parent(mdst(), *p_parent);
+			// XXX: Failure of locking is ignored.
+			return true;
+		}
+		else if(const auto p_e = AccessPtr<shared_ptr<Environment>>(vo))
+		{
+			if(const auto p_parent = *p_e)
+				copy_parent(mdst(), *p_parent);
+			// XXX: Empty parent is ignored.
+			return true;
+		}
+		return {};
+	});
+
+	const auto copy_sub([&](const TermNode& nd){
+		return nd.CreateWith([&](const ValueObject& vo) -> ValueObject{
+			shared_ptr<Environment> p_env;
 
 			if(copy_parent_ptr([&]() ynothrow -> Environment&{
 				p_env = NPL::AllocateEnvironment(a);
@@ -368,7 +1247,31 @@ CopyEnvironmentDFS(Environment& d, const Environment& e)
 			}, vo))
 				return ValueObject(std::move(p_env));
 			return vo;
-		}), b.second.Value));
+		});
+	});
+
+	copy_parent_ptr([&]() ynothrow -> Environment&{
+		return d;
+	}, e.Parent);
+	if(e.Frozen)
+	{
+		// NOTE: The bindings of the frozen environment are shared as the base
+		//	map. Since a leaf without tags would be copied as is, only other
+		//	bindings are copied here, and the remained ones are copied on
+		//	demand.
+		const auto p_shared(e.ShareBindings());
+
+		m = Environment::BindingMap(p_shared, a);
+		for(const auto& b : *p_shared)
+			if(!IsLeaf(b.second) || b.second.Tags != TermTags::Unqualified)
+				ystdex::insert_or_assign(m, b.first,
+					TermNode(copy_sub(b.second), b.second.Value));
+	}
+	else
+		for(const auto& b : e.GetMapRef())
+			m.emplace(std::piecewise_construct,
+				NPL::forward_as_tuple(b.first),
+				NPL::forward_as_tuple(copy_sub(b.second), b.second.Value));
 }
 
 void
@@ -674,7 +1577,7 @@ LoadEnvironments(ContextNode& ctx)
 		return r_env.Lock();
 	});
 	RegisterUnary(ctx, "freeze-environment!", [](TermNode& x){
-		Environment::EnsureValid(ResolveEnvironment(x).first).Frozen = true;
+		Environment::EnsureValid(ResolveEnvironment(x).first).Freeze();
 		return ValueToken::Unspecified;
 	});
 	RegisterStrict(ctx, "make-environment", MakeEnvironment);
@@ -1472,7 +2375,7 @@ Load(ContextState& cs)
 	Primitive::Load(cs);
 	Derived::Load(cs);
 	// NOTE: Prevent the ground environment from modification.
-	renv.Frozen = true;
+	renv.Freeze();
 }
 
 } // namespace Ground;
@@ -1745,42 +2648,589 @@ ReduceToLoadGuarded(TermNode& term, ContextNode& ctx,
 }
 #endif
 
-
 /*!
-\ingroup functors
-\since build 930
+\brief 串接迭代器范围中的项表示的字符串，以第三参数分隔。
+\since build 955
+
+预先计算结果的长度，一次分配结果的存储，避免逐次串接的重复复制。
 */
-struct LeafPred
+template<typename _tIn>
+YB_ATTR_nodiscard string
+JoinStrings(_tIn first, _tIn last, string_view sep, string::allocator_type a)
 {
-	template<typename _func>
-	YB_ATTR_nodiscard YB_PURE bool
-	operator()(const TermNode& nd, _func f) const ynoexcept_spec(f(nd.Value))
+	const auto access([](TermNode& nd) -> const string&{
+		return NPL::ResolveRegular<const string>(nd);
+	});
+	size_t len(0);
+
+	for(auto i(first); i != last; ++i)
+		len += access(NPL::Deref(i)).length() + (i != first ? sep.size() : 0);
+
+	string res(a);
+
+	res.reserve(len);
+	for(auto i(first); i != last; ++i)
 	{
-		return IsLeaf(nd) && f(nd.Value);
+		if(i != first)
+			res.append(sep.data(), sep.size());
+		res += access(NPL::Deref(i));
 	}
-};
+	return res;
+}
 
-} // unnamed namespace;
+//! \since build 955
+//@{
+//! \brief 判断模式串是否不含 ECMAScript 正则表达式的特殊字符而只匹配字面量。
+YB_ATTR_nodiscard YB_PURE bool
+IsLiteralPattern(string_view pat) ynothrow
+{
+	return !pat.empty()
+		&& pat.find_first_of("\\^$.|?*+()[]{}") == string_view::npos;
+}
 
-void
-LoadGroundContext(ContextState& cs)
+/*!
+\brief 以项表示的正则表达式或模式串调用处理器。
+\note 模式串使用全局状态中的正则表达式缓存编译；若不存在缓存，则直接编译。
+*/
+template<typename _func>
+auto
+CallWithRegex(TermNode& nd, ContextNode& ctx, _func f)
+	-> decltype(f(std::declval<const std::regex&>()))
 {
-	// NOTE: Dynamic separator handling is lifted to %GlobalState::Preprocess.
-	//	See $2020-02 @ %Documentation::Workflow.
-	Ground::Load(cs);
+	if(IsTypedRegular<string>(ReferenceTerm(nd)))
+	{
+		const auto& pat(NPL::ResolveRegular<const string>(nd));
+
+		if(const auto p_cache
+			= ContextState::Access(ctx).Global.get().RegexCachePtr)
+			return f(p_cache->Get(pat));
+		return f(std::regex(pat));
+	}
+	return f(NPL::ResolveRegular<const std::regex>(nd));
 }
 
-void
-LoadModule_std_continuations(ContextState& cs)
+//! \brief 替换字符串中所有不重叠的非空字面量模式串。
+YB_ATTR_nodiscard string
+ReplaceLiteral(const string& str, string_view pat, string_view fmt)
 {
-	auto& renv(cs.GetRecordRef());
+	YAssert(!pat.empty(), "Invalid pattern found.");
 
-	RegisterStrict(renv, "call/1cc", Call1CC);
-	RegisterStrict(renv, "continuation->applicative",
-		ContinuationToApplicative);
-#if NPL_Impl_NPLA1_Native_Forms
-	RegisterStrict(renv, "apply-continuation", ApplyContinuation);
-#else
+	string res(str.get_allocator());
+	size_t pos(0);
+
+	for(size_t n; (n = str.find(pat.data(), pos, pat.size())) != string::npos;
+		pos = n + pat.size())
+	{
+		res.append(str, pos, n - pos);
+		res.append(fmt.data(), fmt.size());
+	}
+	res.append(str, pos, string::npos);
+	return res;
+}
+//@}
+
+
+//! \since build 955
+//@{
+YB_ATTR_nodiscard size_t
+CheckIndexValue(unsigned long long i)
+{
+	if(size_t(i) == i)
+		return size_t(i);
+	throw std::out_of_range("Index value too large found.");
+}
+YB_ATTR_nodiscard size_t
+CheckIndexValue(long long i)
+{
+	if(i >= 0)
+		return CheckIndexValue(static_cast<unsigned long long>(i));
+	throw std::out_of_range("Negative index value found.");
+}
+
+template<typename _type>
+YB_ATTR_nodiscard bool
+TryFetchIndexValue(size_t& res, const ValueObject& x)
+{
+	if(const auto p = x.AccessPtr<_type>())
+	{
+		res = CheckIndexValue(ystdex::cond_t<std::is_signed<_type>, long long,
+			unsigned long long>(*p));
+		return true;
+	}
+	return {};
+}
+
+//! \throw TypeError 参数不是精确整数。
+YB_ATTR_nodiscard size_t
+FetchIndexValue(TermNode& nd)
+{
+	const auto& x(NPL::AccessTypedValue<NumberLeaf>(nd));
+	size_t res;
+
+	// NOTE: The most common types are tested first.
+	if(TryFetchIndexValue<int>(res, x) || TryFetchIndexValue<unsigned>(res, x)
+		|| TryFetchIndexValue<long long>(res, x)
+		|| TryFetchIndexValue<unsigned long long>(res, x)
+		|| TryFetchIndexValue<long>(res, x)
+		|| TryFetchIndexValue<unsigned long>(res, x)
+		|| TryFetchIndexValue<short>(res, x)
+		|| TryFetchIndexValue<unsigned short>(res, x)
+		|| TryFetchIndexValue<signed char>(res, x)
+		|| TryFetchIndexValue<unsigned char>(res, x))
+		return res;
+	// NOTE: Bignums are never representable as the index of the host vector.
+	if(IsExactValue(x))
+		throw std::out_of_range("Index value too large found.");
+	throw TypeError("Exact integer expected for the index.");
+}
+
+YB_ATTR_nodiscard byte
+FetchByteValue(TermNode& nd)
+{
+	const auto i(FetchIndexValue(nd));
+
+	if(i < 0x100)
+		return byte(i);
+	throw std::out_of_range("Byte value out of range found.");
+}
+
+YB_ATTR_nodiscard size_t
+CheckElementIndex(size_t i, size_t n)
+{
+	if(i < n)
+		return i;
+	throw std::out_of_range("Element index out of range found.");
+}
+
+/*!
+\brief 检查项的参数个数在闭区间内。
+\return 项的参数个数。
+\throw ArityMismatch 项的参数个数不在第二参数和第三参数指定的闭区间内。
+*/
+size_t
+RetainRange(const TermNode& term, size_t m, size_t n)
+{
+	const auto k(FetchArgumentN(term));
+
+	if(m <= k && k <= n)
+		return k;
+	throw ArityMismatch(k < m ? m : n, k);
+}
+
+/*!
+\brief 取可选的起始和终止参数指定的区间。
+\throw std::out_of_range 区间无效。
+
+从第一参数指定的迭代器开始读取可选的起始和终止索引，默认为 0 和第三参数。
+*/
+YB_ATTR_nodiscard pair<size_t, size_t>
+FetchRange(TNIter i, TNIter e, size_t n)
+{
+	const auto start(i != e ? FetchIndexValue(NPL::Deref(i++)) : 0);
+	const auto end(i != e ? FetchIndexValue(NPL::Deref(i)) : n);
+
+	if(start <= end && end <= n)
+		return {start, end};
+	throw std::out_of_range("Invalid element range found.");
+}
+
+//! \brief 以第二参数指定的项作为返回值设置第一参数指定的向量元素。
+void
+LiftElement(TermNode& dst, TermNode& src, bool move)
+{
+	// XXX: Lifting %src before moving avoids aliasing when %src is a reference
+	//	to the vector containing %dst.
+	if(move)
+	{
+		LiftToReturn(src);
+		LiftOther(dst, src);
+	}
+	else
+	{
+		dst.SetContent(src);
+		LiftToReturn(dst);
+	}
+	EnsureValueTags(dst.Tags);
+}
+
+/*!
+\note 长度使用精确整数表示，可直接参与 NPLA 数值操作。
+\note 同 NPLAMath 的规范化，依次尝试 int 和 long long ，否则使用 BigInt 。
+*/
+YB_ATTR_nodiscard ReductionStatus
+ReduceToLength(TermNode& term, size_t n)
+{
+	if(n <= size_t(std::numeric_limits<int>::max()))
+		return EmplaceCallResultOrReturn(term, int(n));
+	if(n <= static_cast<unsigned long long>(
+		std::numeric_limits<long long>::max()))
+		return EmplaceCallResultOrReturn(term, static_cast<long long>(n));
+	return EmplaceCallResultOrReturn(term, BigInt(n, term.get_allocator()));
+}
+
+/*!
+\brief 按散列表的比较方式准备保存的键。
+
+对 equal? 比较的键和 eqv? 比较的非列表键，提升键为值以保存副本；
+否则，保留键中的引用值，以保持被引用对象的同一性。
+*/
+void
+PrepareHashTableKey(TermNode& key, HashTable::Comparison cmp)
+{
+	if(cmp == HashTable::Comparison::Equal
+		|| (cmp == HashTable::Comparison::Eqv && IsAtom(ReferenceTerm(key))))
+		LiftToReturn(key);
+	EnsureValueTags(key.Tags);
+}
+
+//! \brief 复制向量区间：支持重叠的区间。
+template<typename _type>
+void
+CopyElements(const _type* first, const _type* last, _type* dst)
+{
+	const std::less<const _type*> lt{};
+
+	if(lt(first, dst) && lt(dst, last))
+		std::copy_backward(first, last, dst + (last - first));
+	else
+		std::copy(first, last, dst);
+}
+//@}
+
+
+/*!
+\ingroup functors
+\since build 930
+*/
+struct LeafPred
+{
+	template<typename _func>
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const TermNode& nd, _func f) const ynoexcept_spec(f(nd.Value))
+	{
+		return IsLeaf(nd) && f(nd.Value);
+	}
+};
+
+#if YF_Multithread == 1
+//! \since build 955
+//@{
+//! \brief 取线程间传递的项使用的分配器：使用线程安全的资源。
+YB_ATTR_nodiscard YB_PURE inline
+	PDefH(TermNode::allocator_type, FetchTransferAllocator, ) ynothrow
+	ImplRet(TermNode::allocator_type(pmr::new_delete_resource()))
+
+template<typename _type>
+YB_ATTR_nodiscard bool
+TryCopyTransferableValue(TermNode& dst, const ValueObject& vo)
+{
+	if(const auto p = vo.AccessPtr<_type>())
+	{
+		dst.Value = *p;
+		return true;
+	}
+	return {};
+}
+
+/*!
+\brief 通道：在线程之间传递值的队列。
+\note 通道对象被复制时共享队列。
+*/
+class Channel final
+{
+private:
+	struct State final
+	{
+		std::mutex Mutex{};
+		std::condition_variable Condition{};
+		YSLib::deque<TermNode> Queue{FetchTransferAllocator()};
+		bool Closed = {};
+	};
+
+	shared_ptr<State> p_state{YSLib::make_shared<State>()};
+
+public:
+	//! \brief 关闭通道：之后不能发送值，接收已发送的值后不再等待。
+	void
+	Close()
+	{
+		{
+			std::lock_guard<std::mutex> lck(p_state->Mutex);
+
+			p_state->Closed = true;
+		}
+		p_state->Condition.notify_all();
+	}
+
+	/*!
+	\brief 接收值：等待直至通道中存在值或通道被关闭。
+	\return 是否接收到值。
+	*/
+	YB_ATTR_nodiscard bool
+	Receive(TermNode& res)
+	{
+		std::unique_lock<std::mutex> lck(p_state->Mutex);
+		auto& q(p_state->Queue);
+
+		p_state->Condition.wait(lck, [&]() ynothrow{
+			return !q.empty() || p_state->Closed;
+		});
+		if(!q.empty())
+		{
+			res = std::move(q.front());
+			q.pop_front();
+			return true;
+		}
+		return {};
+	}
+
+	/*!
+	\brief 发送值。
+	\pre 参数使用 FetchTransferAllocator 的结果作为分配器。
+	\throw NPLException 通道已被关闭。
+	*/
+	void
+	Send(TermNode&& nd)
+	{
+		{
+			std::lock_guard<std::mutex> lck(p_state->Mutex);
+
+			if(p_state->Closed)
+				throw NPLException("Sending to a closed channel.");
+			p_state->Queue.push_back(std::move(nd));
+		}
+		p_state->Condition.notify_one();
+	}
+};
+
+/*!
+\brief 复制可在线程之间传递的值到使用第一参数的分配器的项中。
+\throw TypeError 值不能在线程之间传递。
+
+可传递的值包括列表、符号、字符串、布尔值、单元值（如 #inert ）、数值和通道。
+引用值被解析为被引用对象；结果不包含引用值。
+不复制名称解析缓存等元数据，以避免线程之间共享可修改的状态。
+*/
+void
+CopyTransferable(TermNode& dst, const TermNode& src)
+{
+	const auto& nd(ReferenceTerm(src));
+	const auto a(dst.get_allocator());
+
+	for(const auto& sub : nd)
+		CopyTransferable(*dst.emplace(), sub);
+
+	const auto& vo(nd.Value);
+
+	if(!vo)
+		return;
+	if(const auto p = vo.AccessPtr<TokenValue>())
+		dst.SetValue(in_place_type<TokenValue>, *p, a);
+	else if(const auto p_str = vo.AccessPtr<string>())
+		dst.SetValue(in_place_type<string>, *p_str, a);
+	else if(const auto p_bigint = vo.AccessPtr<BigInt>())
+		dst.SetValue(in_place_type<BigInt>, *p_bigint, a);
+	// NOTE: The most common types are tested first.
+	else if(!(TryCopyTransferableValue<int>(dst, vo)
+		|| TryCopyTransferableValue<bool>(dst, vo)
+		|| TryCopyTransferableValue<ValueToken>(dst, vo)
+		|| TryCopyTransferableValue<double>(dst, vo)
+		|| TryCopyTransferableValue<long long>(dst, vo)
+		|| TryCopyTransferableValue<unsigned>(dst, vo)
+		|| TryCopyTransferableValue<unsigned long long>(dst, vo)
+		|| TryCopyTransferableValue<long>(dst, vo)
+		|| TryCopyTransferableValue<unsigned long>(dst, vo)
+		|| TryCopyTransferableValue<short>(dst, vo)
+		|| TryCopyTransferableValue<unsigned short>(dst, vo)
+		|| TryCopyTransferableValue<signed char>(dst, vo)
+		|| TryCopyTransferableValue<unsigned char>(dst, vo)
+		|| TryCopyTransferableValue<float>(dst, vo)
+		|| TryCopyTransferableValue<long double>(dst, vo)
+		|| TryCopyTransferableValue<Channel>(dst, vo)))
+		ThrowTypeErrorForInvalidType("transferable object", nd,
+			IsTyped<TermReference>(src));
+}
+
+//! \brief 线程任务句柄：保存线程任务的结果。
+struct ThreadHandle final
+{
+	std::shared_future<TermNode> Result;
+};
+
+/*!
+\brief 导入标准库模块：切换到导入标准库模块中的绑定的新环境。
+\pre 当前环境是已加载标准上下文的根环境。
+
+新环境以根环境为父环境，导入根环境中名称以 std. 起始的模块中的绑定，之后被冻结。
+名称冲突时，保留先导入的绑定。
+*/
+void
+ImportStandardModules(ContextState& cs)
+{
+	auto p_ground(cs.ShareRecord());
+	const string_view pfx("std.");
+
+	yunused(NPL::SwitchToFreshEnvironment(cs, ValueObject(p_ground)));
+
+	auto& env(cs.GetRecordRef());
+	auto& m(env.GetMapRef());
+
+	for(const auto& b : p_ground->GetMapRef())
+		if(ystdex::begins_with(b.first, pfx))
+			if(const auto p_mod
+				= b.second.Value.AccessPtr<shared_ptr<Environment>>())
+				if(*p_mod)
+					for(const auto& mb : (*p_mod)->GetMapRef())
+						m.emplace(std::piecewise_construct,
+							NPL::forward_as_tuple(mb.first),
+							NPL::forward_as_tuple(mb.second));
+	env.Freeze();
+}
+
+/*!
+\brief 工作线程的求值状态。
+
+每个工作线程具有独立的全局状态和上下文状态，使用独立的内存资源。
+初始化时加载标准上下文，并以 ImportStandardModules 导入标准库模块。
+*/
+struct ThreadWorker final
+{
+	pmr::pool_resource Resource{};
+	GlobalState Global{Resource};
+	ContextState Context{Global};
+
+	ThreadWorker(observer_ptr<std::ostream> p_out, YSLib::Logger::Level lv)
+	{
+		Global.OutputStreamPtr = p_out;
+		Context.Trace.FilterLevel = lv;
+		LoadStandardContext(Context);
+		// NOTE: The environments of the caller are not shared with the worker,
+		//	so the bindings in the library modules are imported instead.
+		ImportStandardModules(Context);
+	}
+};
+
+//! \brief 当前线程的工作线程状态：仅在线程池的工作线程中非空。
+ythread ThreadWorker* p_thread_worker;
+
+/*!
+\brief 在当前工作线程中求值线程任务。
+\pre 参数使用 FetchTransferAllocator 的结果作为分配器。
+\return 使用 FetchTransferAllocator 的结果作为分配器的求值结果。
+\throw NPLException 工作线程未被初始化或求值失败。
+
+在以工作线程的初始环境为父环境的新环境中求值参数的副本。
+求值时抛出的异常被转换为 NPLException ，以避免在其它线程中释放工作线程分配的资源。
+*/
+YB_ATTR_nodiscard TermNode
+RunThreadTask(const TermNode& expr)
+{
+	if(!p_thread_worker)
+		throw NPLException("No initialized thread worker found.");
+	try
+	{
+		auto& cs(p_thread_worker->Context);
+		TermNode term(cs.get_allocator());
+
+		CopyTransferable(term, expr);
+
+		auto p_saved(NPL::SwitchToFreshEnvironment(cs,
+			ValueObject(cs.ShareRecord())));
+		const auto gd(ystdex::make_guard([&]() ynothrow{
+			cs.SwitchEnvironmentUnchecked(std::move(p_saved));
+		}));
+		TermNode res(FetchTransferAllocator());
+
+		Reduce(term, cs);
+		CopyTransferable(res, term);
+		return res;
+	}
+	catch(std::exception& e)
+	{
+		throw NPLException(e.what());
+	}
+}
+
+/*!
+\brief 线程模块状态：按需创建线程池。
+\warning 非线程安全：只被加载模块的上下文所在的线程使用。
+*/
+class ThreadModuleState final
+{
+private:
+	YSLib::unique_ptr<ystdex::task_pool> p_pool{};
+
+public:
+	/*!
+	\brief 在线程池中运行线程任务。
+	\pre 第二参数使用 FetchTransferAllocator 的结果作为分配器。
+	\note 线程池中的任务数达到上限时阻塞等待。
+
+	第一次调用时创建线程池，工作线程数是宿主支持的并发线程数。
+	工作线程的输出流和跟踪日志的过滤级别和第一参数一致。
+	*/
+	YB_ATTR_nodiscard std::future<TermNode>
+	Spawn(const ContextState& cs, TermNode&& expr)
+	{
+		if(!p_pool)
+		{
+			const auto p_out(cs.Global.get().OutputStreamPtr);
+			const auto lv(cs.Trace.FilterLevel);
+
+			// XXX: The exceptions from the initialization are not propagated
+			//	out of the worker thread. They are only reported, and the
+			//	tasks run in the worker would fail.
+			p_pool = YSLib::make_unique<ystdex::task_pool>(
+				std::max(std::thread::hardware_concurrency(), 1U), [=]{
+				TryExpr(p_thread_worker
+					= YSLib::make_unique<ThreadWorker>(p_out, lv).release())
+				CatchExpr(std::exception& e, YTraceDe(YSLib::Err,
+					"Failed initializing the thread worker: %s.", e.what()))
+			}, []() ynothrow{
+				const YSLib::unique_ptr<ThreadWorker> p(p_thread_worker);
+
+				p_thread_worker = {};
+			});
+		}
+		const auto p_expr(YSLib::share_move(expr));
+
+		return p_pool->wait([p_expr]{
+			return RunThreadTask(*p_expr);
+		});
+	}
+};
+
+//! \brief 取线程任务的结果到项中。
+void
+FetchThreadResult(TermNode& res, const std::shared_future<TermNode>& fut)
+{
+	CopyTransferable(res, fut.get());
+}
+//@}
+#endif
+
+} // unnamed namespace;
+
+void
+LoadGroundContext(ContextState& cs)
+{
+	// NOTE: Dynamic separator handling is lifted to %GlobalState::Preprocess.
+	//	See $2020-02 @ %Documentation::Workflow.
+	Ground::Load(cs);
+	MarkPureCombiners(cs, {"list"});
+}
+
+void
+LoadModule_std_continuations(ContextState& cs)
+{
+	auto& renv(cs.GetRecordRef());
+
+	RegisterStrict(renv, "call/1cc", Call1CC);
+	RegisterStrict(renv, "continuation->applicative",
+		ContinuationToApplicative);
+#if NPL_Impl_NPLA1_Native_Forms
+	RegisterStrict(renv, "apply-continuation", ApplyContinuation);
+#else
 	cs.ShareCurrentSource("<lib:std.continuations>");
 	A1::Perform(cs, R"NPL(
 $defl! apply-continuation (&k &arg)
@@ -1896,8 +3346,8 @@ LoadModule_std_math(ContextState& cs)
 		ComposeReferencedTermOp(ystdex::bind1(LeafPred(), IsRationalValue)));
 	RegisterUnary(renv, "integer?", trivial_swap,
 		ComposeReferencedTermOp(ystdex::bind1(LeafPred(), IsIntegerValue)));
-	// NOTE: Currently all exact numbers are integers. This should actually be
-	//	the union of fixnum and bignum.
+	// NOTE: Currently all exact numbers are integers, i.e. the union of fixnum
+	//	and bignum.
 	RegisterUnary(renv, "exact-integer?", trivial_swap,
 		ComposeReferencedTermOp(ystdex::bind1(LeafPred(), IsExactValue)));
 	RegisterUnary(renv, "fixnum?", trivial_swap,
@@ -1946,104 +3396,699 @@ LoadModule_std_math(ContextState& cs)
 	RegisterBinary<Strict, NumberNode, NumberNode>(renv, "truncate-remainder",
 		TruncateRemainder);
 	RegisterUnary<Strict, NumberNode>(renv, "inexact", Inexact);
+	// NOTE: The numeric operations are pure. The predicates are not marked
+	//	since they are rarely called with literals.
+	MarkPureCombiners(cs, {"=?", "<?", ">?", "<=?", ">=?", "max", "min",
+		"add1", "+", "sub1", "-", "*", "/", "abs", "floor/", "floor-quotient",
+		"floor-remainder", "truncate/", "truncate-quotient",
+		"truncate-remainder", "inexact"});
+}
+
+void
+LoadModule_std_strings(ContextState& cs)
+{
+	auto& renv(cs.GetRecordRef());
+	auto& global(cs.Global.get());
+
+	if(!global.RegexCachePtr)
+		global.RegexCachePtr = YSLib::allocate_shared<RegexCache>(
+			global.Allocator);
+
+	RegisterUnary(renv, "string?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<string>(ReferenceTerm(x));
+	});
+	RegisterStrict(renv, "++", [](TermNode& term){
+		// NOTE: The one-pass concatenation avoids the repeated copying of the
+		//	accumulated result in the fold when there are more than 2 operands.
+		if(FetchArgumentN(term) > 2)
+			return EmplaceCallResultOrReturn(term, JoinStrings(
+				std::next(term.begin()), term.end(), {}, term.get_allocator()));
+		return CallBinaryFold<string, ystdex::plus<>>(ystdex::plus<>(),
+			string(), term);
+	});
+	RegisterStrict(renv, "string-join", [](TermNode& term){
+		const auto n(RetainRange(term, 1, 2));
+		auto i(term.begin());
+		auto& l(NPL::Deref(++i));
+		const string_view sep(n == 2
+			? string_view(NPL::ResolveRegular<const string>(NPL::Deref(++i)))
+			: string_view(" "));
+
+		return ResolveTerm([&](TermNode& nd, ResolvedTermReferencePtr p_ref)
+			-> ReductionStatus{
+			if(IsList(nd))
+				return EmplaceCallResultOrReturn(term, JoinStrings(nd.begin(),
+					nd.end(), sep, term.get_allocator()));
+			ThrowListTypeErrorForNonList(nd, p_ref);
+		}, l);
+	});
+	RegisterUnary(renv, "string-builder?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<StringBuilder>(ReferenceTerm(x));
+	});
+	RegisterStrict(renv, "make-string-builder", [](TermNode& term){
+		RetainList(term);
+
+		StringBuilder sb(term.get_allocator());
+
+		for(auto i(std::next(term.begin())); i != term.end(); ++i)
+			sb.Append(NPL::ResolveRegular<const string>(NPL::Deref(i)));
+		return EmplaceCallResultOrReturn(term, std::move(sb));
+	});
+	RegisterStrict(renv, "string-builder-append!", [](TermNode& term){
+		CheckVariadicArity(term, 0);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<StringBuilder>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+			while(++i != term.end())
+			{
+				auto y(NPL::AccessTypedValue<ResolvedArg<string>>(
+					NPL::Deref(i)));
+
+				if(y.IsMovable())
+					x.get().Append(std::move(y.get()));
+				else
+					x.get().Append(y.get());
+			}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "string-builder-length", [](TermNode& term){
+		return CallUnaryAs<const StringBuilder>([&](const StringBuilder& sb){
+			return ReduceToLength(term, sb.GetLength());
+		}, term);
+	});
+	RegisterUnary<Strict, const StringBuilder>(renv, "string-builder->string",
+		[](const StringBuilder& sb){
+		return sb.GetString();
+	});
+	RegisterUnary<Strict, const string>(renv, "string-empty?",
+		[](const string& str) ynothrow{
+		return str.empty();
+	});
+	RegisterBinary<Strict, ResolvedArg<>, ResolvedArg<>>(renv, "string<-",
+		[](ResolvedArg<>&& x, ResolvedArg<>&& y){
+		if(x.IsModifiable())
+		{
+			auto& str_x(AccessRegular<string>(x.get(), x.second));
+			auto& str_y(AccessRegular<string>(y.get(), y.second));
+
+			if(y.IsMovable())
+				str_x = std::move(str_y);
+			else
+				str_x = str_y;
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ValueToken::Unspecified;
+	});
+	RegisterStrict(renv, "string-split", [](TermNode& term){
+		return CallBinaryAs<string, const string>(
+			[&](string& x, const string& y) -> ReductionStatus{
+			if(!x.empty())
+			{
+				TermNode::Container con(term.get_allocator());
+				const auto len(y.length());
+
+				if(len != 0)
+				{
+					string::size_type pos(0), orig(0);
+
+					while((pos = x.find(y, pos)) != string::npos)
+					{
+						TermNode::AddValueTo(con, x.substr(orig, pos - orig));
+						orig = (pos += len);
+					}
+					TermNode::AddValueTo(con, x.substr(orig, pos - orig));
+				}
+				else
+					TermNode::AddValueTo(con, std::move(x));
+				con.swap(term.GetContainerRef());
+				return ReductionStatus::Retained;
+			}
+			return ReductionStatus::Clean;
+		}, term);
+	});
+	RegisterBinary<Strict, string, string>(renv, "string-contains-ci?",
+		[](string x, string y){
+		// TODO: Extract 'strlwr'.
+		const auto to_lwr([](string& str) ynothrow{
+			for(auto& c : str)
+				c = ystdex::tolower(c);
+		});
+
+		to_lwr(x),
+		to_lwr(y);
+		return x.find(y) != string::npos;
+	});
+	RegisterUnary<Strict, ResolvedArg<string>>(renv, "string->symbol",
+		[](ResolvedArg<string>&& x){
+		return x.IsMovable() ? StringToSymbol(std::move(x.first))
+			: StringToSymbol(x.first);
+	});
+	RegisterUnary<Strict, const TokenValue>(renv, "symbol->string",
+		SymbolToString);
+	RegisterUnary<Strict, const string>(renv, "string->regex",
+		[](const string& str, ContextNode& ctx){
+		if(const auto p_cache
+			= ContextState::Access(ctx).Global.get().RegexCachePtr)
+			return std::regex(p_cache->Get(str));
+		return std::regex(str);
+	});
+	RegisterStrict(renv, "regex-match?", [](TermNode& term, ContextNode& ctx){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		const auto& str(NPL::ResolveRegular<const string>(NPL::Deref(++i)));
+		auto& nd(NPL::Deref(++i));
+
+		// NOTE: Literal patterns match only the equal strings, so no regular
+		//	expression is needed.
+		if(IsTypedRegular<string>(ReferenceTerm(nd)))
+		{
+			const auto& pat(NPL::ResolveRegular<const string>(nd));
+
+			if(IsLiteralPattern(pat))
+				return EmplaceCallResultOrReturn(term, str == pat);
+		}
+		return EmplaceCallResultOrReturn(term, CallWithRegex(nd, ctx,
+			[&](const std::regex& re){
+			return std::regex_match(str, re);
+		}));
+	});
+	RegisterStrict(renv, "regex-replace", [](TermNode& term, ContextNode& ctx){
+		RetainN(term, 3);
+
+		auto i(term.begin());
+		const auto& str(NPL::ResolveRegular<const string>(NPL::Deref(++i)));
+		auto& nd(NPL::Deref(++i));
+		const auto&
+			fmt(NPL::ResolveRegular<const string>(NPL::Deref(++i)));
+
+		// NOTE: The format string without '$' has no escape sequences, so it
+		//	can be used verbatim with a literal pattern.
+		if(IsTypedRegular<string>(ReferenceTerm(nd)))
+		{
+			const auto& pat(NPL::ResolveRegular<const string>(nd));
+
+			if(IsLiteralPattern(pat) && fmt.find('$') == string::npos)
+				return EmplaceCallResultOrReturn(term,
+					ReplaceLiteral(str, pat, fmt));
+		}
+		return EmplaceCallResultOrReturn(term, CallWithRegex(nd, ctx,
+			[&](const std::regex& re){
+			return string(std::regex_replace(str, re, fmt));
+		}));
+	});
+	// NOTE: The regular expression cache does not change the results.
+	MarkPureCombiners(cs, {"++", "string-split", "string-contains-ci?",
+		"regex-match?", "regex-replace"});
 }
 
-void
-LoadModule_std_strings(ContextState& cs)
-{
-	auto& renv(cs.GetRecordRef());
+void
+LoadModule_std_vectors(ContextState& cs)
+{
+	auto& renv(cs.GetRecordRef());
+
+	RegisterUnary(renv, "vector?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<TermVector>(ReferenceTerm(x));
+	});
+	RegisterStrict(renv, "make-vector", [](TermNode& term){
+		const auto n(RetainRange(term, 1, 2));
+		auto i(term.begin());
+		TermVector vec(FetchIndexValue(NPL::Deref(++i)), term.get_allocator());
+
+		// NOTE: The elements are empty lists by default.
+		if(n == 2)
+		{
+			auto& x(NPL::Deref(++i));
+
+			LiftToReturn(x);
+			EnsureValueTags(x.Tags);
+			for(auto& e : vec)
+				e.SetContent(x);
+		}
+		return EmplaceCallResultOrReturn(term, std::move(vec));
+	});
+	RegisterStrict(renv, "vector", [](TermNode& term){
+		RetainList(term);
+
+		TermVector vec(term.get_allocator());
+
+		vec.reserve(term.size() - 1);
+		for(auto i(std::next(term.begin())); i != term.end(); ++i)
+		{
+			vec.emplace_back();
+			LiftElement(vec.back(), NPL::Deref(i), true);
+		}
+		return EmplaceCallResultOrReturn(term, std::move(vec));
+	});
+	RegisterStrict(renv, "vector-length", [](TermNode& term){
+		return CallUnaryAs<const TermVector>([&](const TermVector& vec){
+			return ReduceToLength(term, vec.size());
+		}, term);
+	});
+	RegisterStrict(renv, "vector-ref", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		const auto& vec(NPL::ResolveRegular<const TermVector>(NPL::Deref(++i)));
+		TermNode res(vec[CheckElementIndex(FetchIndexValue(NPL::Deref(++i)),
+			vec.size())], term.get_allocator());
+
+		LiftOther(term, res);
+		return ReductionStatus::Retained;
+	});
+	RegisterStrict(renv, "vector-set!", [](TermNode& term){
+		RetainN(term, 3);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<TermVector>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+		{
+			auto& vec(x.get());
+			auto& dst(vec[CheckElementIndex(FetchIndexValue(NPL::Deref(++i)),
+				vec.size())]);
+
+			LiftElement(dst, NPL::Deref(++i), true);
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "vector->list", [](TermNode& term){
+		RetainRange(term, 1, 3);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<TermVector>>(
+			NPL::Deref(++i)));
+		auto& vec(x.get());
+		const auto pr(FetchRange(++i, term.end(), vec.size()));
+		const bool move(x.IsMovable());
+		TermNode::Container con(term.get_allocator());
+
+		for(auto j(pr.first); j != pr.second; ++j)
+			if(move)
+				con.emplace_back(std::move(vec[j]));
+			else
+				con.emplace_back(vec[j]);
+		con.swap(term.GetContainerRef());
+		return ReductionStatus::Retained;
+	});
+	RegisterStrict(renv, "list->vector", [](TermNode& term){
+		RetainN(term);
+		return ResolveTerm([&](TermNode& nd, ResolvedTermReferencePtr p_ref)
+			-> ReductionStatus{
+			if(IsList(nd))
+			{
+				const bool move(NPL::IsMovable(p_ref));
+				TermVector vec(term.get_allocator());
+
+				vec.reserve(nd.size());
+				for(auto& sub : nd)
+				{
+					vec.emplace_back();
+					LiftElement(vec.back(), sub, move);
+				}
+				return EmplaceCallResultOrReturn(term, std::move(vec));
+			}
+			ThrowListTypeErrorForNonList(nd, p_ref);
+		}, NPL::Deref(std::next(term.begin())));
+	});
+	RegisterStrict(renv, "vector-copy", [](TermNode& term){
+		RetainRange(term, 1, 3);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<TermVector>>(
+			NPL::Deref(++i)));
+		auto& vec(x.get());
+		const auto pr(FetchRange(++i, term.end(), vec.size()));
+		const auto first(vec.begin() + TermVector::difference_type(pr.first)),
+			last(vec.begin() + TermVector::difference_type(pr.second));
+
+		return EmplaceCallResultOrReturn(term, x.IsMovable()
+			? TermVector(std::make_move_iterator(first),
+			std::make_move_iterator(last), term.get_allocator())
+			: TermVector(first, last, term.get_allocator()));
+	});
+	RegisterStrict(renv, "vector-copy!", [](TermNode& term){
+		RetainRange(term, 3, 5);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<TermVector>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+		{
+			auto& dst(x.get());
+			const auto at(FetchIndexValue(NPL::Deref(++i)));
+			const auto& src(
+				NPL::ResolveRegular<const TermVector>(NPL::Deref(++i)));
+			const auto pr(FetchRange(++i, term.end(), src.size()));
+
+			if(at <= dst.size() && pr.second - pr.first <= dst.size() - at)
+				CopyElements(src.data() + pr.first, src.data() + pr.second,
+					dst.data() + at);
+			else
+				throw std::out_of_range("Destination range out of range found.");
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "vector-fill!", [](TermNode& term){
+		RetainRange(term, 2, 4);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<TermVector>>(
+			NPL::Deref(++i)));
 
-	RegisterUnary(renv, "string?",
+		if(x.IsModifiable())
+		{
+			auto& vec(x.get());
+			auto& y(NPL::Deref(++i));
+			const auto pr(FetchRange(++i, term.end(), vec.size()));
+
+			LiftToReturn(y);
+			EnsureValueTags(y.Tags);
+			for(auto j(pr.first); j != pr.second; ++j)
+				vec[j].SetContent(y);
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterUnary(renv, "bytevector?",
 		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
-		return IsTypedRegular<string>(ReferenceTerm(x));
+		return IsTypedRegular<ByteVector>(ReferenceTerm(x));
 	});
-	RegisterStrict(renv, "++", trivial_swap,
-		std::bind(CallBinaryFold<string, ystdex::plus<>>,
-		ystdex::plus<>(), string(), std::placeholders::_1));
-	RegisterUnary<Strict, const string>(renv, "string-empty?",
-		[](const string& str) ynothrow{
-		return str.empty();
+	RegisterStrict(renv, "make-bytevector", [](TermNode& term){
+		const auto n(RetainRange(term, 1, 2));
+		auto i(term.begin());
+		const auto len(FetchIndexValue(NPL::Deref(++i)));
+
+		return EmplaceCallResultOrReturn(term, ByteVector(len,
+			n == 2 ? FetchByteValue(NPL::Deref(++i)) : byte(),
+			term.get_allocator()));
 	});
-	RegisterBinary<Strict, ResolvedArg<>, ResolvedArg<>>(renv, "string<-",
-		[](ResolvedArg<>&& x, ResolvedArg<>&& y){
+	RegisterStrict(renv, "bytevector", [](TermNode& term){
+		RetainList(term);
+
+		ByteVector bvec(term.get_allocator());
+
+		bvec.reserve(term.size() - 1);
+		for(auto i(std::next(term.begin())); i != term.end(); ++i)
+			bvec.push_back(FetchByteValue(NPL::Deref(i)));
+		return EmplaceCallResultOrReturn(term, std::move(bvec));
+	});
+	RegisterStrict(renv, "bytevector-length", [](TermNode& term){
+		return CallUnaryAs<const ByteVector>([&](const ByteVector& bvec){
+			return ReduceToLength(term, bvec.size());
+		}, term);
+	});
+	RegisterStrict(renv, "bytevector-u8-ref", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		const auto&
+			bvec(NPL::ResolveRegular<const ByteVector>(NPL::Deref(++i)));
+
+		return EmplaceCallResultOrReturn(term, int(bvec[CheckElementIndex(
+			FetchIndexValue(NPL::Deref(++i)), bvec.size())]));
+	});
+	RegisterStrict(renv, "bytevector-u8-set!", [](TermNode& term){
+		RetainN(term, 3);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<ByteVector>>(
+			NPL::Deref(++i)));
+
 		if(x.IsModifiable())
 		{
-			auto& str_x(AccessRegular<string>(x.get(), x.second));
-			auto& str_y(AccessRegular<string>(y.get(), y.second));
+			auto& bvec(x.get());
+			const auto idx(CheckElementIndex(FetchIndexValue(NPL::Deref(++i)),
+				bvec.size()));
 
-			if(y.IsMovable())
-				str_x = std::move(str_y);
+			bvec[idx] = FetchByteValue(NPL::Deref(++i));
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "bytevector-copy", [](TermNode& term){
+		RetainRange(term, 1, 3);
+
+		auto i(term.begin());
+		const auto&
+			bvec(NPL::ResolveRegular<const ByteVector>(NPL::Deref(++i)));
+		const auto pr(FetchRange(++i, term.end(), bvec.size()));
+
+		return EmplaceCallResultOrReturn(term, ByteVector(bvec.begin()
+			+ ByteVector::difference_type(pr.first), bvec.begin()
+			+ ByteVector::difference_type(pr.second), term.get_allocator()));
+	});
+	RegisterStrict(renv, "bytevector-copy!", [](TermNode& term){
+		RetainRange(term, 3, 5);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<ByteVector>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+		{
+			auto& dst(x.get());
+			const auto at(FetchIndexValue(NPL::Deref(++i)));
+			const auto& src(
+				NPL::ResolveRegular<const ByteVector>(NPL::Deref(++i)));
+			const auto pr(FetchRange(++i, term.end(), src.size()));
+
+			if(at <= dst.size() && pr.second - pr.first <= dst.size() - at)
+				CopyElements(src.data() + pr.first, src.data() + pr.second,
+					dst.data() + at);
 			else
-				str_x = str_y;
+				throw std::out_of_range("Destination range out of range found.");
 		}
 		else
 			ThrowNonmodifiableErrorForAssignee();
-		return ValueToken::Unspecified;
+		return ReduceReturnUnspecified(term);
 	});
-	RegisterStrict(renv, "string-split", [](TermNode& term){
-		return CallBinaryAs<string, const string>(
-			[&](string& x, const string& y) -> ReductionStatus{
-			if(!x.empty())
-			{
-				TermNode::Container con(term.get_allocator());
-				const auto len(y.length());
+	RegisterStrict(renv, "bytevector-fill!", [](TermNode& term){
+		RetainRange(term, 2, 4);
 
-				if(len != 0)
-				{
-					string::size_type pos(0), orig(0);
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<ByteVector>>(
+			NPL::Deref(++i)));
 
-					while((pos = x.find(y, pos)) != string::npos)
-					{
-						TermNode::AddValueTo(con, x.substr(orig, pos - orig));
-						orig = (pos += len);
-					}
-					TermNode::AddValueTo(con, x.substr(orig, pos - orig));
-				}
-				else
-					TermNode::AddValueTo(con, std::move(x));
-				con.swap(term.GetContainerRef());
-				return ReductionStatus::Retained;
+		if(x.IsModifiable())
+		{
+			auto& bvec(x.get());
+			const auto b(FetchByteValue(NPL::Deref(++i)));
+			const auto pr(FetchRange(++i, term.end(), bvec.size()));
+
+			std::fill(bvec.begin() + ByteVector::difference_type(pr.first),
+				bvec.begin() + ByteVector::difference_type(pr.second), b);
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "bytevector->list", [](TermNode& term){
+		RetainRange(term, 1, 3);
+
+		auto i(term.begin());
+		const auto&
+			bvec(NPL::ResolveRegular<const ByteVector>(NPL::Deref(++i)));
+		const auto pr(FetchRange(++i, term.end(), bvec.size()));
+		TermNode::Container con(term.get_allocator());
+
+		for(auto j(pr.first); j != pr.second; ++j)
+			TermNode::AddValueTo(con, int(bvec[j]));
+		con.swap(term.GetContainerRef());
+		return ReductionStatus::Retained;
+	});
+	RegisterStrict(renv, "list->bytevector", [](TermNode& term){
+		RetainN(term);
+		return ResolveTerm([&](TermNode& nd, ResolvedTermReferencePtr p_ref)
+			-> ReductionStatus{
+			if(IsList(nd))
+			{
+				ByteVector bvec(term.get_allocator());
+
+				bvec.reserve(nd.size());
+				for(auto& sub : nd)
+					bvec.push_back(FetchByteValue(sub));
+				return EmplaceCallResultOrReturn(term, std::move(bvec));
 			}
-			return ReductionStatus::Clean;
-		}, term);
+			ThrowListTypeErrorForNonList(nd, p_ref);
+		}, NPL::Deref(std::next(term.begin())));
 	});
-	RegisterBinary<Strict, string, string>(renv, "string-contains-ci?",
-		[](string x, string y){
-		// TODO: Extract 'strlwr'.
-		const auto to_lwr([](string& str) ynothrow{
-			for(auto& c : str)
-				c = ystdex::tolower(c);
+}
+
+void
+LoadModule_std_hashtables(ContextState& cs)
+{
+	auto& renv(cs.GetRecordRef());
+	const auto reg_make([&](string_view id, HashTable::Comparison cmp){
+		RegisterStrict(renv, id, [cmp](TermNode& term){
+			const auto n(RetainRange(term, 0, 1));
+
+			return EmplaceCallResultOrReturn(term, HashTable(cmp, n == 1
+				? FetchIndexValue(NPL::Deref(std::next(term.begin()))) : 0,
+				term.get_allocator()));
 		});
+	});
 
-		to_lwr(x),
-		to_lwr(y);
-		return x.find(y) != string::npos;
+	reg_make("make-eq-hash-table", HashTable::Comparison::Eq);
+	reg_make("make-eqv-hash-table", HashTable::Comparison::Eqv);
+	reg_make("make-equal-hash-table", HashTable::Comparison::Equal);
+	RegisterUnary(renv, "hash-table?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<HashTable>(ReferenceTerm(x));
 	});
-	RegisterUnary<Strict, ResolvedArg<string>>(renv, "string->symbol",
-		[](ResolvedArg<string>&& x){
-		return x.IsMovable() ? StringToSymbol(std::move(x.first))
-			: StringToSymbol(x.first);
+	RegisterStrict(renv, "hash-table-size", [](TermNode& term){
+		return CallUnaryAs<const HashTable>([&](const HashTable& tbl){
+			return ReduceToLength(term, tbl.size());
+		}, term);
 	});
-	RegisterUnary<Strict, const TokenValue>(renv, "symbol->string",
-		SymbolToString);
-	RegisterUnary<Strict, const string>(renv, "string->regex",
-		[](const string& str){
-		return std::regex(str);
+	RegisterStrict(renv, "hash-table-contains?", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		const auto&
+			tbl(NPL::ResolveRegular<const HashTable>(NPL::Deref(++i)));
+
+		term.Value = tbl.find(NPL::Deref(++i)) != tbl.end();
+		return ReductionStatus::Clean;
 	});
-	RegisterBinary<Strict, const string, const std::regex>(renv, "regex-match?",
-		[](const string& str, const std::regex& re){
-		return std::regex_match(str, re);
+	RegisterStrict(renv, "hash-table-ref", [](TermNode& term){
+		const auto n(RetainRange(term, 2, 3));
+		auto i(term.begin());
+		const auto&
+			tbl(NPL::ResolveRegular<const HashTable>(NPL::Deref(++i)));
+		const auto j(tbl.find(NPL::Deref(++i)));
+		TermNode res(term.get_allocator());
+
+		if(j != tbl.end())
+			res.SetContent(j->Value);
+		else if(n == 3)
+			LiftElement(res, NPL::Deref(++i), true);
+		else
+			throw std::out_of_range("Key not found in the hash table.");
+		LiftOther(term, res);
+		return ReductionStatus::Retained;
 	});
-	RegisterStrict(renv, "regex-replace", [](TermNode& term){
+	RegisterStrict(renv, "hash-table-set!", [](TermNode& term){
 		RetainN(term, 3);
 
 		auto i(term.begin());
-		const auto& str(NPL::ResolveRegular<const string>(NPL::Deref(++i)));
-		const auto& re(NPL::ResolveRegular<const std::regex>(NPL::Deref(++i)));
+		auto x(NPL::AccessTypedValue<ResolvedArg<HashTable>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+		{
+			auto& tbl(x.get());
+			auto& key(NPL::Deref(++i));
+			auto& val(NPL::Deref(++i));
+
+			PrepareHashTableKey(key, tbl.GetComparison());
+			LiftToReturn(val);
+			EnsureValueTags(val.Tags);
+			tbl.insert_or_assign(std::move(key), std::move(val));
+		}
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "hash-table-delete!", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<HashTable>>(
+			NPL::Deref(++i)));
+
+		if(!x.IsModifiable())
+			ThrowNonmodifiableErrorForAssignee();
+		term.Value = x.get().erase(NPL::Deref(++i)) != 0;
+		return ReductionStatus::Clean;
+	});
+	RegisterStrict(renv, "hash-table-clear!", [](TermNode& term){
+		RetainN(term);
+
+		auto x(NPL::AccessTypedValue<ResolvedArg<HashTable>>(
+			NPL::Deref(std::next(term.begin()))));
+
+		if(x.IsModifiable())
+			x.get().clear();
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "hash-table-reserve!", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		auto x(NPL::AccessTypedValue<ResolvedArg<HashTable>>(
+			NPL::Deref(++i)));
+
+		if(x.IsModifiable())
+			x.get().reserve(FetchIndexValue(NPL::Deref(++i)));
+		else
+			ThrowNonmodifiableErrorForAssignee();
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "hash-table-keys", [](TermNode& term){
+		return CallUnaryAs<const HashTable>(
+			[&](const HashTable& tbl) -> ReductionStatus{
+			TermNode::Container con(term.get_allocator());
+
+			for(const auto& e : tbl)
+				con.emplace_back(e.Key);
+			con.swap(term.GetContainerRef());
+			return ReductionStatus::Retained;
+		}, term);
+	});
+	RegisterStrict(renv, "hash-table-values", [](TermNode& term){
+		return CallUnaryAs<const HashTable>(
+			[&](const HashTable& tbl) -> ReductionStatus{
+			TermNode::Container con(term.get_allocator());
+
+			for(const auto& e : tbl)
+				con.emplace_back(e.Value);
+			con.swap(term.GetContainerRef());
+			return ReductionStatus::Retained;
+		}, term);
+	});
+	RegisterStrict(renv, "hash-table->alist", [](TermNode& term){
+		return CallUnaryAs<const HashTable>(
+			[&](const HashTable& tbl) -> ReductionStatus{
+			TermNode::Container con(term.get_allocator());
 
-		return EmplaceCallResultOrReturn(term, string(std::regex_replace(str,
-			re, NPL::ResolveRegular<const string>(NPL::Deref(++i)))));
+			for(const auto& e : tbl)
+			{
+				// NOTE: As %Forms::Cons, the key is spliced before the value.
+				con.emplace_back(e.Value);
+
+				auto& pr(con.back());
+
+				pr.GetContainerRef().emplace(pr.begin(), e.Key);
+			}
+			con.swap(term.GetContainerRef());
+			return ReductionStatus::Retained;
+		}, term);
 	});
+	cs.ShareCurrentSource("<lib:std.hashtables>");
+	A1::Perform(cs, R"NPL(
+$defl! hash-table-walk (&t &f)
+	for-each-ltr ($lambda ((&k .&v)) f k v) (hash-table->alist t);
+	)NPL");
 }
 
 void
@@ -2222,7 +4267,169 @@ $defl/e! env-empty? (derive-current-environment std.strings) (&n)
 		[](const string& filename){
 		return YSLib::uremove(filename.c_str());
 	});
+	RegisterStrict(renv, "get-profile", [](TermNode& term, ContextNode& ctx){
+		const auto& p_profiler(ContextState::Access(ctx).ProfilerPtr);
+		bool collapsed = {};
+
+		if(RetainRange(term, 0, 1) != 0)
+		{
+			const auto& fmt(NPL::ResolveRegular<const string>(
+				NPL::Deref(std::next(term.begin()))));
+
+			if(fmt == "collapsed")
+				collapsed = true;
+			else if(fmt != "summary")
+				throw std::invalid_argument(ystdex::sfmt(
+					"Invalid profile format '%s' found.", fmt.c_str()));
+		}
+
+		string res(term.get_allocator());
+
+		if(p_profiler)
+		{
+			YSLib::ostringstream oss;
+
+			if(collapsed)
+				p_profiler->PrintCollapsedStacks(oss);
+			else
+				p_profiler->PrintSummary(oss);
+			res = oss.str();
+		}
+		return EmplaceCallResultOrReturn(term, std::move(res));
+	});
+}
+
+#if YF_Multithread == 1
+void
+LoadModule_std_threads(ContextState& cs)
+{
+	auto& renv(cs.GetRecordRef());
+	const auto p_state(YSLib::make_shared<ThreadModuleState>());
+	const auto spawn([=](TermNode& term, ContextNode& ctx, TermNode&& expr){
+		return EmplaceCallResultOrReturn(term, ThreadHandle{p_state->Spawn(
+			ContextState::Access(ctx), std::move(expr)).share()});
+	});
+
+	RegisterUnary(renv, "thread?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<ThreadHandle>(ReferenceTerm(x));
+	});
+	RegisterStrict(renv, "spawn", [=](TermNode& term, ContextNode& ctx){
+		RetainN(term);
+
+		TermNode expr(FetchTransferAllocator());
+
+		CopyTransferable(expr, NPL::Deref(std::next(term.begin())));
+		return spawn(term, ctx, std::move(expr));
+	});
+	RegisterForm(renv, "$spawn", [=](TermNode& term, ContextNode& ctx){
+		Retain(term);
+
+		TermNode expr(FetchTransferAllocator());
+
+		NPL::AddToken(expr, "$sequence");
+		for(auto i(std::next(term.begin())); i != term.end(); ++i)
+			CopyTransferable(*expr.emplace(), *i);
+		return spawn(term, ctx, std::move(expr));
+	});
+	RegisterStrict(renv, "join", [](TermNode& term){
+		return CallUnaryAs<const ThreadHandle>(
+			[&](const ThreadHandle& h) -> ReductionStatus{
+			TermNode res(term.get_allocator());
+
+			FetchThreadResult(res, h.Result);
+			LiftOther(term, res);
+			return ReductionStatus::Retained;
+		}, term);
+	});
+	RegisterStrict(renv, "parallel-map", [=](TermNode& term, ContextNode& ctx){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		const auto& f(NPL::Deref(++i));
+
+		return ResolveTerm([&](const TermNode& nd, ResolvedTermReferencePtr
+			p_ref) -> ReductionStatus{
+			if(!IsList(nd))
+				ThrowListTypeErrorForNonList(nd, p_ref);
+
+			const auto& cur_cs(ContextState::Access(ctx));
+			vector<std::shared_future<TermNode>> futures(term.get_allocator());
+
+			futures.reserve(nd.size());
+			for(const auto& x : nd)
+			{
+				TermNode expr(FetchTransferAllocator());
+
+				CopyTransferable(*expr.emplace(), f);
+
+				// NOTE: The element is quoted to prevent it from being evaluated
+				//	again in the worker.
+				auto& quoted(*expr.emplace());
+
+				NPL::AddToken(quoted, "$quote");
+				CopyTransferable(*quoted.emplace(), x);
+				futures.push_back(p_state->Spawn(cur_cs, std::move(expr)));
+			}
+			// NOTE: All tasks are waited before any exception is propagated, so
+			//	no tasks are left running after the call.
+			for(const auto& fut : futures)
+				fut.wait();
+
+			TermNode::Container con(term.get_allocator());
+
+			for(const auto& fut : futures)
+			{
+				con.emplace_back();
+				FetchThreadResult(con.back(), fut);
+			}
+			con.swap(term.GetContainerRef());
+			return ReductionStatus::Retained;
+		}, NPL::Deref(++i));
+	});
+	RegisterStrict(renv, "make-channel", [](TermNode& term){
+		RetainN(term, 0);
+		return EmplaceCallResultOrReturn(term, Channel());
+	});
+	RegisterUnary(renv, "channel?",
+		[] YB_LAMBDA_ANNOTATE((const TermNode& x), ynothrow, pure){
+		return IsTypedRegular<Channel>(ReferenceTerm(x));
+	});
+	RegisterStrict(renv, "channel-send", [](TermNode& term){
+		RetainN(term, 2);
+
+		auto i(term.begin());
+		auto& ch(NPL::ResolveRegular<Channel>(NPL::Deref(++i)));
+		TermNode val(FetchTransferAllocator());
+
+		CopyTransferable(val, NPL::Deref(++i));
+		ch.Send(std::move(val));
+		return ReduceReturnUnspecified(term);
+	});
+	RegisterStrict(renv, "channel-receive", [](TermNode& term){
+		const auto n(RetainRange(term, 1, 2));
+		auto i(term.begin());
+		auto& ch(NPL::ResolveRegular<Channel>(NPL::Deref(++i)));
+		TermNode val(FetchTransferAllocator());
+		TermNode res(term.get_allocator());
+
+		if(ch.Receive(val))
+			CopyTransferable(res, val);
+		else if(n == 2)
+			LiftElement(res, NPL::Deref(++i), true);
+		else
+			throw NPLException("Receiving from a closed empty channel.");
+		LiftOther(term, res);
+		return ReductionStatus::Retained;
+	});
+	RegisterStrict(renv, "channel-close", [](TermNode& term){
+		return CallUnaryAs<Channel>([&](Channel& ch){
+			ch.Close();
+			return ReduceReturnUnspecified(term);
+		}, term);
+	});
 }
+#endif
 
 void
 LoadModule_std_modules(ContextState& cs,
@@ -2693,9 +4900,14 @@ LoadStandardContext(ContextState& cs)
 	load_std_module("continuations", LoadModule_std_continuations),
 	load_std_module("promises", LoadModule_std_promises);
 	load_std_module("math", LoadModule_std_math),
-	load_std_module("strings", LoadModule_std_strings);
+	load_std_module("strings", LoadModule_std_strings),
+	load_std_module("vectors", LoadModule_std_vectors),
+	load_std_module("hashtables", LoadModule_std_hashtables);
 	LoadModuleChecked(cs, "std.io", LoadModule_std_io, cs, p_ground);
 	load_std_module("system", LoadModule_std_system);
+#if YF_Multithread == 1
+	load_std_module("threads", LoadModule_std_threads);
+#endif
 	LoadModuleChecked(cs, "std.modules", LoadModule_std_modules, cs, p_ground);
 }
 
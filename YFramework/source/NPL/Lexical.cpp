@@ -11,13 +11,13 @@
 /*!	\file Lexical.cpp
 \ingroup NPL
 \brief NPL 词法处理。
-\version r2190
+\version r2193
 \author FrankHB <frankhb1989@gmail.com>
 \since build 335
 \par 创建时间:
 	2012-08-03 23:04:26 +0800
 \par 修改时间:
-	2021-12-21 21:27 +0800
+	2026-10-17 13:51 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -28,6 +28,19 @@
 #include "NPL/YModules.h"
 #include YFM_NPL_Lexical // for YSLib::octet;
 #include <ystdex/string.hpp> // for ystdex::get_mid;
+#include <ystdex/bit.hpp> // for ystdex::countr_zero_narrow;
+#include <cstring> // for std::memchr;
+#include <algorithm> // for std::equal;
+//! \since build 955
+#if defined(__SSE2__) || defined(_M_X64) \
+	|| (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	define NPL_Impl_Lexical_UseSSE2 true
+#	include <emmintrin.h> // for __m128i, _mm_loadu_si128, _mm_set1_epi8,
+//	_mm_cmpeq_epi8, _mm_or_si128, _mm_sub_epi8, _mm_min_epu8,
+//	_mm_movemask_epi8;
+#else
+#	define NPL_Impl_Lexical_UseSSE2 false
+#endif
 
 namespace NPL
 {
@@ -156,15 +169,13 @@ CheckLiteral(string_view sv) ynothrowv
 	return {};
 }
 
-string
-Escape(string_view sv)
+void
+AppendEscaped(string& dst, string_view sv)
 {
 	YAssertNonnull(sv.data());
 
 	char last{};
-	string res;
 
-	res.reserve(sv.length());
 	for(char c : sv)
 	{
 		char unescaped{};
@@ -200,7 +211,7 @@ Escape(string_view sv)
 		{
 			if(c == '\\')
 			{
-				yunseq(last = char(), res += '\\');
+				yunseq(last = char(), dst += '\\');
 				continue;
 			}
 			switch(c)
@@ -214,31 +225,55 @@ Escape(string_view sv)
 			case 'v':
 			case '\'':
 			case '"':
-				res += '\\';
+				dst += '\\';
 			}
 		}
 		if(unescaped == char())
-			res += c;
+			dst += c;
 		else
 		{
-			res += '\\';
-			res += unescaped;
+			dst += '\\';
+			dst += unescaped;
 			unescaped = char();
 		}
 		last = c;
 	}
+}
+
+void
+AppendEscapedLiteral(string& dst, string_view sv, char d)
+{
+	const char c(CheckLiteral(sv));
+	const char q(c != char() ? c : d);
+	const auto n(dst.size() + (q != char() ? 1 : 0));
+
+	if(q != char())
+		dst += q;
+	AppendEscaped(dst, c == char() ? sv : ystdex::get_mid(sv));
+	if(dst.size() != n && dst.back() == '\\')
+		dst += '\\';
+	if(q != char())
+		dst += q;
+}
+
+string
+Escape(string_view sv)
+{
+	string res;
+
+	res.reserve(sv.length());
+	AppendEscaped(res, sv);
 	return res;
 }
 
 string
 EscapeLiteral(string_view sv)
 {
-	const char c(CheckLiteral(sv));
-	auto content(Escape(c == char() ? sv : ystdex::get_mid(sv)));
+	string res;
 
-	if(!content.empty() && content.back() == '\\')
-		content += '\\';
-	return c == char() ? std::move(content) : ystdex::quote(content, c);
+	res.reserve(sv.length());
+	AppendEscapedLiteral(res, sv);
+	return res;
 }
 
 string
@@ -323,6 +358,67 @@ Decompose(string_view src, LexemeList::allocator_type a)
 }
 
 
+//! \since build 955
+namespace
+{
+
+// NOTE: Characters in ['\t', '\f'] are replaced by
+//	%LexicalAnalyzer::UpdateBack. Other delimiters are checked only when %split
+//	is true.
+YB_ATTR_nodiscard YB_STATELESS yconstfn
+	PDefH(bool, IsOrdinaryByte, char c, char ld, bool split) ynothrow
+	ImplRet(c != '\\' && (ld == char() ? c != '\'' && c != '"'
+		&& !(c >= '\t' && c <= '\f') && !(split && (c == ' ' || c == '\r'
+		|| IsGraphicalDelimiter(c))) : c != ld))
+
+} // unnamed namespace;
+
+size_t
+ScanOrdinaryBytes(const char* first, const char* last, char ld, bool split)
+	ynothrowv
+{
+	YAssertNonnull(first),
+	YAssertNonnull(last);
+	YAssert(first <= last, "Invalid range found.");
+
+	const auto p(first);
+
+#if NPL_Impl_Lexical_UseSSE2
+	const auto match([](__m128i x, char c){
+		return _mm_cmpeq_epi8(x, _mm_set1_epi8(c));
+	});
+
+	for(; last - first >= 16; first += 16)
+	{
+		const auto x(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+		auto m(match(x, '\\'));
+
+		if(ld == char())
+		{
+			// NOTE: The unsigned difference is in [0, 3] for ['\t', '\f'], or
+			//	[0, 4] for ['\t', '\r'] when %split is true.
+			const auto d(_mm_sub_epi8(x, _mm_set1_epi8('\t')));
+
+			m = _mm_or_si128(m, _mm_or_si128(_mm_or_si128(match(x, '\''),
+				match(x, '"')), _mm_cmpeq_epi8(_mm_min_epu8(d,
+				_mm_set1_epi8(split ? 4 : 3)), d)));
+			if(split)
+				m = _mm_or_si128(m, _mm_or_si128(_mm_or_si128(match(x, ' '),
+					_mm_or_si128(match(x, '('), match(x, ')'))),
+					_mm_or_si128(match(x, ','), match(x, ';'))));
+		}
+		else
+			m = _mm_or_si128(m, match(x, ld));
+		if(const auto mask = unsigned(_mm_movemask_epi8(m)))
+			return size_t(first - p) + size_t(ystdex::countr_zero_narrow(mask));
+	}
+#endif
+	while(first != last && IsOrdinaryByte(*first, ld, split))
+		++first;
+	return size_t(first - p);
+}
+
+
 //! \since build 891
 namespace
 {
@@ -419,9 +515,171 @@ struct SourcedSequenceAppend final
 	}
 };
 
+//! \since build 955
+//@{
+YB_ATTR_nodiscard YB_STATELESS inline
+	PDefH(string_view&, AccessLexemeView, string_view& sv) ynothrow
+	ImplRet(sv)
+YB_ATTR_nodiscard YB_STATELESS inline PDefH(string_view&, AccessLexemeView,
+	pair<SourceLocation, string_view>& pr) ynothrow
+	ImplRet(pr.second)
+
+//! \brief 视图字节解析器的词素更新状态。
+struct ViewUpdateState final
+{
+	//! \brief 当前输入的起始位置。
+	const char* First;
+	//! \brief 当前输入中已处理的字节的结尾位置。
+	const char* Last;
+	list<string>& Materialized;
+	bool& CurrentMaterialized;
+
+	/*!
+	\brief 取内容和参数相同的已处理的输入的后缀。
+	\return 若不存在，数据指针为空的视图。
+	*/
+	YB_ATTR_nodiscard YB_PURE string_view
+	Slice(string_view x) const ynothrow
+	{
+		const auto n(x.size());
+
+		if(size_t(Last - First) >= n)
+		{
+			const auto p(Last - n);
+
+			if(x.data() == p || std::equal(x.begin(), x.end(), p))
+				return {p, n};
+		}
+		return {};
+	}
+
+	//! \brief 取新词素：若不能引用输入，则保存内容。
+	YB_ATTR_nodiscard string_view
+	Add(string_view x)
+	{
+		auto sv(Slice(x));
+
+		CurrentMaterialized = !sv.data();
+		if(CurrentMaterialized)
+		{
+			Materialized.emplace_back(x.data(), x.size());
+			sv = Materialized.back();
+		}
+		return sv;
+	}
+
+	//! \brief 追加内容到词素：若不能扩展引用输入的词素，则保存内容。
+	void
+	Append(string_view& cur, string_view x)
+	{
+		const auto sv(Slice(x));
+
+		if(!CurrentMaterialized && sv.data()
+			&& cur.data() + cur.size() == sv.data())
+			cur = string_view(cur.data(), cur.size() + sv.size());
+		else
+		{
+			if(!CurrentMaterialized)
+			{
+				Materialized.emplace_back(cur.data(), cur.size());
+				CurrentMaterialized = true;
+			}
+
+			auto& str(Materialized.back());
+
+			str.append(x.data(), x.size());
+			cur = str;
+		}
+	}
+};
+
+template<class _tParseResult>
+struct ViewSequenceAdd final
+{
+	ViewUpdateState& State;
+
+	void
+	operator()(_tParseResult& res, const string& x) const
+	{
+		res.push_back(State.Add(x));
+	}
+};
+
+template<class _tParseResult>
+struct SourcedViewSequenceAdd final
+{
+	ViewUpdateState& State;
+	const SourceLocation& Location;
+
+	void
+	operator()(_tParseResult& res, const string& x) const
+	{
+		res.emplace_back(Location, State.Add(x));
+	}
+};
+
+template<class _tParseResult>
+struct ViewSequenceAppend final
+{
+	ViewUpdateState& State;
+
+	void
+	operator()(_tParseResult& res, char c) const
+	{
+		State.Append(AccessLexemeView(res.back()), string_view(&c, 1));
+	}
+	void
+	operator()(_tParseResult& res, const string& x) const
+	{
+		State.Append(AccessLexemeView(res.back()), x);
+	}
+};
+
+//! \brief 按源代码位置跳过字节序列。
+void
+StepSourceLocation(SourceLocation& src_loc, const char* first,
+	const char* last) ynothrowv
+{
+	YAssert(first <= last, "Invalid range found.");
+	while(const auto p = static_cast<const char*>(
+		std::memchr(first, '\n', size_t(last - first))))
+	{
+		src_loc.Newline();
+		first = p + 1;
+	}
+	src_loc.Column += size_t(last - first);
+}
+//@}
+
 } // unnamed namespace;
 
 
+void
+ByteParser::operator()(const char* first, const char* last)
+{
+	YAssert(first <= last, "Invalid range found.");
+
+	auto& lexer(GetLexerRef());
+
+	while(first != last)
+	{
+		if(!lexer.GetUnescapeContext().IsHandling() && GetBuffer().empty())
+			if(const auto n = ScanOrdinaryBytes(first, last,
+				lexer.GetDelimiter()))
+			{
+				// NOTE: As %UpdateByteRaw for each character in the range.
+				if(update_current)
+					lexemes.back().append(first, n);
+				else
+					lexemes.emplace_back(first, n);
+				update_current = true;
+				first += n;
+				continue;
+			}
+		(*this)(*first++);
+	}
+}
+
 void
 ByteParser::Update(bool got_delim)
 {
@@ -431,6 +689,37 @@ ByteParser::Update(bool got_delim)
 }
 
 
+void
+SourcedByteParser::operator()(const char* first, const char* last)
+{
+	YAssert(first <= last, "Invalid range found.");
+
+	auto& lexer(GetLexerRef());
+
+	while(first != last)
+	{
+		if(!lexer.GetUnescapeContext().IsHandling() && GetBuffer().empty())
+			if(const auto n = ScanOrdinaryBytes(first, last,
+				lexer.GetDelimiter()))
+			{
+				const auto e(first + n);
+
+				// NOTE: Ditto.
+				if(update_current)
+					lexemes.back().second.append(first, n);
+				else
+					lexemes.emplace_back(source_location, string(first, n,
+						lexemes.get_allocator()));
+				update_current = true;
+				// NOTE: Only quoted characters can be newline characters.
+				StepSourceLocation(source_location, first, e);
+				first = e;
+				continue;
+			}
+		(*this)(*first++);
+	}
+}
+
 void
 SourcedByteParser::Update(bool got_delim)
 {
@@ -441,6 +730,108 @@ SourcedByteParser::Update(bool got_delim)
 }
 
 
+void
+ViewByteParser::operator()(const char* first, const char* last)
+{
+	YAssert(first <= last, "Invalid range found.");
+
+	auto& lexer(GetLexerRef());
+	auto& cbuf(GetBufferRef());
+	ViewUpdateState st{first, first, materialized, current_materialized};
+
+	while(st.Last != last)
+	{
+		if(!lexer.GetUnescapeContext().IsHandling() && cbuf.empty())
+			if(const auto n = ScanOrdinaryBytes(st.Last, last,
+				lexer.GetDelimiter()))
+			{
+				const string_view sv(st.Last, n);
+
+				st.Last += n;
+				// NOTE: As %ByteParser::operator().
+				if(update_current)
+					st.Append(lexemes.back(), sv);
+				else
+					lexemes.push_back(st.Add(sv));
+				update_current = true;
+				continue;
+			}
+
+		const char c(*st.Last++);
+
+		// NOTE: As %ByteParser::Update.
+		UpdateByteRaw(ViewSequenceAdd<ParseResult>{st},
+			ViewSequenceAppend<ParseResult>{st}, lexemes,
+			lexer.FilterChar(c, cbuf) && lexer.UpdateBack(cbuf.back(), c),
+			lexer, cbuf, update_current);
+	}
+}
+
+
+void
+SourcedViewByteParser::operator()(const char* first, const char* last)
+{
+	YAssert(first <= last, "Invalid range found.");
+
+	auto& lexer(GetLexerRef());
+	auto& cbuf(GetBufferRef());
+	ViewUpdateState st{first, first, materialized, current_materialized};
+
+	while(st.Last != last)
+	{
+		if(!lexer.GetUnescapeContext().IsHandling() && cbuf.empty())
+			if(const auto n = ScanOrdinaryBytes(st.Last, last,
+				lexer.GetDelimiter()))
+			{
+				const string_view sv(st.Last, n);
+
+				st.Last += n;
+				// NOTE: As %SourcedByteParser::operator().
+				if(update_current)
+					st.Append(lexemes.back().second, sv);
+				else
+					lexemes.emplace_back(source_location, st.Add(sv));
+				update_current = true;
+				StepSourceLocation(source_location, sv.data(), st.Last);
+				continue;
+			}
+
+		const char c(*st.Last++);
+
+		// NOTE: As %SourcedByteParser::Update.
+		UpdateByteRaw(SourcedViewSequenceAdd<ParseResult>{st,
+			source_location}, ViewSequenceAppend<ParseResult>{st}, lexemes,
+			lexer.FilterChar(c, cbuf) && lexer.UpdateBack(cbuf.back(), c),
+			lexer, cbuf, update_current);
+		if(c != '\n')
+			source_location.Step();
+		else
+			source_location.Newline();
+	}
+}
+
+
+void
+DelimitedByteParser::operator()(const char* first, const char* last)
+{
+	YAssert(first <= last, "Invalid range found.");
+
+	auto& lexer(GetLexerRef());
+
+	while(first != last)
+	{
+		if(!lexer.GetUnescapeContext().IsHandling())
+			if(const auto n = ScanOrdinaryBytes(first, last,
+				lexer.GetDelimiter(), {}))
+			{
+				GetBufferRef().append(first, n);
+				first += n;
+				continue;
+			}
+		(*this)(*first++);
+	}
+}
+
 LexemeList
 DelimitedByteParser::GetResult() const
 {
@@ -11,13 +11,13 @@
 /*!	\file NPLA.cpp
 \ingroup NPL
 \brief NPLA 公共接口。
-\version r4202
+\version r4211
 \author FrankHB <frankhb1989@gmail.com>
 \since build 663
 \par 创建时间:
 	2016-01-07 10:32:45 +0800
 \par 修改时间:
-	2022-08-21 23:32 +0800
+	2026-10-17 17:36 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -39,7 +39,9 @@
 //	TryAccessLeaf, AccessFirstSubterm, YSLib::FilterExceptions, type_id,
 //	ystdex::addrof, ystdex::second_of, type_info, std::current_exception,
 //	std::rethrow_exception, std::throw_with_nested, ystdex::retry_on_cond,
-//	ystdex::id, pair, IsAtom, NPL::IsMovable, YSLib::ExtractException;
+//	ystdex::id, pair, IsAtom, NPL::IsMovable, YSLib::ExtractException,
+//	AppendEscapedLiteral, std::numeric_limits, std::end, std::min,
+//	YSLib::IsDecodableIndex, YSLib::DecodeIndex;
 #include <ystdex/function.hpp> // for ystdex::unchecked_function;
 
 //! \since build 903
@@ -77,7 +79,12 @@ EscapeNodeLiteral(const ValueNode& node)
 string
 LiteralizeEscapeNodeLiteral(const ValueNode& node)
 {
-	return Literalize(EscapeNodeLiteral(node));
+	const auto& str(Access<string>(node));
+	string res;
+
+	res.reserve(str.length() + 2);
+	AppendEscapedLiteral(res, str, '"');
+	return res;
 }
 
 string
@@ -104,6 +111,24 @@ void
 PrintNode(std::ostream& os, const ValueNode& node, NodeToString node_to_str,
 	IndentGenerator igen, size_t depth)
 {
+	using fptr_t = string(*)(const ValueNode&);
+	using igen_t = string(*)(size_t);
+
+	if(const auto p_igen = igen.target<igen_t>())
+		if(*p_igen == DefaultGenerateIndent)
+			if(const auto p_to_str = node_to_str.target<fptr_t>())
+				if(*p_to_str == EscapeNodeLiteral
+					|| *p_to_str == LiteralizeEscapeNodeLiteral)
+				{
+					NodePrinter printer(os,
+						*p_to_str == LiteralizeEscapeNodeLiteral);
+
+					printer(node, depth);
+					// NOTE: Flush explicitly to propagate the exceptions, which
+					//	are ignored in the destructor.
+					printer.Flush();
+					return;
+				}
 	PrintIndent(os, igen, depth);
 	os << EscapeLiteral(DecodeNodeIndex(node.GetName())) << ' ';
 
@@ -136,6 +161,112 @@ PrintNodeString(std::ostream& os, const ValueNode& node,
 	return {};
 }
 
+//! \since build 955
+namespace
+{
+
+//! \brief 预先生成的缩进表：单位缩进为水平制表符。
+yconstexpr const char IndentTable[]{"\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+	"\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"};
+
+void
+AppendDecimal(string& dst, size_t n)
+{
+	char buf[std::numeric_limits<size_t>::digits10 + 1];
+	auto p(std::end(buf));
+
+	do
+	{
+		*--p = char('0' + n % 10);
+		n /= 10;
+	}while(n != 0);
+	dst.append(p, std::end(buf));
+}
+
+} // unnamed namespace;
+
+NodePrinter::NodePrinter(std::ostream& os, bool lit)
+	: Stream(os), LiteralizeString(lit)
+{
+	buffer.reserve(Threshold);
+}
+NodePrinter::~NodePrinter()
+{
+	YSLib::FilterExceptions([this]{
+		Flush();
+	}, yfsig);
+}
+
+void
+NodePrinter::operator()(const ValueNode& node, size_t depth)
+{
+	const auto& name(node.GetName());
+
+	PrintIndent(depth);
+	// NOTE: This is same to %EscapeLiteral applied on the result of
+	//	%DecodeNodeIndex, since the decimal representation is not escaped.
+	if(YSLib::IsDecodableIndex(name))
+		AppendDecimal(buffer, YSLib::DecodeIndex(name));
+	else
+		AppendEscapedLiteral(buffer, name);
+	buffer += ' ';
+	if(!PrintString(node) && node)
+		TraverseSubnodes([&](const ValueNode& nd){
+			if(YSLib::IsPrefixedIndex(nd.GetName()))
+			{
+				PrintIndent(depth);
+				PrintString(nd);
+			}
+			else
+				PrintContainedNodes([&](char b){
+					PrintIndent(depth);
+					buffer += b;
+					buffer += '\n';
+				}, [&]{
+					(*this)(nd, depth + 1);
+				});
+		}, node);
+	if(buffer.size() >= Threshold)
+		Flush();
+}
+
+void
+NodePrinter::Flush()
+{
+	// NOTE: The buffer is also cleared on failure, so the content is not
+	//	written again by the destructor.
+	const auto gd(ystdex::make_guard([this]() ynothrow{
+		buffer.clear();
+	}));
+
+	ystdex::write(Stream, buffer);
+}
+
+void
+NodePrinter::PrintIndent(size_t n)
+{
+	while(n != 0)
+	{
+		const auto k(std::min(n, sizeof(IndentTable) - 1));
+
+		buffer.append(IndentTable, k);
+		n -= k;
+	}
+}
+
+bool
+NodePrinter::PrintString(const ValueNode& node)
+{
+	// NOTE: As %PrintNodeString, the string is not printed if the value is not
+	//	a string.
+	const auto p(AccessPtr<string>(node));
+
+	if(p)
+		AppendEscapedLiteral(buffer, *p, LiteralizeString ? '"' : char());
+	buffer += '\n';
+	return bool(p);
+}
+
 
 string
 ParseNPLATermString(const TermNode& term)
@@ -265,11 +396,16 @@ MoveRValueFor(TermNode& term, TermNode& tm, bool(TermReference::*pm)() const)
 */
 struct AnchorData final
 {
-#if NPL_NPLA_CheckEnvironmentReferenceCount
 private:
+#if NPL_NPLA_CheckEnvironmentReferenceCount
 	//! \brief 环境引用计数。
 	mutable size_t env_count = 0;
 #endif
+	/*!
+	\brief 冻结状态。
+	\since build 955
+	*/
+	mutable bool frozen = {};
 
 public:
 	DefDeCtor(AnchorData)
@@ -277,8 +413,8 @@ public:
 
 	DefDeMoveAssignment(AnchorData)
 
-#if NPL_NPLA_CheckEnvironmentReferenceCount
-	DefGetter(const ynothrow, size_t, Count, env_count)
+	//! \since build 955
+	DefPred(const ynothrow, Frozen, frozen)
 
 	/*!
 	\brief 转换为锚对象内部数据的引用。
@@ -288,6 +424,13 @@ public:
 		ImplRet(YAssertNonnull(p),
 			NPL::Deref(YSLib::static_pointer_cast<const AnchorData>(p)))
 
+	//! \since build 955
+	PDefH(void, Freeze, ) const ynothrow
+		ImplExpr(frozen = true)
+
+#if NPL_NPLA_CheckEnvironmentReferenceCount
+	DefGetter(const ynothrow, size_t, Count, env_count)
+
 	PDefH(void, AddReference, ) const ynothrow
 		ImplExpr(++env_count)
 
@@ -415,6 +558,13 @@ TokenizeTerm(TermNode& term)
 }
 
 
+bool
+IsFrozenAnchor(const AnchorPtr& p) ynothrow
+{
+	return p && AnchorData::Access(p).IsFrozen();
+}
+
+
 #if NPL_NPLA_CheckTermReferenceIndirection
 TermNode&
 TermReference::get() const
@@ -818,6 +968,318 @@ ReduceToReferenceAt(TermNode& term, TermNode& tm,
 }
 
 
+//! \since build 955
+namespace
+{
+
+YB_ATTR_nodiscard YB_PURE inline size_t
+HashBindingName(string_view id) ynothrow
+{
+	const auto h(BindingMap::hasher()(id));
+
+	// NOTE: The value 0 is reserved for empty slots in the index.
+	return h != 0 ? h : 1;
+}
+
+} // unnamed namespace;
+
+BindingMap&
+BindingMap::operator=(BindingMap&& m)
+{
+	if(container.get_allocator() == m.container.get_allocator())
+	{
+		container.swap(m.container);
+		index.swap(m.index);
+	}
+	else
+	{
+		// XXX: The elements are moved individually, so the positions in the
+		//	index are rebuilt.
+		container.clear();
+		for(auto& pr : m.container)
+			container.emplace_back(std::piecewise_construct,
+				NPL::forward_as_tuple(pr.first),
+				NPL::forward_as_tuple(std::move(pr.second)));
+		Reindex();
+	}
+	p_base.swap(m.p_base);
+	std::swap(copied, m.copied);
+	m.clear();
+	++revision;
+	return *this;
+}
+
+void
+BindingMap::clear() ynothrow
+{
+	index.clear();
+	container.clear();
+	p_base.reset();
+	copied = 0;
+	++revision;
+}
+
+BindingMap::iterator
+BindingMap::erase(const_iterator i)
+{
+	YAssert(i != container.cend(), "Invalid iterator found.");
+	// NOTE: The removed element shall not be copied from the base map again.
+	Materialize();
+	if(!index.empty())
+	{
+		const size_t mask(index.size() - 1);
+		size_t n(HashBindingName(i->first) & mask);
+
+		while(index[n].Hash == 0 || index[n].Position != i)
+		{
+			YAssert(index[n].Hash != 0, "Invalid index found.");
+			n = (n + 1) & mask;
+		}
+		// NOTE: This is the backward shift deletion to keep the probe
+		//	sequences without tombstones.
+		for(size_t j(n); ; )
+		{
+			j = (j + 1) & mask;
+			if(index[j].Hash == 0)
+				break;
+
+			const size_t k(index[j].Hash & mask);
+
+			if(n <= j ? k <= n || k > j : k <= n && k > j)
+			{
+				index[n] = index[j];
+				n = j;
+			}
+		}
+		index[n] = Slot();
+	}
+	++revision;
+	return container.erase(i);
+}
+BindingMap::iterator
+BindingMap::erase(const_iterator first, const_iterator last)
+{
+	while(first != last)
+		first = erase(first);
+	return container.erase(last, last);
+}
+BindingMap::size_type
+BindingMap::erase(string_view id)
+{
+	const auto i(find(id));
+
+	if(i != container.end())
+	{
+		erase(i);
+		return 1;
+	}
+	return 0;
+}
+
+BindingMap::iterator
+BindingMap::find(string_view id)
+{
+	YAssertNonnull(id.data());
+
+	const size_t h(HashBindingName(id));
+	const auto i(FindLocal(id, h));
+
+	if(i != container.end() || !p_base)
+		return i;
+
+	const auto j(p_base->find(id));
+
+	// NOTE: The element is copied on the first access, since the caller can
+	//	modify the element through the result.
+	return j != p_base->cend() ? CopyBase(*j, h) : container.end();
+}
+BindingMap::const_iterator
+BindingMap::find(string_view id) const
+{
+	return const_cast<BindingMap&>(*this).find(id);
+}
+
+shared_ptr<const BindingMap>
+BindingMap::Share() const
+{
+	auto p(YSLib::allocate_shared<BindingMap>(get_allocator(), *this));
+
+	p->Materialize();
+	return p;
+}
+
+BindingMap::iterator
+BindingMap::CopyBase(const_reference pr, size_t h)
+{
+	container.emplace_back(pr);
+
+	const auto i(std::prev(container.end()));
+
+	IndexLast(i, h);
+	++copied;
+	return i;
+}
+
+BindingMap::iterator
+BindingMap::FindLocal(string_view id, size_t h) ynothrowv
+{
+	if(index.empty())
+		return std::find_if(container.begin(), container.end(),
+			[&](const value_type& pr) ynothrow{
+			return string_view(pr.first) == id;
+		});
+
+	const size_t mask(index.size() - 1);
+
+	for(size_t n(h & mask); index[n].Hash != 0; n = (n + 1) & mask)
+		if(index[n].Hash == h && string_view(index[n].Position->first) == id)
+			return index[n].Position;
+	return container.end();
+}
+
+void
+BindingMap::IndexLast(iterator i, size_t h)
+{
+	YAssert(i != container.end() && std::next(i) == container.end(),
+		"Invalid position found.");
+	if(!index.empty() && container.size() * 2 <= index.size())
+	{
+		const size_t mask(index.size() - 1);
+		size_t n(h & mask);
+
+		while(index[n].Hash != 0)
+			n = (n + 1) & mask;
+		index[n] = {h, i};
+	}
+	else if(container.size() > IndexThreshold)
+		try
+		{
+			Reindex();
+		}
+		catch(...)
+		{
+			container.erase(i);
+			throw;
+		}
+}
+
+pair<BindingMap::iterator, bool>
+BindingMap::Insert(iterator i)
+{
+	YAssert(i != container.end() && std::next(i) == container.end(),
+		"Invalid position found.");
+
+	const string_view id(i->first);
+	const size_t h(HashBindingName(id));
+	// NOTE: The new element is not indexed yet, so it is only found by the
+	//	linear search if there is no other element with the same key.
+	const auto j(FindLocal(id, h));
+
+	if(j != i && j != container.end())
+	{
+		container.erase(i);
+		return {j, false};
+	}
+	if(p_base)
+	{
+		const auto k(p_base->find(id));
+
+		if(k != p_base->cend())
+		{
+			// NOTE: The new element is removed first to keep the copied
+			//	element last for %IndexLast.
+			container.erase(i);
+			return {CopyBase(*k, h), false};
+		}
+	}
+	IndexLast(i, h);
+	++revision;
+	return {i, true};
+}
+
+void
+BindingMap::Materialize() const
+{
+	if(p_base)
+	{
+		// XXX: The elements are logically unchanged, as %find.
+		auto& m(const_cast<BindingMap&>(*this));
+		auto& con(m.container);
+		container_type copies(con.get_allocator());
+
+		// NOTE: The elements are copied before any modification to the
+		//	container for the strong exception safety guarantee.
+		for(const auto& pr : *p_base)
+			if(m.FindLocal(pr.first, HashBindingName(pr.first)) == con.end())
+				copies.push_back(pr);
+
+		auto new_index(m.MakeIndex(con.size() + copies.size()));
+		auto pos(con.begin());
+
+		// NOTE: The order of elements in the base map is kept. The elements
+		//	in the container are spliced, so the iterators and references are
+		//	not invalidated.
+		for(const auto& pr : *p_base)
+		{
+			const auto i(m.FindLocal(pr.first, HashBindingName(pr.first)));
+
+			if(i == con.end())
+				con.splice(pos, copies, copies.begin());
+			else if(i == pos)
+				++pos;
+			else
+				con.splice(pos, con, i);
+		}
+		m.FillIndex(new_index);
+		m.index.swap(new_index);
+		m.p_base.reset();
+		m.copied = 0;
+	}
+}
+
+vector<BindingMap::Slot>
+BindingMap::MakeIndex(size_t s) const
+{
+	if(s > IndexThreshold)
+	{
+		size_t n(IndexThreshold * 4);
+
+		while(n < s * 4)
+			n <<= 1;
+		return vector<Slot>(n, Slot(), index.get_allocator());
+	}
+	return vector<Slot>(index.get_allocator());
+}
+
+void
+BindingMap::FillIndex(vector<Slot>& new_index) ynothrow
+{
+	if(!new_index.empty())
+	{
+		const size_t mask(new_index.size() - 1);
+
+		for(auto i(container.begin()); i != container.end(); ++i)
+		{
+			const size_t h(HashBindingName(i->first));
+			size_t k(h & mask);
+
+			while(new_index[k].Hash != 0)
+				k = (k + 1) & mask;
+			new_index[k] = {h, i};
+		}
+	}
+}
+
+void
+BindingMap::Reindex()
+{
+	auto new_index(MakeIndex(container.size()));
+
+	FillIndex(new_index);
+	index.swap(new_index);
+}
+
+
 #if NPL_NPLA_CheckEnvironmentReferenceCount
 Environment::~Environment()
 {
@@ -894,10 +1356,19 @@ Environment::CheckParent(const ValueObject& vo)
 bool
 Environment::Deduplicate(BindingMap& dst, const BindingMap& src)
 {
-	for(const auto& binding : src)
-		// XXX: Non-trivially destructible objects is treated same.
-		// NOTE: Redirection is not needed here.
-		dst.erase(binding.first);
+	// XXX: Non-trivially destructible objects is treated same.
+	// NOTE: Redirection is not needed here.
+	if(dst.size() < src.size())
+	{
+		for(auto i(dst.begin()); i != dst.end(); )
+			if(src.find(i->first) != src.cend())
+				i = dst.erase(i);
+			else
+				++i;
+	}
+	else
+		for(const auto& binding : src)
+			dst.erase(binding.first);
 	// NOTE: If the resulted parent environment is empty, it is safe to be
 	//	removed.
 	return dst.empty();
@@ -933,6 +1404,13 @@ Environment::InitAnchor() const
 	return YSLib::allocate_shared<AnchorData>(Bindings.get_allocator());
 }
 
+void
+Environment::Freeze() ynothrow
+{
+	Frozen = true;
+	AnchorData::Access(p_anchor).Freeze();
+}
+
 Environment::NameResolution::first_type
 Environment::LookupName(string_view id) const
 {
@@ -942,13 +1420,28 @@ Environment::LookupName(string_view id) const
 		Bindings.find(id), {}, Bindings.cend()));
 }
 
+shared_ptr<const Environment::BindingMap>
+Environment::ShareBindings() const
+{
+	// NOTE: The bound objects of the frozen environment cannot be modified
+	//	through references, including the ones obtained before the environment
+	//	is frozen (see %Freeze), so the copy is valid until the revision is
+	//	changed.
+	if(Frozen)
+	{
+		if(!p_shared || shared_revision != Bindings.GetRevision())
+			yunseq(p_shared = Bindings.Share(),
+				shared_revision = Bindings.GetRevision());
+		return p_shared;
+	}
+	return Bindings.Share();
+}
+
 bool
 Environment::Remove(string_view id)
 {
 	YAssertNonnull(id.data());
-	// XXX: %BindingMap does not have transparent key %erase. This is like
-	//	%std::set.
-	return ystdex::erase_first(Bindings, id);
+	return Bindings.erase(id) != 0;
 }
 
 void
@@ -1008,9 +1501,382 @@ EnvironmentReference::ReferenceEnvironmentAnchor()
 #endif
 
 
+namespace
+{
+
+//! \since build 955
+ythread EnvironmentCollector* p_active_collector;
+
+} // unnamed namespace;
+
+//! \since build 955
+struct EnvironmentCollector::TraceState final
+{
+	struct Node final
+	{
+		shared_ptr<Environment> Pointer;
+		//! \brief 被统计的强引用数。
+		size_t Strong;
+		//! \brief 被统计的锚对象引用数。
+		size_t Anchors;
+		//! \brief 被统计的引用的目标的索引。
+		vector<size_t> Edges;
+		bool Live;
+	};
+
+	vector<Node> Nodes{};
+	YSLib::unordered_map<const void*, size_t> Environments{};
+	YSLib::unordered_map<const void*, size_t> Anchors{};
+	//! \brief 已被统计的引用的地址，用于排除被多个路径访问的引用的重复计数。
+	YSLib::unordered_set<const void*> Counted{};
+	size_t Current = 0;
+
+	void
+	Add(shared_ptr<Environment> p_env)
+	{
+		const auto idx(Nodes.size());
+		auto& env(*p_env);
+
+		Environments.emplace(&env, idx);
+		if(const auto& p_anchor = env.GetAnchorPtr())
+			Anchors.emplace(p_anchor.get(), idx);
+		Nodes.push_back({std::move(p_env), 0, {}, {}, {}});
+	}
+
+	void
+	AddReference(YSLib::unordered_map<const void*, size_t>& m, const void* p,
+		const void* p_ref, size_t Node::*p_count)
+	{
+		const auto i(m.find(p));
+
+		if(i != m.cend())
+		{
+			auto& nd(Nodes[i->second]);
+
+			if(Counted.insert(p_ref).second)
+				++(nd.*p_count);
+			Nodes[Current].Edges.push_back(i->second);
+		}
+	}
+};
+
+EnvironmentCollector::~EnvironmentCollector()
+{
+	if(p_active_collector == this)
+		p_active_collector = {};
+}
+
+void
+EnvironmentCollector::Add(const shared_ptr<Environment>& p_env)
+{
+	if(p_env)
+	{
+		// NOTE: The storage of the environment is not released until all weak
+		//	pointers are released since it is usually allocated with the
+		//	control block, so the expired pointers are removed periodically.
+		//	The threshold is doubled to make the cost of removal amortized.
+		if(tracked.size() >= std::max(last_size * 2, size_t(64)))
+		{
+			tracked.erase(std::remove_if(tracked.begin(), tracked.end(),
+				std::mem_fn(&weak_ptr<Environment>::expired)), tracked.end());
+			last_size = tracked.size();
+		}
+		tracked.push_back(p_env);
+		++allocated;
+		if(Threshold != 0 && allocated >= Threshold)
+			Collect();
+	}
+}
+
+size_t
+EnvironmentCollector::Collect()
+{
+	if(p_state)
+		return 0;
+
+	TraceState st;
+
+	allocated = 0;
+	for(const auto& p_weak : tracked)
+		if(auto p_env = p_weak.lock())
+			st.Add(std::move(p_env));
+	tracked.clear();
+	p_state = make_observer(&st);
+
+	const auto gd(ystdex::make_guard([this]() ynothrow{
+		p_state = {};
+	}));
+	const auto n(st.Nodes.size());
+
+	// NOTE: Count the references held by the tracked environments.
+	for(size_t i(0); i != n; ++i)
+	{
+		const auto& env(*st.Nodes[i].Pointer);
+
+		st.Current = i;
+		Visit(env.Parent);
+		// NOTE: The elements only in the base map are not traced, as the
+		//	values not owned uniquely. This also avoids copying them.
+		env.Bindings.ForEachLocal(
+			[this](const BindingMap::value_type& pr){
+			Visit(pr.second);
+		});
+	}
+
+	vector<size_t> pending;
+
+	// NOTE: The environments having the references not counted are roots.
+	//	Each node holds one more strong reference in %st.Nodes, and each
+	//	environment holds one more reference to its anchor.
+	for(size_t i(0); i != n; ++i)
+	{
+		auto& nd(st.Nodes[i]);
+
+		if(size_t(nd.Pointer.use_count()) > nd.Strong + 1
+			|| nd.Pointer->GetAnchorCount() > nd.Anchors + 1)
+		{
+			nd.Live = true;
+			pending.push_back(i);
+		}
+	}
+	while(!pending.empty())
+	{
+		const auto i(pending.back());
+
+		pending.pop_back();
+		for(const auto j : st.Nodes[i].Edges)
+			if(!st.Nodes[j].Live)
+			{
+				st.Nodes[j].Live = true;
+				pending.push_back(j);
+			}
+	}
+
+	size_t cnt(0), bytes(0);
+
+	// NOTE: All environments are kept alive by %st.Nodes until the bindings
+	//	and parents of all unreachable environments are released, so no
+	//	environment is destroyed before all cycles are broken.
+	for(auto& nd : st.Nodes)
+		if(nd.Live)
+			tracked.push_back(nd.Pointer);
+		else
+		{
+			auto& env(*nd.Pointer);
+			Environment::BindingMap m(env.Bindings.get_allocator());
+
+			++cnt;
+			bytes += sizeof(Environment) + env.Bindings.size()
+				* sizeof(Environment::BindingMap::value_type);
+			// NOTE: This also invalidates the cached resolution results.
+			swap(m, env.Bindings);
+			env.Parent = ValueObject();
+		}
+	last_size = tracked.size();
+	st.Nodes.clear();
+	++stats.Collections;
+	stats.Environments += cnt;
+	stats.Bytes += bytes;
+	return bytes;
+}
+
+observer_ptr<EnvironmentCollector>
+EnvironmentCollector::GetActive() ynothrow
+{
+	return make_observer(p_active_collector);
+}
+
+observer_ptr<EnvironmentCollector>
+EnvironmentCollector::SwitchActive(observer_ptr<EnvironmentCollector> p)
+	ynothrow
+{
+	return make_observer(ystdex::exchange(p_active_collector, p.get()));
+}
+
+shared_ptr<Environment>
+EnvironmentCollector::Track(shared_ptr<Environment> p_env)
+{
+	if(YB_UNLIKELY(p_active_collector))
+		p_active_collector->Add(p_env);
+	return p_env;
+}
+
+void
+EnvironmentCollector::Visit(const ValueObject& vo)
+{
+	YAssert(p_state, "Invalid state found.");
+	// NOTE: Objects not owned uniquely are not traced, so the references in
+	//	them are treated as external conservatively.
+	if(vo.OwnsCount() == 1)
+	{
+		auto& st(*p_state);
+
+		if(const auto p = vo.AccessPtr<shared_ptr<Environment>>())
+			st.AddReference(st.Environments, p->get(), p.get(),
+				&TraceState::Node::Strong);
+		else if(const auto p_ref = vo.AccessPtr<EnvironmentReference>())
+			st.AddReference(st.Anchors, p_ref->GetAnchorPtr().get(),
+				&p_ref->GetAnchorPtr(), &TraceState::Node::Anchors);
+		else if(const auto p_term_ref = vo.AccessPtr<TermReference>())
+		{
+			const auto& r_env(p_term_ref->GetEnvironmentReference());
+
+			st.AddReference(st.Anchors, r_env.GetAnchorPtr().get(),
+				&r_env.GetAnchorPtr(), &TraceState::Node::Anchors);
+		}
+		else if(const auto p_envs = vo.AccessPtr<EnvironmentList>())
+			for(const auto& v : *p_envs)
+				Visit(v);
+		else if(Trace)
+			Trace(vo, *this);
+	}
+}
+void
+EnvironmentCollector::Visit(const TermNode& term)
+{
+	Visit(term.Value);
+	for(const auto& sub : term)
+		Visit(sub);
+}
+
+
+Environment::NameResolution::first_type
+NameResolutionCache::Lookup(const shared_ptr<Environment>& p_env, size_t depth,
+	string_view id, Statistics& stat)
+{
+	YAssertNonnull(p_env);
+	YAssert(depth < MaxDepth, "Invalid depth found.");
+
+	auto& entry(entries[depth]);
+	const auto rev(p_env->Bindings.GetRevision());
+
+	// NOTE: The owner is compared by the control block, which is kept alive by
+	//	the weak pointer, so it cannot be reused by another environment.
+	if(!entry.Owner.expired() && !entry.Owner.owner_before(p_env)
+		&& !p_env.owner_before(entry.Owner) && entry.Revision == rev)
+	{
+		++stat.Hits;
+		return entry.Binding;
+	}
+	++stat.Misses;
+
+	const auto p(p_env->LookupName(id));
+
+	entry.Owner = p_env;
+	entry.Revision = rev;
+	entry.Binding = p;
+	return p;
+}
+
+
+namespace
+{
+
+//! \since build 955
+static_assert(ReducerFrameResource::MaxBlockSize
+	+ ReducerFrameResource::Granularity <= ReducerFrameResource::ChunkSize,
+	"Invalid chunk size found.");
+
+//! \since build 955
+YB_ATTR_nodiscard YB_STATELESS yconstfn
+	PDefH(bool, IsPooledFrameRequest, size_t bytes, size_t alignment) ynothrow
+	ImplRet(bytes != 0 && bytes <= ReducerFrameResource::MaxBlockSize
+		&& alignment <= ReducerFrameResource::Granularity)
+
+} // unnamed namespace;
+
+ReducerFrameResource::~ReducerFrameResource()
+{
+	release();
+}
+
+void
+ReducerFrameResource::release() ynothrow
+{
+	while(chunks)
+	{
+		const auto p_chunk(chunks);
+
+		chunks = p_chunk->Next;
+		upstream.get().deallocate(p_chunk, p_chunk->Size, Granularity);
+	}
+	free_lists.fill({});
+}
+
+void*
+ReducerFrameResource::do_allocate(size_t bytes, size_t alignment)
+{
+	++stats.Allocations;
+	if(IsPooledFrameRequest(bytes, alignment))
+	{
+		const auto idx((bytes - 1) / Granularity);
+		auto& p_free(free_lists[idx]);
+
+		if(!p_free)
+			Refill(idx);
+
+		const auto p(p_free);
+
+		p_free = p->Next;
+		return p;
+	}
+	++stats.UpstreamAllocations;
+	return upstream.get().allocate(bytes, alignment);
+}
+
+void
+ReducerFrameResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	if(IsPooledFrameRequest(bytes, alignment))
+	{
+		auto& p_free(free_lists[(bytes - 1) / Granularity]);
+
+		p_free = ::new(p) Block{p_free};
+	}
+	else
+		upstream.get().deallocate(p, bytes, alignment);
+}
+
+bool
+ReducerFrameResource::do_is_equal(const memory_resource& other) const ynothrow
+{
+	return this == &other;
+}
+
+void
+ReducerFrameResource::Refill(size_t idx)
+{
+	static_assert(sizeof(Chunk) <= Granularity, "Invalid granularity found.");
+	YAssert(idx < free_lists.size(), "Invalid size class found.");
+
+	const auto size((idx + 1) * Granularity);
+	auto n((ChunkSize - Granularity) / size);
+	const auto chunk_size(Granularity + n * size);
+	const auto p_chunk(::new(upstream.get().allocate(chunk_size, Granularity))
+		Chunk{chunks, chunk_size});
+	auto& p_free(free_lists[idx]);
+	// NOTE: The blocks are linked in the reversed order to make the following
+	//	allocations in the increasing order of addresses.
+	auto p(static_cast<byte*>(static_cast<void*>(p_chunk)) + chunk_size);
+
+	++stats.UpstreamAllocations;
+	chunks = p_chunk;
+	while(n-- != 0)
+	{
+		p -= size;
+		p_free = ::new(p) Block{p_free};
+	}
+}
+
+
 ContextNode::ContextNode(pmr::memory_resource& rsrc)
 	: memory_rsrc(rsrc)
 {}
+ContextNode::ContextNode(pmr::memory_resource& rsrc,
+	pmr::memory_resource& frame_rsrc)
+	: memory_rsrc(rsrc),
+	current(ReducerSequence::allocator_type(&frame_rsrc))
+{}
 ContextNode::ContextNode(const ContextNode& ctx,
 	shared_ptr<Environment>&& p_rec)
 	: memory_rsrc(ctx.memory_rsrc), p_record([&]{
@@ -1027,7 +1893,8 @@ ContextNode::ContextNode(const ContextNode& ctx)
 	LastStatus(ctx.LastStatus), Trace(ctx.Trace)
 {}
 ContextNode::ContextNode(ContextNode&& ctx) ynothrow
-	: ContextNode(ctx.memory_rsrc)
+	: ContextNode(ctx.memory_rsrc,
+	NPL::Deref(ctx.GetFrameAllocator().resource()))
 {
 	swap(ctx, *this);
 }
@@ -1064,8 +1931,13 @@ ContextNode::DefaultHandleException(std::exception_ptr p)
 		std::throw_with_nested(TypeError(MismatchedTypesToString(e))))
 }
 
+//! \since build 955
+namespace
+{
+
+template<typename _fLookup>
 Environment::NameResolution
-ContextNode::DefaultResolve(shared_ptr<Environment> p_env, string_view id)
+ResolveDefault(shared_ptr<Environment> p_env, string_view id, _fLookup lookup)
 {
 	YAssertNonnull(p_env);
 
@@ -1142,13 +2014,52 @@ ContextNode::DefaultResolve(shared_ptr<Environment> p_env, string_view id)
 			return bool(p_redirected);
 		}
 		return false;
-	}, [&, id]{
-		return p_env->LookupName(id);
+	}, [&]{
+		return lookup(p_env);
 	}));
 
 	return {p_obj, std::move(p_env)};
 }
 
+} // unnamed namespace;
+
+Environment::NameResolution
+ContextNode::DefaultResolve(shared_ptr<Environment> p_env, string_view id)
+{
+	return ResolveDefault(std::move(p_env), id,
+		[id](const shared_ptr<Environment>& p){
+		return p->LookupName(id);
+	});
+}
+
+Environment::NameResolution
+ContextNode::ResolveCached(shared_ptr<Environment> p_env, string_view id,
+	NameResolutionCache& cache, NameResolutionCache::Statistics& stat) const
+{
+	using fp_t = Environment::NameResolution(*)(shared_ptr<Environment>,
+		string_view);
+
+	YAssertNonnull(id.data());
+	if(const auto p_resolve = Resolve.target<fp_t>())
+		if(*p_resolve == DefaultResolve)
+		{
+			size_t depth(0);
+
+			// NOTE: The first environment is not cached, since it is usually
+			//	the fresh local environment created by the call.
+			return ResolveDefault(std::move(p_env), id,
+				[&](const shared_ptr<Environment>& p)
+				-> Environment::NameResolution::first_type{
+				const auto n(depth++);
+
+				if(n == 0 || n > NameResolutionCache::MaxDepth)
+					return p->LookupName(id);
+				return cache.Lookup(p, n - 1, id, stat);
+			});
+		}
+	return Resolve(std::move(p_env), id);
+}
+
 ReductionStatus
 ContextNode::RewriteLoop()
 {
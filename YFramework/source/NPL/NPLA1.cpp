@@ -11,13 +11,13 @@
 /*!	\file NPLA1.cpp
 \ingroup NPL
 \brief NPLA1 公共接口。
-\version r23927
+\version r23939
 \author FrankHB <frankhb1989@gmail.com>
 \since build 472
 \par 创建时间:
 	2014-02-02 18:02:47 +0800
 \par 修改时间:
-	2022-09-14 02:53 +0800
+	2026-10-17 16:32 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -49,7 +49,9 @@
 //	ystdex::unique_guard, CategorizeBasicLexeme, DeliteralizeUnchecked,
 //	Deliteralize, IsLeaf, TryAccessTerm, YSLib::share_move,
 //	ystdex::call_value_or, std::piecewise_construct, type_id, make_observer,
-//	YSLib::Notice, YSLib::FilterException, Session;
+//	YSLib::Notice, YSLib::FilterException, Session, NameResolutionCache,
+//	observer_ptr, YSLib::allocate_shared, PureCombinerTable, ContextHandler,
+//	ystdex::insert_or_assign, IsBranchedList;
 #include "NPLA1Internals.h" // for A1::Internals API;
 #include YFM_NPL_NPLAMath // for ReadDecimal;
 #include <limits> // for std::numeric_limits;
@@ -260,6 +262,52 @@ ReduceChildrenOrderedAsync(TNIter first, TNIter last, ContextNode& ctx)
 #endif
 
 
+//! \since build 955
+//@{
+//! \brief 取剖析器记录的合并子名称。
+YB_ATTR_nodiscard YB_PURE string_view
+GetProfiledName(const ContextState& cs, TermNode& term) ynothrow
+{
+	const auto p(cs.TryGetTailOperatorName(term));
+
+	return p ? string_view(*p) : string_view("#<anonymous>");
+}
+
+#if NPL_Impl_NPLA1_Enable_Thunked
+/*!
+\brief 记录合并子调用，并设置退出记录的动作。
+\pre 剖析器指针非空。
+\pre 规约合并项未被清除。
+*/
+void
+ProfileCombine(ContextState& cs, TermNode& term)
+{
+	const auto& p_profiler(cs.ProfilerPtr);
+	const auto name(GetProfiledName(cs, term));
+
+#	if NPL_Impl_NPLA1_Enable_TCO
+	// NOTE: A call in a tail context reuses the TCO action of the caller, so it
+	//	has no action to exit the record and the record is exited with the
+	//	caller's. Otherwise, the action to exit the record is set before the
+	//	TCO action created later by %EnsureTCOAction, so the TCO of the callee
+	//	is still effective.
+	if(AccessTCOAction(cs))
+	{
+		p_profiler->Replace(name);
+		return;
+	}
+#	endif
+	const auto depth(p_profiler->Enter(name));
+
+	cs.SetupFront(A1::NameTypedReducerHandler(
+		[p_profiler, depth](ContextNode& ctx) ynothrow{
+		p_profiler->Exit(depth);
+		return ctx.LastStatus;
+	}, "profile-return"));
+}
+#endif
+//@}
+
 //! \since build 821
 template<typename... _tParams>
 ReductionStatus
@@ -268,10 +316,16 @@ CombinerReturnThunk(const ContextHandler& h, TermNode& term, ContextNode& ctx,
 {
 	// NOTE: See $2021-01 @ %Documentation::Workflow.
 	static_assert(sizeof...(args) < 2, "Unsupported owner arguments found.");
+	auto& cs(ContextState::Access(ctx));
+
+#if NPL_Impl_NPLA1_Enable_Thunked
+	if(YB_UNLIKELY(cs.ProfilerPtr))
+		ProfileCombine(cs, term);
+#endif
 #if NPL_Impl_NPLA1_Enable_TCO
 	auto& act(EnsureTCOAction(ctx, term));
 
-	ContextState::Access(ctx).ClearCombiningTerm();
+	cs.ClearCombiningTerm();
 	SetupNextTerm(ctx, term);
 	// XXX: %A1::RelayCurrentOrDirect is not used to allow the call to the
 	//	underlying handler implementation (e.g. %FormContextHandler::CallN)
@@ -280,8 +334,17 @@ CombinerReturnThunk(const ContextHandler& h, TermNode& term, ContextNode& ctx,
 	return
 		RelaySwitched(ctx, Continuation(act.Attach(h, yforward(args)...), ctx));
 #else
+#	if !NPL_Impl_NPLA1_Enable_Thunked
+	const auto p_profiler(cs.ProfilerPtr);
+	const auto depth(p_profiler
+		? p_profiler->Enter(GetProfiledName(cs, term)) : 0);
+	const auto pgd(ystdex::make_guard([&]() ynothrow{
+		if(p_profiler)
+			p_profiler->Exit(depth);
+	}));
+#	endif
 
-	ContextState::Access(ctx).ClearCombiningTerm();
+	cs.ClearCombiningTerm();
 
 	auto gd(ystdex::unique_guard([&]() ynothrow{
 		// XXX: This term is fixed, as in the term cleanup in %TCOAction.
@@ -485,6 +548,241 @@ public:
 //@}
 
 
+//! \since build 955
+//@{
+using NameCacheMetadata = lref<NameResolutionCache>;
+
+//! \brief 名称解析缓存的查询参数。
+yconstexpr const uintmax_t NameCacheQuery(1);
+
+
+//! \brief 常量折叠缓存。
+struct ConstantFoldCache final
+{
+	using Guard = pair<TokenValue, ContextHandler>;
+
+	/*!
+	\brief 守卫：被折叠的项中的合并子名称和预期的处理器。
+	\invariant 名称互不相同。
+	*/
+	vector<Guard> Guards;
+	//! \brief 被保存的值。
+	TermNode Value;
+	//! \brief 是否已保存值。
+	bool Folded = {};
+	//! \brief 是否因结果不能被保存而不再尝试折叠。
+	bool Rejected = {};
+
+	ConstantFoldCache(TermNode::allocator_type a)
+		: Guards(a), Value(a)
+	{}
+
+	//! \brief 添加不重复的守卫。
+	void
+	AddGuard(const Guard& gd)
+	{
+		if(std::none_of(Guards.cbegin(), Guards.cend(),
+			[&](const Guard& x) ynothrow{
+			return x.first == gd.first;
+		}))
+			Guards.push_back(gd);
+	}
+
+	//! \brief 检查守卫：判断所有名称在上下文的当前环境中解析的对象是预期的合并子。
+	YB_ATTR_nodiscard bool
+	Check(const ContextNode& ctx) const
+	{
+		return std::all_of(Guards.cbegin(), Guards.cend(),
+			[&](const Guard& gd){
+			const auto pr(ResolveName(ctx, gd.first));
+
+			if(pr.first)
+				if(const auto p
+					= TryAccessLeafAtom<const ContextHandler>(ReferenceTerm(
+					*pr.first)))
+					return *p == gd.second;
+			return false;
+		});
+	}
+};
+
+// XXX: The cache is shared to keep it alive during the evaluation of the
+//	annotated term, as the operator would be replaced by the evaluated result.
+using ConstantFoldMetadata = shared_ptr<ConstantFoldCache>;
+
+//! \brief 常量折叠缓存的查询参数。
+yconstexpr const uintmax_t ConstantFoldQuery(2);
+
+//! \brief 取项的值上标注的常量折叠缓存。
+YB_ATTR_nodiscard YB_PURE shared_ptr<ConstantFoldCache>
+QueryConstantFold(const TermNode& term)
+{
+	const auto val(term.Value.Query(ConstantFoldQuery));
+
+	if(const auto p = val.try_get_object_ptr<ConstantFoldMetadata>())
+		return *p;
+	return {};
+}
+
+//! \brief 判断项表示的值是否不包含引用值而可作为常量折叠的结果保存。
+YB_ATTR_nodiscard YB_PURE bool
+IsConstantFoldableValue(const TermNode& term)
+{
+	vector<lref<const TermNode>> remained(term.get_allocator());
+
+	remained.push_back(term);
+	while(!remained.empty())
+	{
+		const auto& tm(remained.back().get());
+
+		remained.pop_back();
+		if(IsTyped<TermReference>(tm))
+			return {};
+		for(const auto& t : tm)
+			remained.push_back(t);
+	}
+	return true;
+}
+
+
+template<typename _type, class _tByteAlloc = SourcedByteAllocator>
+class NameCachedHolder : public YSLib::AllocatorHolder<_type, _tByteAlloc>
+{
+public:
+	using Creation = YSLib::IValueHolder::Creation;
+	using value_type = _type;
+
+private:
+	using base = YSLib::AllocatorHolder<_type, _tByteAlloc>;
+
+	// XXX: The caches are shared by copies of the holder to keep them valid
+	//	after copying the term, e.g. in the call of combiners.
+	shared_ptr<NameResolutionCache> p_cache;
+	shared_ptr<ConstantFoldCache> p_fold;
+	SourceInformation source_information;
+	bool sourced;
+
+public:
+	using base::value;
+
+	template<typename... _tParams>
+	inline
+	NameCachedHolder(shared_ptr<NameResolutionCache> p,
+		observer_ptr<const SourceInformation> p_si, _tParams&&... args)
+		: NameCachedHolder(std::move(p), shared_ptr<ConstantFoldCache>(), p_si,
+		yforward(args)...)
+	{}
+	//! \pre 常量折叠缓存指针可为空。
+	template<typename... _tParams>
+	inline
+	NameCachedHolder(shared_ptr<NameResolutionCache> p,
+		shared_ptr<ConstantFoldCache> p_f,
+		observer_ptr<const SourceInformation> p_si, _tParams&&... args)
+		: base(yforward(args)...), p_cache(std::move(p)),
+		p_fold(std::move(p_f)), source_information(p_si ? *p_si
+		: SourceInformation()), sourced(bool(p_si))
+	{
+		YAssertNonnull(p_cache);
+	}
+	DefDeCopyMoveCtorAssignment(NameCachedHolder)
+
+	YB_ATTR_nodiscard any
+	Create(Creation c, const any& x) const ImplI(IValueHolder)
+	{
+		return YSLib::AllocatedHolderOperations<NameCachedHolder,
+			_tByteAlloc>::CreateHolder(c, x, value, NPL::forward_as_tuple(
+			p_cache, p_fold, GetSourceInformationPtr(),
+			ystdex::as_const(value)), NPL::forward_as_tuple(p_cache, p_fold,
+			GetSourceInformationPtr(), std::move(value)));
+	}
+
+private:
+	YB_ATTR_nodiscard YB_PURE PDefH(observer_ptr<const SourceInformation>,
+		GetSourceInformationPtr, ) const ynothrow
+		ImplRet(sourced ? make_observer(&source_information) : nullptr)
+
+public:
+	/*!
+	\note 参数为 NameCacheQuery 或 ConstantFoldQuery 时查询对应的缓存，
+		否则查询可能存在的源代码信息。
+	*/
+	YB_ATTR_nodiscard YB_PURE any
+	Query(uintmax_t n) const ynothrow ImplI(IValueHolder)
+	{
+		if(n == NameCacheQuery)
+			return NameCacheMetadata(*p_cache);
+		if(n == ConstantFoldQuery)
+			return p_fold ? any(ConstantFoldMetadata(p_fold)) : any();
+		if(sourced)
+			return ystdex::ref(source_information);
+		return {};
+	}
+
+	using base::get_allocator;
+};
+//@}
+
+/*!
+\brief 标注合并项的常量折叠缓存。
+\pre 可被折叠的子项已被标注。
+\since build 955
+*/
+void
+AnnotateConstantFoldingCombination(TermNode& term,
+	const PureCombinerTable& tbl)
+{
+	auto& fm(AccessFirstSubterm(term));
+
+	if(const auto p = TermToNamePtr(fm))
+	{
+		const auto i_comb(tbl.find(*p));
+
+		if(i_comb != tbl.cend() && !QueryConstantFold(fm))
+		{
+			const auto a(term.get_allocator());
+			auto p_fold(YSLib::allocate_shared<ConstantFoldCache>(a, a));
+
+			p_fold->AddGuard({*p, i_comb->second});
+			for(auto i(std::next(term.begin())); i != term.end(); ++i)
+			{
+				auto& o(*i);
+
+				// NOTE: Only literals not to be evaluated as identifiers and
+				//	annotated combinations are allowed as the operands.
+				if(IsLeaf(o))
+				{
+					if(TermToNamePtr(o))
+						return;
+				}
+				else if(IsBranchedList(o))
+				{
+					if(const auto p_sub = QueryConstantFold(
+						AccessFirstSubterm(o)))
+						for(const auto& gd : p_sub->Guards)
+							p_fold->AddGuard(gd);
+					else
+						return;
+				}
+				else
+					return;
+			}
+
+			// XXX: The value is copied since it is used to initialize the new
+			//	holder replacing the old one. The name resolution cache is
+			//	always provided as the holder replaces any existing one before
+			//	the evaluation.
+			TokenValue id(*p);
+			const auto p_si(QuerySourceInformation(fm.Value));
+
+			fm.SetValue(any_ops::use_holder,
+				in_place_type<NameCachedHolder<TokenValue>>,
+				YSLib::allocate_shared<NameResolutionCache>(a),
+				std::move(p_fold), p_si, std::move(id), a);
+		}
+	}
+}
+
+
 //! \since build 881
 class SeparatorPass
 {
@@ -1575,8 +1873,216 @@ ThrowValueCategoryError(const TermNode& term)
 }
 
 
+void*
+Profiler::CountingResource::do_allocate(size_t bytes, size_t alignment)
+{
+	const auto p(upstream.get().allocate(bytes, alignment));
+
+	++profiler.get().allocations;
+	return p;
+}
+
+void
+Profiler::CountingResource::do_deallocate(void* p, size_t bytes,
+	size_t alignment)
+{
+	upstream.get().deallocate(p, bytes, alignment);
+}
+
+bool
+Profiler::CountingResource::do_is_equal(const memory_resource& other) const
+	ynothrow
+{
+	return this == &other;
+}
+
+
+Profiler::Profiler()
+	// NOTE: The root node has no name.
+	: nodes({{size_t(-1), size_t(-1), {}, 0}})
+{}
+
+const Profiler::Entry*
+Profiler::Find(string_view name) const
+{
+	const auto i(name_index.find(name));
+
+	return i != name_index.cend() ? &entries[i->second] : nullptr;
+}
+
+size_t
+Profiler::Enter(string_view name)
+{
+	const auto now(Clock::now());
+
+	Update(now);
+	Push(Intern(name), now, {});
+	return frames.size();
+}
+
+void
+Profiler::Exit(size_t depth) ynothrow
+{
+	YAssert(depth != 0, "Invalid depth found.");
+	if(frames.size() >= depth)
+	{
+		const auto now(Clock::now());
+
+		Update(now);
+		while(frames.size() >= depth)
+			Pop(now);
+	}
+}
+
+void
+Profiler::Replace(string_view name)
+{
+	const auto now(Clock::now());
+	const auto id(Intern(name));
+
+	Update(now);
+	if(!frames.empty() && frames.back().Tail)
+		Pop(now);
+	Push(id, now, true);
+}
+
+void
+Profiler::PrintSummary(std::ostream& os) const
+{
+	vector<size_t> idxs;
+
+	idxs.reserve(entries.size());
+	for(size_t i(0); i != entries.size(); ++i)
+		idxs.push_back(i);
+	std::stable_sort(idxs.begin(), idxs.end(), [this](size_t x, size_t y){
+		return entries[x].Exclusive > entries[y].Exclusive;
+	});
+	os << ystdex::sfmt("%12s %16s %16s %12s  %s\n", "calls", "inclusive(us)",
+		"exclusive(us)", "allocations", "combiner");
+	for(const auto i : idxs)
+	{
+		const auto& e(entries[i]);
+
+		os << ystdex::sfmt("%12zu %16.3f %16.3f %12zu  %s\n", e.Calls,
+			double(e.Inclusive.count()) / 1000, double(e.Exclusive.count())
+			/ 1000, e.Allocations, names[i].c_str());
+	}
+}
+
+void
+Profiler::PrintCollapsedStacks(std::ostream& os) const
+{
+	vector<size_t> path;
+
+	for(size_t i(1); i < nodes.size(); ++i)
+	{
+		const auto us(nodes[i].Time.count() / 1000);
+
+		if(us > 0)
+		{
+			path.clear();
+			for(auto n(i); n != 0; n = nodes[n].Parent)
+				path.push_back(nodes[n].Name);
+			for(auto j(path.rbegin()); j != path.rend(); ++j)
+			{
+				if(j != path.rbegin())
+					os.put(';');
+				os << names[*j];
+			}
+			os << ' ' << us << '\n';
+		}
+	}
+}
+
+void
+Profiler::clear() ynothrow
+{
+	names.clear();
+	name_index.clear();
+	entries.clear();
+	nodes.resize(1);
+	children.clear();
+	frames.clear();
+	yunseq(nodes.front().Time = {}, nodes.front().Allocations = 0,
+		last_allocations = allocations);
+}
+
+size_t
+Profiler::Intern(string_view name)
+{
+	const auto i(name_index.find(name));
+
+	if(i != name_index.cend())
+		return i->second;
+
+	const auto id(names.size());
+
+	names.emplace_back(name.data(), name.size());
+	entries.emplace_back();
+	TryExpr(name_index.emplace(names.back(), id))
+	catch(...)
+	{
+		names.pop_back();
+		entries.pop_back();
+		throw;
+	}
+	return id;
+}
+
+void
+Profiler::Pop(TimePoint now) ynothrow
+{
+	YAssert(!frames.empty(), "Invalid state found.");
+
+	const auto& frame(frames.back());
+	auto& e(entries[frame.Name]);
+
+	YAssert(e.Active != 0, "Invalid state found.");
+	if(--e.Active == 0)
+		e.Inclusive += now - frame.Start;
+	frames.pop_back();
+}
+
+void
+Profiler::Push(size_t id, TimePoint now, bool tail)
+{
+	const auto parent(frames.empty() ? 0 : frames.back().Node);
+	const auto pr(children.emplace(std::make_pair(parent, id), nodes.size()));
+
+	if(pr.second)
+		TryExpr(nodes.push_back({parent, id, {}, 0}))
+		catch(...)
+		{
+			children.erase(pr.first);
+			throw;
+		}
+	frames.push_back({id, pr.first->second, now, tail});
+
+	auto& e(entries[id]);
+
+	yunseq(++e.Calls, ++e.Active);
+}
+
+void
+Profiler::Update(TimePoint now) ynothrow
+{
+	if(!frames.empty())
+	{
+		const auto& frame(frames.back());
+		const auto d(now - last);
+		const auto n(allocations - last_allocations);
+		auto& e(entries[frame.Name]);
+		auto& nd(nodes[frame.Node]);
+
+		yunseq(e.Exclusive += d, e.Allocations += n, nd.Time += d,
+			nd.Allocations += n);
+	}
+	yunseq(last = now, last_allocations = allocations);
+}
+
+
 ContextState::ContextState(const GlobalState& g)
-	: ContextNode(*g.Allocator.resource()),
+	: ContextNode(*g.Allocator.resource(), NPL::Deref(g.FrameResourcePtr)),
 	Global(g)
 {
 	// NOTE: The guard object shall be fresh on the calls for reentrancy.
@@ -1655,9 +2161,15 @@ ReductionStatus
 ContextState::RewriteGuarded(TermNode& term, Reducer reduce)
 {
 	const auto gd(Guard(term, *this));
-	const auto unwind(ystdex::make_guard([this]() ynothrow{
+	// NOTE: The records whose actions to exit are dropped (e.g. by exceptions
+	//	or the one-shot continuations) are exited here, so the stale records
+	//	are not left as the callers of the later calls.
+	const auto depth(ProfilerPtr ? ProfilerPtr->GetDepth() : 0);
+	const auto unwind(ystdex::make_guard([this, depth]() ynothrow{
 		TailAction = nullptr;
 		UnwindCurrent();
+		if(ProfilerPtr)
+			ProfilerPtr->Exit(depth + 1);
 	}));
 
 	return Rewrite(std::move(reduce));
@@ -2152,7 +2664,7 @@ DefaultEvaluateLeaf(TermNode& term, string_view id)
 	case '7':
 	case '8':
 	case '9':
-		ReadDecimal(term.Value, id, id.begin());
+		ReadDecimal(term.Value, id, id.begin(), term.get_allocator());
 		return ReductionStatus::Clean;
 	case '-':
 		if(YB_UNLIKELY(IsAllSignLexeme(id)))
@@ -2191,7 +2703,8 @@ DefaultEvaluateLeaf(TermNode& term, string_view id)
 			}
 		}
 		if(id.size() > 1)
-			ReadDecimal(term.Value, id, std::next(id.begin()));
+			ReadDecimal(term.Value, id, std::next(id.begin()),
+				term.get_allocator());
 		else
 			term.Value = 0;
 		return ReductionStatus::Clean;
@@ -2234,7 +2747,8 @@ DefaultEvaluateLeaf(TermNode& term, string_view id)
 		YB_ATTR_fallthrough;
 	case '0':
 		if(id.size() > 1)
-			ReadDecimal(term.Value, id, std::next(id.begin()));
+			ReadDecimal(term.Value, id, std::next(id.begin()),
+				term.get_allocator());
 		else
 			term.Value = 0;
 		return ReductionStatus::Clean;
@@ -2255,13 +2769,25 @@ EvaluateIdentifier(TermNode& term, const ContextNode& ctx, string_view id)
 	//	It would be safe if not passed directly and without rebinding. Note the
 	//	access of objects denoted by invalid references after rebinding would
 	//	cause undefined behavior in the object language.
-	auto pr(ResolveName(ctx, id));
+	auto& cs(ContextState::Access(ctx));
+	auto pr([&]{
+		const auto& global(cs.Global.get());
+
+		if(global.CacheNameResolution)
+		{
+			const auto val(term.Value.Query(NameCacheQuery));
+
+			if(const auto p_cache = val.try_get_object_ptr<NameCacheMetadata>())
+				return ctx.ResolveCached(ctx.GetRecordPtr(), id, p_cache->get(),
+					global.NameCacheStatistics);
+		}
+		return ResolveName(ctx, id);
+	}());
 
 	if(pr.first)
 	{
 		auto& bound(*pr.first);
 		TermNode* p_rterm;
-		auto& cs(ContextState::Access(ctx));
 
 		if(!cs.TrySetTailOperatorName(term))
 			cs.OperatorName.Clear();
@@ -2564,7 +3090,40 @@ SetupDefaultInterpretation(GlobalState& global, EvaluationPasses passes)
 		ReduceHeadEmptyList(term);
 		if(IsCombiningTerm(term))
 		{
-			ContextState::Access(ctx).SetCombiningTermRef(term);
+			auto& cs(ContextState::Access(ctx));
+
+			cs.SetCombiningTermRef(term);
+			// NOTE: See %AnnotateConstantFolding.
+			if(cs.Global.get().FoldConstants)
+				if(const auto p_fold
+					= QueryConstantFold(AccessFirstSubterm(term)))
+					if(!p_fold->Rejected && p_fold->Check(ctx))
+					{
+						if(p_fold->Folded)
+						{
+							term.SetContent(p_fold->Value);
+							return IsBranch(term) ? ReductionStatus::Retained
+								: ReductionStatus::Clean;
+						}
+						// NOTE: This is called after the combination is
+						//	reduced.
+						RelaySwitched(ctx, A1::NameTypedReducerHandler(
+							[&, p_fold]{
+							// NOTE: The term is not regularized yet if the
+							//	combiner returns %ReductionStatus::Clean.
+							const auto res(RegularizeTerm(term,
+								ctx.LastStatus));
+
+							if(IsConstantFoldableValue(term))
+							{
+								p_fold->Value.SetContent(term);
+								p_fold->Folded = true;
+							}
+							else
+								p_fold->Rejected = true;
+							return res;
+						}, "fold-constant"));
+					}
 			// NOTE: Asynchronous reduction on the 1st term is needed for the
 			//	continuation capture.
 			// XXX: Without %NPL_Impl_NPLA1_Enable_InlineDirect, the
@@ -2746,16 +3305,45 @@ TraceBacktrace(const ContextNode::ReducerSequence& backtrace,
 }
 
 
-GlobalState::GlobalState(pmr::memory_resource& rsrc)
-	: GlobalState([this](const GParsedValue<ByteParser>& str){
+//! \since build 955
+namespace
+{
+
+/*!
+\brief 默认的叶节点词素转换器。
+\note 词素仅在转换时被引用，因为 ParseLeaf 复制需要的内容。
+
+作为 GlobalState::ConvertLeaf 和 GlobalState::ConvertLeafSourced 的默认值。
+当它们未被替换时，引用输入的词素可直接被转换而不需复制。
+*/
+//@{
+struct DefaultLeafConverter final
+{
+	TermNode::allocator_type Allocator;
+
+	template<class _tString>
+	YB_ATTR_nodiscard TermNode
+	operator()(const _tString& str) const
+	{
 		TermNode term(Allocator);
 		const auto id(YSLib::make_string_view(str));
 
 		if(!id.empty())
 			ParseLeaf(term, id);
 		return term;
-	}, [this](const GParsedValue<SourcedByteParser>& val,
-		const ContextState& cs){
+	}
+};
+
+
+struct DefaultSourcedLeafConverter final
+{
+	TermNode::allocator_type Allocator;
+
+	template<class _tString>
+	YB_ATTR_nodiscard TermNode
+	operator()(const pair<SourceLocation, _tString>& val,
+		const ContextState& cs) const
+	{
 		TermNode term(Allocator);
 		const auto id(YSLib::make_string_view(val.second));
 
@@ -2763,7 +3351,15 @@ GlobalState::GlobalState(pmr::memory_resource& rsrc)
 			ParseLeafWithSourceInformation(term, id, cs.CurrentSource,
 				val.first);
 		return term;
-	}, rsrc)
+	}
+};
+//@}
+
+} // unnamed namespace;
+
+GlobalState::GlobalState(pmr::memory_resource& rsrc)
+	: GlobalState(DefaultLeafConverter{&rsrc},
+	DefaultSourcedLeafConverter{&rsrc}, rsrc)
 {}
 GlobalState::GlobalState(Tokenizer leaf_conv,
 	SourcedTokenizer sourced_leaf_conv, pmr::memory_resource& rsrc)
@@ -2774,6 +3370,33 @@ GlobalState::GlobalState(Tokenizer leaf_conv,
 	SetupDefaultInterpretation(*this, EvaluationPasses(Allocator));
 }
 
+TermNode
+GlobalState::LeafConverter::operator()(const GParsedValue<ViewByteParser>& val)
+	const
+{
+	const auto& global(Context.Global.get());
+
+	if(global.ConvertLeafView)
+		return global.ConvertLeafView(val);
+	if(const auto p_conv = global.ConvertLeaf.target<DefaultLeafConverter>())
+		return (*p_conv)(val);
+	return global.ConvertLeaf(string(val, global.Allocator));
+}
+TermNode
+GlobalState::LeafConverter::operator()(
+	const GParsedValue<SourcedViewByteParser>& val) const
+{
+	const auto& global(Context.Global.get());
+
+	if(global.ConvertLeafViewSourced)
+		return global.ConvertLeafViewSourced(val, Context);
+	if(const auto p_conv
+		= global.ConvertLeafSourced.target<DefaultSourcedLeafConverter>())
+		return (*p_conv)(val, Context);
+	return global.ConvertLeafSourced({val.first, string(val.second,
+		global.Allocator)}, Context);
+}
+
 bool
 GlobalState::IsAsynchronous() const ynothrow
 {
@@ -2870,18 +3493,11 @@ GlobalState::ReadFrom(LoadOptionTag<NoSourceInformation>, std::streambuf& buf,
 TermNode
 GlobalState::ReadFrom(LoadOptionTag<>, string_view unit, ContextState& cs) const
 {
-	YAssertNonnull(unit.data());
-
-	Session sess(cs.get_allocator());
-
-	if(UseSourceLocation)
-	{
-		SourcedByteParser parse(sess.Lexer, sess.get_allocator());
-
-		return Prepare(cs, sess, sess.Process(unit, ystdex::ref(parse)));
-	}
-	return Prepare(cs, sess, sess.Process(unit));
+	return UseSourceLocation
+		? ReadFrom(LoadOptionTag<WithSourceLocation>(), unit, cs)
+		: ReadFrom(LoadOptionTag<NoSourceInformation>(), unit, cs);
 }
+// NOTE: The parse results refer to %unit, which is alive during %Prepare.
 TermNode
 GlobalState::ReadFrom(LoadOptionTag<WithSourceLocation>, string_view unit,
 	ContextState& cs) const
@@ -2889,7 +3505,7 @@ GlobalState::ReadFrom(LoadOptionTag<WithSourceLocation>, string_view unit,
 	YAssertNonnull(unit.data());
 
 	Session sess(cs.get_allocator());
-	SourcedByteParser parse(sess.Lexer, sess.get_allocator());
+	SourcedViewByteParser parse(sess.Lexer, sess.get_allocator());
 
 	return Prepare(cs, sess, sess.Process(unit, ystdex::ref(parse)));
 }
@@ -2900,8 +3516,138 @@ GlobalState::ReadFrom(LoadOptionTag<NoSourceInformation>, string_view unit,
 	YAssertNonnull(unit.data());
 
 	Session sess(cs.get_allocator());
+	ViewByteParser parse(sess.Lexer, sess.get_allocator());
+
+	return Prepare(cs, sess, sess.Process(unit, ystdex::ref(parse)));
+}
+
+
+void
+AnnotateNameResolutionCache(TermNode& term)
+{
+	vector<lref<TermNode>> remained(term.get_allocator());
+
+	remained.push_back(term);
+	while(!remained.empty())
+	{
+		auto& tm(remained.back().get());
+
+		remained.pop_back();
+		if(IsLeaf(tm))
+		{
+			if(const auto p = TermToNamePtr(tm))
+				if(!tm.Value.Query(NameCacheQuery)
+					.try_get_object_ptr<NameCacheMetadata>())
+				{
+					// XXX: The value is copied since it is used to initialize
+					//	the new holder replacing the old one.
+					TokenValue id(*p);
+					const auto p_si(QuerySourceInformation(tm.Value));
+
+					tm.SetValue(any_ops::use_holder,
+						in_place_type<NameCachedHolder<TokenValue>>,
+						YSLib::allocate_shared<NameResolutionCache>(
+						tm.get_allocator()), p_si, std::move(id),
+						tm.get_allocator());
+				}
+		}
+		else
+			for(auto& t : tm)
+				remained.push_back(t);
+	}
+}
+
+void
+SetupNameResolutionCache(GlobalState& global)
+{
+	struct Pass final
+	{
+		TermPasses::HandlerType Preprocess;
+
+		ReductionStatus
+		operator()(TermNode& term) const
+		{
+			const auto res(Preprocess ? Preprocess(term)
+				: ReductionStatus::Neutral);
+
+			AnnotateNameResolutionCache(term);
+			return res;
+		}
+	};
+
+	global.Preprocess = TermPasses::HandlerType(std::allocator_arg,
+		global.Allocator, Pass{std::move(global.Preprocess)});
+	global.CacheNameResolution = true;
+}
+
+void
+MarkPureCombiners(ContextState& cs, std::initializer_list<string_view> names)
+{
+	auto& tbl(cs.Global.get().PureCombiners);
+
+	for(const auto& n : names)
+	{
+		const auto pr(ResolveName(cs, n));
+
+		if(pr.first)
+			if(const auto p = TryAccessLeafAtom<const ContextHandler>(
+				ReferenceTerm(*pr.first)))
+				ystdex::insert_or_assign(tbl, string(n), *p);
+	}
+}
+
+void
+AnnotateConstantFolding(TermNode& term, const PureCombinerTable& tbl)
+{
+	if(!tbl.empty())
+	{
+		vector<lref<TermNode>> remained(term.get_allocator()),
+			combs(term.get_allocator());
+
+		remained.push_back(term);
+		while(!remained.empty())
+		{
+			auto& tm(remained.back().get());
+
+			remained.pop_back();
+			if(IsBranch(tm))
+			{
+				if(IsBranchedList(tm) && tm.size() > 1)
+					combs.push_back(tm);
+				for(auto& t : tm)
+					remained.push_back(t);
+			}
+		}
+		// NOTE: As %combs is in preorder, the subterms are annotated before
+		//	the terms containing them in the reversed order.
+		for(auto i(combs.rbegin()); i != combs.rend(); ++i)
+			AnnotateConstantFoldingCombination(*i, tbl);
+	}
+}
+
+void
+SetupConstantFolding(GlobalState& global)
+{
+	struct Pass final
+	{
+		TermPasses::HandlerType Preprocess;
+		lref<const PureCombinerTable> Table;
+
+		ReductionStatus
+		operator()(TermNode& term) const
+		{
+			const auto res(Preprocess ? Preprocess(term)
+				: ReductionStatus::Neutral);
+
+			AnnotateConstantFolding(term, Table);
+			return res;
+		}
+	};
 
-	return Prepare(cs, sess, sess.Process(unit));
+	global.Preprocess = TermPasses::HandlerType(std::allocator_arg,
+		global.Allocator, Pass{std::move(global.Preprocess),
+		global.PureCombiners});
+	global.FoldConstants = true;
 }
 
 } // namesapce A1;
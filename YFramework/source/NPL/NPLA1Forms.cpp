@@ -11,13 +11,13 @@
 /*!	\file NPLA1Forms.cpp
 \ingroup NPL
 \brief NPLA1 语法形式。
-\version r28294
+\version r28300
 \author FrankHB <frankhb1989@gmail.com>
 \since build 882
 \par 创建时间:
 	2014-02-15 11:19:51 +0800
 \par 修改时间:
-	2022-09-13 02:31 +0800
+	2026-10-17 16:17 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -818,6 +818,17 @@ public:
 			&& x.parent == y.parent && x.NoLifting == y.NoLifting;
 	}
 
+	/*!
+	\brief 追踪父环境中的引用。
+	\sa EnvironmentCollector::Visit
+	\since build 955
+	*/
+	void
+	Trace(EnvironmentCollector& col) const
+	{
+		col.Visit(parent);
+	}
+
 	//! \since build 772
 	ReductionStatus
 	operator()(TermNode& term, ContextNode& ctx) const
@@ -1102,6 +1113,16 @@ UnwrapResolved(TermNode& term, FormContextHandler& fch,
 	ThrowUnwrappingFailureOnOperative();
 }
 
+//! \since build 955
+void
+TraceContextHandler(const ContextHandler& h, EnvironmentCollector& col)
+{
+	if(const auto p = h.target<FormContextHandler>())
+		TraceContextHandler(p->Handler, col);
+	else if(const auto p_vau = h.target<VauHandler>())
+		p_vau->Trace(col);
+}
+
 template<typename _func, typename _func2>
 ReductionStatus
 DispatchContextHandler(ContextHandler& h, ResolvedTermReferencePtr p_ref,
@@ -2542,7 +2563,8 @@ RelayApplicativeNext(ContextNode& ctx, TermNode& term, _fNext&& next)
 		SetupNextTerm(ctx, term);
 #endif
 		return ReductionStatus::Partial;
-	}, NPL::ToReducer(ctx.get_allocator(), trivial_swap, yforward(next)));
+	}, NPL::ToReducer(ctx.GetFrameAllocator(), trivial_swap,
+		yforward(next)));
 }
 
 //! \since build 919
@@ -3482,6 +3504,11 @@ ProvideLetCommon(TermNode& term, ContextNode& ctx)
 }
 
 //! \since build 920
+// NOTE: As %ProvideLetCommon. The miscompiled code loses the dynamic
+//	environment after the imports in the optimized builds.
+#if YB_IMPL_GNUCPP >= 120000
+YB_ATTR(optimize("no-tree-pta"))
+#endif
 ReductionStatus
 ImportImpl(TermNode& term, ContextNode& ctx, bool ref_symbols)
 {
@@ -4217,6 +4244,17 @@ LockCurrentEnvironment(TermNode& term, ContextNode& ctx)
 	}();
 }
 
+bool
+TraceEnvironments(const ValueObject& vo, EnvironmentCollector& col)
+{
+	if(const auto p_h = vo.AccessPtr<ContextHandler>())
+	{
+		TraceContextHandler(*p_h, col);
+		return true;
+	}
+	return {};
+}
+
 
 ReductionStatus
 DefineLazy(TermNode& term, ContextNode& ctx)
@@ -4764,7 +4802,7 @@ BindingsWithParentToEnvironment(TermNode& term, ContextNode& ctx)
 			[&](TermNode&, ContextNode& c){
 			ReduceChildren(eterm, c);
 			return ReductionStatus::Partial;
-		}, NPL::ToReducer(ctx.get_allocator(), trivial_swap,
+		}, NPL::ToReducer(ctx.GetFrameAllocator(), trivial_swap,
 			A1::NameTypedReducerHandler([&]{
 			auto p_env(CreateEnvironment(eterm));
 			auto& con(term.GetContainerRef());
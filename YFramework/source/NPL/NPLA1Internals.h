@@ -11,13 +11,13 @@
 /*!	\file NPLA1Internals.h
 \ingroup NPL
 \brief NPLA1 内部接口。
-\version r22522
+\version r22523
 \author FrankHB <frankhb1989@gmail.com>
 \since build 882
 \par 创建时间:
 	2020-02-15 13:20:08 +0800
 \par 修改时间:
-	2022-09-08 12:34 +0800
+	2026-10-17 11:58 +0800
 \par 文本编码:
 	UTF-8
 \par 非公开模块名称:
@@ -745,7 +745,8 @@ YB_ATTR_always_inline inline auto
 RelayCurrent(ContextNode& ctx, _fCurrent&& cur)
 	-> decltype(cur(std::declval<TermNode&>(), ctx))
 {
-	return A1::RelayCurrent(ctx, Continuation(yforward(cur), ctx));
+	return A1::RelayCurrent(ctx,
+		Continuation(yforward(cur), ctx.GetFrameAllocator()));
 }
 //! \since build 926
 template<typename _fCurrent>
@@ -754,7 +755,8 @@ RelayCurrent(ContextNode& ctx, trivial_swap_t, _fCurrent&& cur)
 	-> decltype(cur(std::declval<TermNode&>(), ctx))
 {
 	return A1::RelayCurrent(ctx,
-		Continuation(trivial_swap, yforward(cur), ctx));
+		Continuation(trivial_swap, yforward(cur),
+		ctx.GetFrameAllocator()));
 }
 #endif
 //@}
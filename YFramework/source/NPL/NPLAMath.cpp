@@ -11,13 +11,13 @@
 /*!	\file NPLAMath.cpp
 \ingroup NPL
 \brief NPLA 数学功能。
-\version r28364
+\version r28368
 \author FrankHB <frankhb1989@gmail.com>
 \since build 930
 \par 创建时间:
 	2021-11-03 12:50:49 +0800
 \par 修改时间:
-	2022-06-24 02:19 +0800
+	2026-10-17 17:31 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -34,8 +34,10 @@
 //	std::fmod, ystdex::and_, std::is_unsigned, std::abs, std::floor, std::trunc,
 //	InvalidSyntax, ptrdiff_t, std::ldexp, std::pow, string_view,
 //	ystdex::isdigit, ReductionStatus, std::isinf, std::isnan, std::log2,
-//	ystdex::cond_t, ystdex::byte;
-#include <ystdex/exception.h> // for ystdex::unsupported, std::domain_error;
+//	ystdex::cond_t, ystdex::byte, BigInt, std::allocator_arg, std::min,
+//	std::all_of, std::signbit, std::fabs;
+#include <ystdex/exception.h> // for ystdex::unsupported, std::domain_error,
+//	std::invalid_argument;
 #include <ystdex/cstdint.hpp> // for std::numeric_limits,
 //	ystdex::make_widen_int;
 #include <ystdex/expanded_function.hpp> // for ystdex::retry_on_cond;
@@ -107,7 +109,8 @@
 #	endif
 #endif
 #include <ystdex/operators.hpp> // for ystdex::operators, ystdex::shiftable;
-#include <ystdex/bit.hpp> // for ystdex::countr_zero_narrow;
+#include <ystdex/bit.hpp> // for ystdex::countr_zero_narrow,
+//	ystdex::countl_zero_narrow;
 #if YB_IMPL_MSCPP >= 1400
 #	include <intrin.h>
 #	if defined(_M_AMD64)
@@ -172,7 +175,8 @@ enum NumCode : size_t
 	LongLong,
 	ULongLong,
 	IntMax = ULongLong,
-	// TODO: Support bigint.
+	//! \since build 955
+	Bignum,
 	Float,
 	Double,
 	LongDouble,
@@ -195,7 +199,8 @@ MapTypeIdToNumCode(const type_info& ti) ynothrow
 		return ULongLong;
 	if(IsTyped<double>(ti))
 		return Double;
-	// TODO: Support bigint.
+	if(IsTyped<BigInt>(ti))
+		return Bignum;
 	if(IsTyped<long>(ti))
 		return Long;
 	if(IsTyped<unsigned long>(ti))
@@ -244,13 +249,16 @@ template<>
 struct ExtType<long> : ystdex::identity<long long>
 {};
 
+// NOTE: The bignum is used instead of 'unsigned long long' to keep the
+//	representation same to the literal of the same value.
+//! \since build 955
 template<>
-struct ExtType<long long> : ystdex::identity<unsigned long long>
+struct ExtType<long long> : ystdex::identity<BigInt>
 {};
 
-// TODO: Use bigint.
+//! \since build 955
 template<>
-struct ExtType<unsigned long long> : ystdex::identity<double>
+struct ExtType<unsigned long long> : ystdex::identity<BigInt>
 {};
 
 template<typename _type>
@@ -259,16 +267,15 @@ struct NExtType : ystdex::cond_t<std::is_signed<_type>, ExtType<_type>,
 	<= ystdex::integer_width<int>::value), int, long long>>>
 {};
 
-// TODO: Use bigint.
+//! \since build 955
 template<>
-struct NExtType<long long> : ystdex::identity<double>
+struct NExtType<long long> : ystdex::identity<BigInt>
 {};
 
 
-// TODO: Use bigint.
 template<typename _type>
 struct MulExtType : ystdex::conditional_t<ystdex::integer_width<_type>::value
-	== 64, ystdex::identity<double>, ystdex::make_widen_int<_type>>
+	== 64, ystdex::identity<BigInt>, ystdex::make_widen_int<_type>>
 {};
 
 
@@ -298,7 +305,8 @@ DoNumLeaf(_tValue& x, _func f)
 		return f(*p_ull);
 	if(const auto p_d = TryAccessValue<double>(x))
 		return f(*p_d);
-	// TODO: Support bigint.
+	if(const auto p_b = TryAccessValue<BigInt>(x))
+		return f(*p_b);
 	if(const auto p_l = TryAccessValue<long>(x))
 		return f(*p_l);
 	if(const auto p_ul = TryAccessValue<unsigned long>(x))
@@ -335,7 +343,8 @@ DoNumLeafHinted(NumCode code, _func f, _tValue&... xs)
 		return f(xs.template GetObject<unsigned long long>()...);
 	case Double:
 		return f(xs.template GetObject<double>()...);
-	// TODO: Support bigint.
+	case Bignum:
+		return f(xs.template GetObject<BigInt>()...);
 	case Long:
 		return f(xs.template GetObject<long>()...);
 	case ULong:
@@ -358,19 +367,16 @@ DoNumLeafHinted(NumCode code, _func f, _tValue&... xs)
 }
 
 
-//! \since build 937
-template<typename _type>
+/*!
+\brief 计算溢出的商：取最小值的相反数。
+\since build 955
+*/
+//@{
+template<typename _type, yimpl(ystdex::enable_if_t<
+	!std::is_same<MakeExtType<_type>, BigInt>::value, int> = 0)>
 YB_ATTR_nodiscard YB_PURE inline ValueObject
-QuotientOverflow(const _type& x)
+QuotientOverflow(const _type& x, BigInt::allocator_type)
 {
-	// TODO: Support bigint.
-#if false
-	// NOTE: This is unnecessary since the result is representable in
-	//	the range 'unsigned long long'.
-	if(std::numeric_limits<_type>::min()
-		== std::numeric_limits<long long>::min())
-		return -double(x);
-#endif
 #if YB_IMPL_MSCPP >= 1200
 	YB_Diag_Push
 	YB_Diag_Ignore(4146)
@@ -385,6 +391,17 @@ QuotientOverflow(const _type& x)
 	YB_Diag_Pop
 #endif
 }
+template<typename _type, yimpl(ystdex::enable_if_t<
+	std::is_same<MakeExtType<_type>, BigInt>::value, long> = 0L)>
+YB_ATTR_nodiscard ValueObject
+QuotientOverflow(const _type& x, BigInt::allocator_type a)
+{
+	BigInt r(x, a);
+
+	r.Negate();
+	return ValueObject(std::allocator_arg, a, std::move(r));
+}
+//@}
 
 
 //! \since build 930
@@ -447,6 +464,387 @@ ThrowDivisionByZero()
 }
 
 
+//! \since build 955
+//@{
+using Limb = BigInt::Limb;
+using LimbVector = BigInt::LimbVector;
+using DLimb = std::uint64_t;
+
+yconstexpr const size_t LimbBits(std::numeric_limits<Limb>::digits);
+
+void
+TrimLimbs(LimbVector& x) ynothrow
+{
+	while(!x.empty() && x.back() == 0)
+		x.pop_back();
+}
+
+YB_ATTR_nodiscard YB_PURE int
+CompareMagnitude(const Limb* a, size_t an, const Limb* b, size_t bn) ynothrow
+{
+	if(an != bn)
+		return an < bn ? -1 : 1;
+	while(an-- != 0)
+		if(a[an] != b[an])
+			return a[an] < b[an] ? -1 : 1;
+	return 0;
+}
+YB_ATTR_nodiscard YB_PURE inline PDefH(int, CompareMagnitude,
+	const LimbVector& a, const LimbVector& b) ynothrow
+	ImplRet(CompareMagnitude(a.data(), a.size(), b.data(), b.size()))
+
+//! \pre <tt>rn >= bn</tt> 。
+Limb
+AddMagnitude(Limb* r, size_t rn, const Limb* b, size_t bn) ynothrow
+{
+	DLimb carry(0);
+	size_t i(0);
+
+	for(; i < bn; ++i)
+	{
+		carry += DLimb(r[i]) + b[i];
+		r[i] = Limb(carry);
+		carry >>= LimbBits;
+	}
+	for(; carry != 0 && i < rn; ++i)
+	{
+		carry += r[i];
+		r[i] = Limb(carry);
+		carry >>= LimbBits;
+	}
+	return Limb(carry);
+}
+
+//! \pre 第一参数表示的值不小于第三参数表示的值。
+void
+SubMagnitude(Limb* r, size_t rn, const Limb* b, size_t bn) ynothrowv
+{
+	DLimb borrow(0);
+	size_t i(0);
+
+	for(; i < bn; ++i)
+	{
+		const auto d(DLimb(r[i]) - b[i] - borrow);
+
+		r[i] = Limb(d);
+		borrow = d >> (LimbBits * 2 - 1);
+	}
+	for(; borrow != 0 && i < rn; ++i)
+	{
+		const auto d(DLimb(r[i]) - borrow);
+
+		r[i] = Limb(d);
+		borrow = d >> (LimbBits * 2 - 1);
+	}
+	YAssert(borrow == 0, "Invalid operand magnitude found.");
+}
+
+void
+AddTo(LimbVector& x, const LimbVector& y)
+{
+	if(x.size() < y.size())
+		x.resize(y.size());
+	if(AddMagnitude(x.data(), x.size(), y.data(), y.size()) != 0)
+		x.push_back(1);
+}
+
+//! \return 结果是否改变符号。
+YB_ATTR_nodiscard bool
+SubFrom(LimbVector& x, const LimbVector& y)
+{
+	if(CompareMagnitude(x, y) >= 0)
+	{
+		SubMagnitude(x.data(), x.size(), y.data(), y.size());
+		TrimLimbs(x);
+		return {};
+	}
+
+	LimbVector t(y, x.get_allocator());
+
+	SubMagnitude(t.data(), t.size(), x.data(), x.size());
+	TrimLimbs(t);
+	x.swap(t);
+	return true;
+}
+
+//! \pre 结果的存储中的值为 0 ，大小为 <tt>an + bn</tt> 。
+void
+MulSchool(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn)
+	ynothrow
+{
+	for(size_t i(0); i < an; ++i)
+	{
+		const DLimb ai(a[i]);
+		DLimb carry(0);
+
+		if(ai != 0)
+		{
+			for(size_t j(0); j < bn; ++j)
+			{
+				carry += ai * b[j] + r[i + j];
+				r[i + j] = Limb(carry);
+				carry >>= LimbBits;
+			}
+			r[i + bn] = Limb(carry);
+		}
+	}
+}
+
+/*!
+\pre 结果的存储中的值为 0 ，大小为 <tt>an + bn</tt> 。
+\pre <tt>an >= bn</tt> 。
+
+较小的操作数使用逐位乘法，否则使用 Karatsuba 算法递归计算。
+*/
+void
+MulMagnitude(Limb* r, const Limb* a, size_t an, const Limb* b, size_t bn,
+	const BigInt::allocator_type& alloc)
+{
+	YAssert(an >= bn, "Invalid operand order found.");
+	if(bn < BigInt::KaratsubaThreshold)
+	{
+		MulSchool(r, a, an, b, bn);
+		return;
+	}
+
+	const size_t h(an / 2);
+
+	if(bn <= h)
+	{
+		// NOTE: Unbalanced operands. Split only the longer one as
+		//	'a = a1 * B^h + a0'.
+		LimbVector t(an - h + bn, Limb(), alloc);
+
+		MulMagnitude(r, a, h, b, bn, alloc);
+		MulMagnitude(t.data(), a + h, an - h, b, bn, alloc);
+		AddMagnitude(r + h, an + bn - h, t.data(), t.size());
+		return;
+	}
+
+	// NOTE: Let 'a = a1 * B^h + a0, b = b1 * B^h + b0', then
+	//	'a * b = z2 * B^(2h) + z1 * B^h + z0' where 'z0 = a0 * b0',
+	//	'z2 = a1 * b1' and 'z1 = (a0 + a1) * (b0 + b1) - z0 - z2'.
+	const size_t an1(an - h), bn1(bn - h), sn(an1 + 1);
+	LimbVector sa(a, a + h, alloc), sb(b, b + h, alloc);
+
+	sa.resize(sn);
+	sb.resize(sn);
+	AddMagnitude(sa.data(), sn, a + h, an1);
+	AddMagnitude(sb.data(), sn, b + h, bn1);
+
+	// NOTE: The sums are not trimmed, so %z1 is large enough to subtract %z0
+	//	and %z2 in place.
+	LimbVector z1(sn * 2, Limb(), alloc);
+
+	MulMagnitude(z1.data(), sa.data(), sn, sb.data(), sn, alloc);
+	// NOTE: The low part of %r is for %z0 and the high part is for %z2. They
+	//	do not overlap.
+	MulMagnitude(r, a, h, b, h, alloc);
+	MulMagnitude(r + h * 2, a + h, an1, b + h, bn1, alloc);
+	SubMagnitude(z1.data(), z1.size(), r, h * 2);
+	SubMagnitude(z1.data(), z1.size(), r + h * 2, an1 + bn1);
+	// NOTE: The high limbs of %z1 out of the range of the result are zero.
+	AddMagnitude(r + h, an + bn - h, z1.data(),
+		std::min(z1.size(), an + bn - h));
+}
+
+//! \pre 除数非零。
+Limb
+DivRemSmall(LimbVector& x, Limb d) ynothrowv
+{
+	YAssert(d != 0, "Invalid divisor found.");
+
+	DLimb rem(0);
+
+	for(size_t i(x.size()); i-- != 0;)
+	{
+		const DLimb cur(rem << LimbBits | x[i]);
+
+		x[i] = Limb(cur / d);
+		rem = cur % d;
+	}
+	TrimLimbs(x);
+	return Limb(rem);
+}
+
+void
+MulAddSmall(LimbVector& x, Limb m, Limb c)
+{
+	DLimb carry(c);
+
+	for(auto& l : x)
+	{
+		carry += DLimb(l) * m;
+		l = Limb(carry);
+		carry >>= LimbBits;
+	}
+	if(carry != 0)
+		x.push_back(Limb(carry));
+}
+
+/*!
+\pre 被除数不小于除数，除数的最高位非零。
+\note 使用 Knuth 算法 D 。
+
+商和余数保存在第三和第四参数中。
+*/
+void
+DivRemMagnitude(const LimbVector& u, const LimbVector& v, LimbVector& q,
+	LimbVector& r)
+{
+	const size_t n(v.size());
+
+	YAssert(n != 0 && v.back() != 0, "Invalid divisor found.");
+	YAssert(CompareMagnitude(u, v) >= 0, "Invalid dividend found.");
+	if(n == 1)
+	{
+		q.assign(u.begin(), u.end());
+
+		const auto rem(DivRemSmall(q, v[0]));
+
+		r.clear();
+		if(rem != 0)
+			r.push_back(rem);
+		return;
+	}
+
+	const size_t m(u.size() - n);
+	const auto s(ystdex::countl_zero_narrow(v.back()));
+	// NOTE: Shift the operands to make the highest bit of the divisor set.
+	const auto shl([s](Limb hi, Limb lo) ynothrow -> Limb{
+		return s == 0 ? hi : Limb(hi << s | lo >> (LimbBits - size_t(s)));
+	});
+	LimbVector vn(n, Limb(), r.get_allocator()), un(u.size() + 1, Limb(),
+		r.get_allocator());
+
+	for(size_t i(n - 1); i != 0; --i)
+		vn[i] = shl(v[i], v[i - 1]);
+	vn[0] = Limb(v[0] << s);
+	un[u.size()] = shl(0, u.back());
+	for(size_t i(u.size() - 1); i != 0; --i)
+		un[i] = shl(u[i], u[i - 1]);
+	un[0] = Limb(u[0] << s);
+	q.assign(m + 1, Limb());
+	for(size_t j(m + 1); j-- != 0;)
+	{
+		const DLimb num(DLimb(un[j + n]) << LimbBits | un[j + n - 1]);
+		DLimb qhat(num / vn[n - 1]), rhat(num % vn[n - 1]);
+
+		while(qhat >> LimbBits != 0 || qhat * vn[n - 2]
+			> (rhat << LimbBits | un[j + n - 2]))
+		{
+			--qhat;
+			rhat += vn[n - 1];
+			if(rhat >> LimbBits != 0)
+				break;
+		}
+
+		// NOTE: Multiply and subtract.
+		DLimb borrow(0), carry(0);
+
+		for(size_t i(0); i < n; ++i)
+		{
+			carry += qhat * vn[i];
+
+			const auto d(DLimb(un[i + j]) - Limb(carry) - borrow);
+
+			un[i + j] = Limb(d);
+			borrow = d >> (LimbBits * 2 - 1);
+			carry >>= LimbBits;
+		}
+
+		const auto d(DLimb(un[j + n]) - carry - borrow);
+
+		un[j + n] = Limb(d);
+		if(d >> (LimbBits * 2 - 1) != 0)
+		{
+			// NOTE: Add back. This is rare.
+			--qhat;
+			un[j + n] += AddMagnitude(un.data() + j, n, vn.data(), n);
+		}
+		q[j] = Limb(qhat);
+	}
+	TrimLimbs(q);
+	// NOTE: Unnormalize the remainder.
+	r.assign(n, Limb());
+	for(size_t i(0); i < n - 1; ++i)
+		r[i] = s == 0 ? un[i] : Limb(un[i] >> s | un[i + 1] << (LimbBits
+			- size_t(s)));
+	r[n - 1] = Limb(un[n - 1] >> s);
+	TrimLimbs(r);
+}
+
+
+//! \brief 判断 BigInt 值是否可被表示为指定的有符号整数类型。
+template<typename _type>
+YB_ATTR_nodiscard YB_PURE bool
+BigIntFits(const BigInt& x) ynothrow
+{
+	static_assert(std::is_signed<_type>() && ystdex::integer_width<_type>::value
+		<= 64, "Invalid type found.");
+	const auto mx(std::uint64_t(std::numeric_limits<_type>::max()));
+	const auto m(x.GetLow64());
+
+	return x.GetLimbs().size() <= 2 && (x.IsNegative() ? m <= mx + 1 : m <= mx);
+}
+
+/*!
+\brief 规范化整数结果：优先使用可表示值的 fixnum 类型。
+\note 同字面量，依次尝试 int 和 long long ，否则保留 bignum 。
+*/
+//@{
+YB_ATTR_nodiscard ValueObject
+NormalizeInt(BigInt&& x)
+{
+	if(BigIntFits<int>(x))
+		return static_cast<int>(x);
+	if(BigIntFits<long long>(x))
+		return static_cast<long long>(x);
+
+	const auto a(x.get_allocator());
+
+	return ValueObject(std::allocator_arg, a, std::move(x));
+}
+template<typename _type, yimpl(ystdex::enable_if_t<
+	std::is_arithmetic<_type>::value, int> = 0)>
+YB_ATTR_nodiscard YB_PURE inline ValueObject
+NormalizeInt(_type x)
+{
+	return x;
+}
+//@}
+
+
+//! \brief 需要分配 bignum 的数值操作的基类。
+struct AllocatedNumOp
+{
+	BigInt::allocator_type Allocator;
+
+	AllocatedNumOp(BigInt::allocator_type a) ynothrow
+		: Allocator(a)
+	{}
+
+	//! \brief 扩展整数到指定的类型，若为 bignum 则使用分配器。
+	//@{
+	template<typename _tDst, typename _type>
+	YB_ATTR_nodiscard YB_PURE inline
+		yimpl(ystdex::enable_if_t)<!std::is_same<_tDst, BigInt>::value, _tDst>
+	Extend(const _type& x) const ynothrow
+	{
+		return _tDst(x);
+	}
+	template<typename _tDst, typename _type>
+	YB_ATTR_nodiscard YB_PURE inline
+		yimpl(ystdex::enable_if_t)<std::is_same<_tDst, BigInt>::value, _tDst>
+	Extend(const _type& x) const
+	{
+		return BigInt(x, Allocator);
+	}
+	//@}
+};
+//@}
+
+
 //! \ingroup functors
 //@{
 //! \since build 930
@@ -508,10 +906,12 @@ struct Cast : GUAssertMismatch<_tDst>
 struct DynNumCast : ReportMismatch<ValueObject>
 {
 	NumCode Code;
+	//! \since build 955
+	BigInt::allocator_type Allocator;
 
-	//! \since build 932
-	DynNumCast(NumCode code) ynothrow
-		: Code(code)
+	//! \since build 955
+	DynNumCast(NumCode code, BigInt::allocator_type a = {}) ynothrow
+		: Code(code), Allocator(a)
 	{}
 
 	using ReportMismatch<ValueObject>::operator();
@@ -520,7 +920,6 @@ struct DynNumCast : ReportMismatch<ValueObject>
 		yimpl(ystdex::exclude_self_t)<ValueObject, _tParam, ValueObject>
 	operator()(const _tParam& x) const
 	{
-		// TODO: Use allocator?
 		switch(Code)
 		{
 		case Int:
@@ -533,7 +932,8 @@ struct DynNumCast : ReportMismatch<ValueObject>
 			return static_cast<unsigned long long>(x);
 		case Double:
 			return static_cast<double>(x);
-		// TODO: Support bigint.
+		case Bignum:
+			return BigInt(x, Allocator);
 		case Long:
 			return static_cast<long>(x);
 		case ULong:
@@ -633,6 +1033,12 @@ struct EqZero
 	YB_Diag_Pop
 #endif
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const BigInt& x) const ynothrow
+	{
+		return x.IsZero();
+	}
 };
 
 
@@ -648,6 +1054,12 @@ struct Positive
 		// XXX: Ditto.
 		return x > _type(0);
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const BigInt& x) const ynothrow
+	{
+		return !(x.IsNegative() || x.IsZero());
+	}
 };
 
 
@@ -660,6 +1072,12 @@ struct Negative
 	{
 		return x < _type(0);
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const BigInt& x) const ynothrow
+	{
+		return x.IsNegative();
+	}
 };
 
 
@@ -691,10 +1109,15 @@ struct Odd
 	YB_ATTR_nodiscard YB_PURE inline bool
 	operator()(const _type& x) const ynothrow
 	{
-		// TODO: Support bigint?
 		// XXX: Ditto.
 		return x % _type(2) != _type(0);
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const BigInt& x) const ynothrow
+	{
+		return x.IsOdd();
+	}
 };
 
 
@@ -725,42 +1148,64 @@ struct Even
 	{
 		return x % _type(2) == _type(0);
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard YB_PURE bool
+	operator()(const BigInt& x) const ynothrow
+	{
+		return !x.IsOdd();
+	}
 };
 
 
-struct BMax
+struct BMax : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE inline ValueObject
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x > y ? x : y;
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(BigInt& x, BigInt& y) const
+	{
+		return NormalizeInt(std::move(x > y ? x : y));
+	}
 };
 
 
-struct BMin
+struct BMin : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE inline ValueObject
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x < y ? x : y;
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(BigInt& x, BigInt& y) const
+	{
+		return NormalizeInt(std::move(x < y ? x : y));
+	}
 };
 //@}
 
 
-struct AddOne
+struct AddOne : AllocatedNumOp
 {
 	//! \since build 937
 	lref<ValueObject> Result;
 
-	//! \since build 937
-	AddOne(ValueObject& res) ynothrow
-		: Result(res)
+	//! \since build 955
+	AddOne(ValueObject& res, BigInt::allocator_type a) ynothrow
+		: AllocatedNumOp(a), Result(res)
 	{}
 
 	//! \since build 937
@@ -779,19 +1224,27 @@ struct AddOne
 		if(x != std::numeric_limits<_type>::max())
 			++x;
 		else
-			// TODO: Support bigint with allocator?
-			Result.get().assign(MakeExtType<_type>(x) + 1);
+			Result.get() = NormalizeInt(Extend<MakeExtType<_type>>(x) + 1);
+	}
+	//! \since build 955
+	void
+	operator()(BigInt& x) const
+	{
+		++x;
+		// NOTE: Keep the bignum in place unless it can be a fixnum.
+		if(BigIntFits<long long>(x))
+			Result.get() = NormalizeInt(std::move(x));
 	}
 };
 
-struct SubOne
+struct SubOne : AllocatedNumOp
 {
 	//! \since build 937
 	lref<ValueObject> Result;
 
-	//! \since build 937
-	SubOne(ValueObject& res) ynothrow
-		: Result(res)
+	//! \since build 955
+	SubOne(ValueObject& res, BigInt::allocator_type a) ynothrow
+		: AllocatedNumOp(a), Result(res)
 	{}
 
 	//! \since build 937
@@ -810,14 +1263,25 @@ struct SubOne
 		if(x != std::numeric_limits<_type>::min())
 			--x;
 		else
-			// TODO: Support bigint with allocator?
-			Result.get().assign(ValueObject(MakeNExtType<_type>(x) - 1));
+			Result.get() = NormalizeInt(Extend<MakeNExtType<_type>>(x) - 1);
+	}
+	//! \since build 955
+	void
+	operator()(BigInt& x) const
+	{
+		--x;
+		// NOTE: Keep the bignum in place unless it can be a fixnum.
+		if(BigIntFits<long long>(x))
+			Result.get() = NormalizeInt(std::move(x));
 	}
 };
 
 
-struct BPlus
+struct BPlus : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	//! \since build 937
 	//@{
 	template<typename _type>
@@ -825,7 +1289,6 @@ struct BPlus
 		yimpl(ystdex::enable_if_t)<!std::is_integral<_type>::value, _type>
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x + y;
 	}
 	template<typename _type, yimpl(ystdex::enable_if_t<ystdex::and_<
@@ -839,13 +1302,17 @@ struct BPlus
 		if(!__builtin_add_overflow(x, y, &r))
 			return r;
 		if(x > 0 && y > std::numeric_limits<_type>::max() - x)
-			return MakeExtType<_type>(x) + MakeExtType<_type>(y);
-		return MakeNExtType<_type>(x) + MakeNExtType<_type>(y);
+			return NormalizeInt(Extend<MakeExtType<_type>>(x)
+				+ Extend<MakeExtType<_type>>(y));
+		return NormalizeInt(Extend<MakeNExtType<_type>>(x)
+			+ Extend<MakeNExtType<_type>>(y));
 #else
 		if(x > 0 && y > std::numeric_limits<_type>::max() - x)
-			return MakeExtType<_type>(x) + MakeExtType<_type>(y);
+			return NormalizeInt(Extend<MakeExtType<_type>>(x)
+				+ Extend<MakeExtType<_type>>(y));
 		if(x < 0 && y < std::numeric_limits<_type>::min() - x)
-			return MakeNExtType<_type>(x) + MakeNExtType<_type>(y);
+			return NormalizeInt(Extend<MakeNExtType<_type>>(x)
+				+ Extend<MakeNExtType<_type>>(y));
 		return x + y;
 #endif
 	}
@@ -869,14 +1336,25 @@ struct BPlus
 		if(y <= std::numeric_limits<_type>::max() - x)
 			return x + y;
 #endif
-		return MakeExtType<_type>(x) + MakeExtType<_type>(y);
+		return NormalizeInt(Extend<MakeExtType<_type>>(x)
+			+ Extend<MakeExtType<_type>>(y));
 	}
 	//@}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(BigInt& x, const BigInt& y) const
+	{
+		x += y;
+		return NormalizeInt(std::move(x));
+	}
 };
 
 
-struct BMinus
+struct BMinus : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	//! \since build 937
 	//@{
 	template<typename _type>
@@ -884,7 +1362,6 @@ struct BMinus
 		yimpl(ystdex::enable_if_t)<!std::is_integral<_type>::value, _type>
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x - y;
 	}
 	template<typename _type, yimpl(ystdex::enable_if_t<ystdex::and_<
@@ -899,14 +1376,18 @@ struct BMinus
 			return r;
 		if(YB_UNLIKELY(y == std::numeric_limits<_type>::min())
 			|| (x > 0 && -y > std::numeric_limits<_type>::max() - x))
-			return MakeExtType<_type>(x) - MakeExtType<_type>(y);
-		return MakeNExtType<_type>(x) - MakeNExtType<_type>(y);
+			return NormalizeInt(Extend<MakeExtType<_type>>(x)
+				- Extend<MakeExtType<_type>>(y));
+		return NormalizeInt(Extend<MakeNExtType<_type>>(x)
+			- Extend<MakeNExtType<_type>>(y));
 #else
 		if(YB_UNLIKELY(y == std::numeric_limits<_type>::min())
 			|| (x > 0 && -y > std::numeric_limits<_type>::max() - x))
-			return MakeExtType<_type>(x) - MakeExtType<_type>(y);
+			return NormalizeInt(Extend<MakeExtType<_type>>(x)
+				- Extend<MakeExtType<_type>>(y));
 		if(x < 0 && -y < std::numeric_limits<_type>::min() - x)
-			return MakeNExtType<_type>(x) - MakeNExtType<_type>(y);
+			return NormalizeInt(Extend<MakeNExtType<_type>>(x)
+				- Extend<MakeNExtType<_type>>(y));
 		return x - y;
 #endif
 	}
@@ -918,22 +1399,31 @@ struct BMinus
 		// XXX: This is efficient enough to avoid builtins.
 		if(y <= x)
 			return x - y;
-		// TODO: Support bigint with allocator?
-		return MakeExtType<_type>(x) - MakeExtType<_type>(y);
+		return NormalizeInt(Extend<MakeExtType<_type>>(x)
+			- Extend<MakeExtType<_type>>(y));
 	}
 	//@}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(BigInt& x, const BigInt& y) const
+	{
+		x -= y;
+		return NormalizeInt(std::move(x));
+	}
 };
 
 
-struct BMultiplies
+struct BMultiplies : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	//! \since build 937
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE inline
 		yimpl(ystdex::enable_if_t)<!std::is_integral<_type>::value, _type>
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x * y;
 	}
 	//! \since build 937
@@ -947,22 +1437,34 @@ struct BMultiplies
 
 		if(!__builtin_mul_overflow(x, y, &r))
 			return r;
-		return MakeMulExtType<_type>(x) * MakeMulExtType<_type>(y);
+		return NormalizeInt(Extend<MakeMulExtType<_type>>(x)
+			* Extend<MakeMulExtType<_type>>(y));
 #else
 		using r_t = MakeMulExtType<_type>;
-		const r_t r(r_t(x) * r_t(y));
+		r_t r(Extend<r_t>(x) * Extend<r_t>(y));
 
-		if(r <= r_t(std::numeric_limits<_type>::max()))
+		if(r <= r_t(std::numeric_limits<_type>::max())
+			&& r >= r_t(std::numeric_limits<_type>::min()))
 			return _type(r);
-		return r;
+		return NormalizeInt(std::move(r));
 #endif
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(BigInt& x, const BigInt& y) const
+	{
+		x *= y;
+		return NormalizeInt(std::move(x));
+	}
 };
 
 
 //! \since build 930
-struct BDivides
+struct BDivides : AllocatedNumOp
 {
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	//! \since build 937
 	//@{
 	template<typename _type>
@@ -970,7 +1472,6 @@ struct BDivides
 		yimpl(ystdex::enable_if_t)<!std::is_integral<_type>::value, _type>
 	operator()(const _type& x, const _type& y) const ynothrow
 	{
-		// TODO: Support bigint with allocator?
 		return x / y;
 	}
 	template<typename _type, yimpl(ystdex::enable_if_t<ystdex::and_<
@@ -981,7 +1482,7 @@ struct BDivides
 		// NOTE: To avoid undefined behavior of when the value is in the 2's
 		//	complement representation (required since ISO C++20).
 		return y != 0 ? (y != _type(-1) || x != std::numeric_limits<
-			_type>::min() ? DoInt(x, y) : QuotientOverflow(x))
+			_type>::min() ? DoInt(x, y) : QuotientOverflow(x, Allocator))
 			: ThrowDivisionByZero();
 	}
 	template<typename _type, yimpl(ystdex::enable_if_t<
@@ -991,6 +1492,21 @@ struct BDivides
 	{
 		return y != 0 ? DoInt(x, y) : ThrowDivisionByZero();
 	}
+	//! \since build 955
+	YB_ATTR_nodiscard ValueObject
+	operator()(const BigInt& x, const BigInt& y) const
+	{
+		if(!y.IsZero())
+		{
+			BigInt q(Allocator), r(Allocator);
+
+			BigInt::DivRem(x, y, q, r);
+			if(r.IsZero())
+				return NormalizeInt(std::move(q));
+			return double(x) / double(y);
+		}
+		ThrowDivisionByZero();
+	}
 	//@}
 
 private:
@@ -1011,13 +1527,13 @@ private:
 };
 
 
-struct ReplaceAbs
+struct ReplaceAbs : AllocatedNumOp
 {
 	lref<ValueObject> Result;
 
-	//! \since build 937
-	ReplaceAbs(ValueObject& res) ynothrow
-		: Result(res)
+	//! \since build 955
+	ReplaceAbs(ValueObject& res, BigInt::allocator_type a) ynothrow
+		: AllocatedNumOp(a), Result(res)
 	{}
 
 	//! \since build 937
@@ -1042,7 +1558,7 @@ struct ReplaceAbs
 		if(x != std::numeric_limits<_type>::min())
 			x = _type(std::abs(x));
 		else
-			Result.get() = QuotientOverflow(x);
+			Result.get() = QuotientOverflow(x, Allocator);
 	}
 	//! \since build 937
 	template<typename _type, yimpl(ystdex::enable_if_t<
@@ -1050,15 +1566,25 @@ struct ReplaceAbs
 	inline void
 	operator()(_type&) const ynothrow
 	{}
+	//! \since build 955
+	void
+	operator()(BigInt& x) const ynothrow
+	{
+		if(x.IsNegative())
+			x.Negate();
+	}
 };
 
 
 //! \since build 937
 template<class _tOpPolicy>
-struct GBDivRemBase
+struct GBDivRemBase : AllocatedNumOp
 {
 	using result_type = typename _tOpPolicy::result_type;
 
+	//! \since build 955
+	using AllocatedNumOp::AllocatedNumOp;
+
 	// XXX: See $2022-02 @ %Documentation::Workflow.
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE inline result_type
@@ -1078,6 +1604,9 @@ struct GBDivRem : GBDivRemBase<_tOpPolicy>
 {
 	using typename GBDivRemBase<_tOpPolicy>::result_type;
 
+	//! \since build 955
+	using GBDivRemBase<_tOpPolicy>::GBDivRemBase;
+
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE inline yimpl(ystdex::enable_if_t)<
 		std::is_floating_point<_type>::value, result_type>
@@ -1098,13 +1627,26 @@ struct GBDivRem : GBDivRemBase<_tOpPolicy>
 #endif
 		ThrowTypeErrorForInteger(x);
 	}
-	// TODO: Support bigint with allocator?
 	template<typename _type, yimpl(ystdex::enable_if_t<ystdex::and_<
 		std::is_integral<_type>, std::is_signed<_type>>::value, int> = 0)>
 	YB_ATTR_nodiscard YB_PURE inline result_type
 	operator()(const _type& x, const _type& y) const
 	{
-		return _tPolicy::Int(_tOpPolicy(), x, y);
+		return _tPolicy::Int(_tOpPolicy(), x, y, this->Allocator);
+	}
+	//! \since build 955
+	YB_ATTR_nodiscard result_type
+	operator()(const BigInt& x, const BigInt& y) const
+	{
+		if(!y.IsZero())
+		{
+			BigInt q(this->Allocator), r(this->Allocator);
+
+			BigInt::DivRem(x, y, q, r);
+			_tPolicy::AdjustBig(q, r, y);
+			return _tOpPolicy::DoBig(std::move(q), std::move(r));
+		}
+		ThrowDivisionByZero();
 	}
 	using GBDivRemBase<_tOpPolicy>::operator();
 };
@@ -1130,7 +1672,6 @@ struct ReplaceInexact
 	inline void
 	operator()(_type& x) const
 	{
-		// TODO: Support bigint with allocator?
 		// XXX: It is safe to assume no undefined behavior due to out of the
 		//	range, since the infinity values are required and the range is the
 		//	all real numbers (cf. ISO C17 5.2.4.2.2/5).
@@ -1150,11 +1691,12 @@ struct ReplaceInexact
 //@{
 using DivRemResult = array<ValueObject, 2>;
 
+//! \since build 955
 template<typename _type>
 YB_ATTR_nodiscard YB_PURE inline DivRemResult
-DividesOverflow(const _type& x)
+DividesOverflow(const _type& x, BigInt::allocator_type a)
 {
-	return {QuotientOverflow(x), _type(0)};
+	return {QuotientOverflow(x, a), _type(0)};
 }
 
 
@@ -1178,6 +1720,13 @@ struct BDividesPolicy final
 		YAssert(y != 0, "Invalid divisor found.");
 		return {_type(x / y), _type(x % y)};
 	}
+
+	//! \since build 955
+	YB_ATTR_nodiscard static result_type
+	DoBig(BigInt&& q, BigInt&& r)
+	{
+		return {NormalizeInt(std::move(q)), NormalizeInt(std::move(r))};
+	}
 };
 
 
@@ -1199,6 +1748,13 @@ struct BQuotientPolicy final
 		YAssert(y != 0, "Invalid divisor found.");
 		return _type(x / y);
 	}
+
+	//! \since build 955
+	YB_ATTR_nodiscard static result_type
+	DoBig(BigInt&& q, BigInt&&)
+	{
+		return NormalizeInt(std::move(q));
+	}
 };
 
 
@@ -1225,6 +1781,13 @@ struct BRemainderPolicy final
 		YAssert(y != 0, "Invalid divisor found.");
 		return _type(x % y);
 	}
+
+	//! \since build 955
+	YB_ATTR_nodiscard static result_type
+	DoBig(BigInt&&, BigInt&& r)
+	{
+		return NormalizeInt(std::move(r));
+	}
 };
 
 
@@ -1237,9 +1800,12 @@ struct BFloorPolicy final
 		return std::floor(x / y);
 	}
 
+	//! \since build 955
+	//@{
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline DivRemResult
-	Int(BDividesPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BDividesPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type a)
 	{
 		YAssert(y != 0, "Invalid divisor found.");
 		if(y > 0)
@@ -1260,11 +1826,12 @@ struct BFloorPolicy final
 
 			return {_type((x - y + 1) / y), r > 0 ? r + y : r};
 		}
-		return DividesOverflow(x);
+		return DividesOverflow(x, a);
 	}
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline ValueObject
-	Int(BQuotientPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BQuotientPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type a)
 	{
 		YAssert(y != 0, "Invalid divisor found.");
 		if(y > 0)
@@ -1273,11 +1840,12 @@ struct BFloorPolicy final
 			return _type((x - 1) / y - 1);
 		if(y != _type(-1))
 			return _type((x - y + 1) / y);
-		return QuotientOverflow(x);
+		return QuotientOverflow(x, a);
 	}
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline _type
-	Int(BRemainderPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BRemainderPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type) ynothrowv
 	{
 		YAssert(y != 0, "Invalid divisor found.");
 
@@ -1285,6 +1853,18 @@ struct BFloorPolicy final
 
 		return (y > 0 ? r < 0 : r > 0) ? r + y : r;
 	}
+	//@}
+
+	//! \since build 955
+	static void
+	AdjustBig(BigInt& q, BigInt& r, const BigInt& y)
+	{
+		if(!r.IsZero() && r.IsNegative() != y.IsNegative())
+		{
+			--q;
+			r += y;
+		}
+	}
 };
 
 
@@ -1297,39 +1877,51 @@ struct BTruncatePolicy final
 		return std::trunc(x / y);
 	}
 
+	//! \since build 955
+	//@{
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline DivRemResult
-	Int(BDividesPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BDividesPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type a)
 	{
 		// NOTE: See %BDivides::operator().
 		return y != _type(-1) || x != std::numeric_limits<_type>::min()
-			? DivRemResult{_type(x / y), _type(x % y)} : DividesOverflow(x);
+			? DivRemResult{_type(x / y), _type(x % y)} : DividesOverflow(x, a);
 	}
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline ValueObject
-	Int(BQuotientPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BQuotientPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type a)
 	{
 		YAssert(y != 0, "Invalid divisor found.");
 		// NOTE: See %BDivides::operator().
 		return y != _type(-1) || x != std::numeric_limits<_type>::min()
-			? _type(x / y) : QuotientOverflow(x);
+			? _type(x / y) : QuotientOverflow(x, a);
 	}
 	template<typename _type>
 	YB_ATTR_nodiscard YB_PURE static inline _type
-	Int(BRemainderPolicy, const _type& x, const _type& y) ynothrowv
+	Int(BRemainderPolicy, const _type& x, const _type& y,
+		BigInt::allocator_type) ynothrowv
 	{
 		YAssert(y != 0, "Invalid divisor found.");
 		return x % y;
 	}
+	//@}
+
+	//! \since build 955
+	static void
+	AdjustBig(BigInt&, BigInt&, const BigInt&) ynothrow
+	{}
 };
 //@}
 //@}
 
 
 YB_ATTR_nodiscard YB_PURE ValueObject
-Promote(NumCode code, const ValueObject& x, NumCode src_code)
+Promote(NumCode code, const ValueObject& x, NumCode src_code,
+	BigInt::allocator_type a = {})
 {
-	return DoNumLeafHinted<ValueObject>(src_code, DynNumCast(code), x);
+	return DoNumLeafHinted<ValueObject>(src_code, DynNumCast(code, a), x);
 }
 
 //! \since build 937
@@ -1341,13 +1933,13 @@ NumUnaryPredicate(const ValueObject& x) ynothrowv
 }
 
 //! \since build 937
-template<class _fUnary, typename _tRet = void>
+template<class _fUnary, typename _tRet = void, typename... _tParams>
 YB_ATTR_nodiscard ValueObject
-NumUnaryOp(ResolvedArg<>& x)
+NumUnaryOp(ResolvedArg<>& x, _tParams&&... args)
 {
 	auto res(MoveUnary(x));
 
-	DoNumLeaf<void>(res, GUOp<_fUnary, _tRet>(res));
+	DoNumLeaf<void>(res, GUOp<_fUnary, _tRet>(res, yforward(args)...));
 	return res;
 }
 
@@ -1373,13 +1965,17 @@ NumBinaryOp(ResolvedArg<>& x, ResolvedArg<>& y)
 {
 	const auto xcode(MapTypeIdToNumCode(x));
 	const auto ycode(MapTypeIdToNumCode(y));
-	const auto ret_bin([](ValueObject u, ValueObject v, NumCode code){
-		return DoNumLeafHinted<_tRet>(code, GBOp<_fBinary, _tRet>(), u, v);
+	// NOTE: Bignum results are allocated by the allocator of the first
+	//	operand.
+	const BigInt::allocator_type a(x.get().get_allocator());
+	const auto ret_bin([a](ValueObject u, ValueObject v, NumCode code){
+		return DoNumLeafHinted<_tRet>(code, GBOp<_fBinary, _tRet>(a), u, v);
 	});
 
 	return size_t(xcode) >= size_t(ycode) ?
-		ret_bin(MoveUnary(x), Promote(xcode, y.get().Value, ycode), xcode)
-		: ret_bin(Promote(ycode, x.get().Value, xcode), MoveUnary(y), ycode);
+		ret_bin(MoveUnary(x), Promote(xcode, y.get().Value, ycode, a), xcode)
+		: ret_bin(Promote(ycode, x.get().Value, xcode, a), MoveUnary(y),
+		ycode);
 }
 
 
@@ -1632,6 +2228,34 @@ ReadDecimalExact(ValueObject& vo, string_view id,
 	}) == ReductionStatus::Partial;
 }
 
+/*!
+\brief 读取超过 fixnum 范围的十进制精确数。
+\return 是否读取为 bignum ；否则，数值表示不是精确数。
+\since build 955
+
+第三参数指定跳过前导 0 的数字的起始位置，第四参数指定未被读取的剩余部分的起始位置。
+*/
+YB_ATTR_nodiscard bool
+ReadDecimalBignum(ValueObject& vo, string_view id,
+	string_view::const_iterator digits, string_view::const_iterator first,
+	BigInt::allocator_type a)
+{
+	YAssert(!id.empty(), "Invalid lexeme found.");
+	if(std::all_of(first, id.end(), [](char c) ynothrow{
+		return ystdex::isdigit(c);
+	}))
+	{
+		auto res(BigInt::FromDecimal(id.substr(size_t(digits - id.begin())),
+			a));
+
+		if(id[0] == '-')
+			res.Negate();
+		vo = NormalizeInt(std::move(res));
+		return true;
+	}
+	return {};
+}
+
 //! \since build 932
 //@{
 // NOTE: IEC 60559 floating-point binary representation is preferred.
@@ -3526,11 +4150,274 @@ WriteFPSubnormal(char* buf, long double val, char e, size_t prec) ynothrowv
 inline namespace Math
 {
 
+BigInt&
+BigInt::operator=(BigInt&& x)
+{
+	if(get_allocator() == x.get_allocator())
+		limbs.swap(x.limbs);
+	else
+		limbs.assign(x.limbs.begin(), x.limbs.end());
+	negative = x.negative;
+	x.negative = {};
+	x.limbs.clear();
+	return *this;
+}
+
+BigInt
+BigInt::FromDecimal(string_view sv, allocator_type a)
+{
+	YAssertNonnull(sv.data());
+
+	// NOTE: Powers of 10 for the chunks.
+	static yconstexpr const Limb pow10[]{1, 10, 100, 1000, 10000, 100000,
+		1000000, 10000000, 100000000, 1000000000};
+	BigInt res(a);
+	auto first(sv.begin());
+	bool neg = {};
+
+	if(first != sv.end() && (*first == '+' || *first == '-'))
+	{
+		neg = *first == '-';
+		++first;
+	}
+	if(first == sv.end())
+		throw std::invalid_argument("Empty digits found.");
+
+	const auto n(size_t(sv.end() - first));
+
+	// NOTE: The first chunk has the remained digits, so the others are all
+	//	exactly 9 digits.
+	res.limbs.reserve(n / 9 + 1);
+	for(size_t len(n % 9 == 0 ? 9 : n % 9); first != sv.end(); len = 9)
+	{
+		Limb chunk(0);
+
+		for(const auto last(first + ptrdiff_t(len)); first != last; ++first)
+			if(ystdex::isdigit(*first))
+				chunk = DecimalCarryAddDigit(chunk, *first);
+			else
+				throw std::invalid_argument(ystdex::sfmt(
+					"Invalid character '%c' found in decimal digits.", *first));
+		MulAddSmall(res.limbs, pow10[len], chunk);
+	}
+	res.negative = neg;
+	res.Trim();
+	return res;
+}
+
+BigInt
+BigInt::operator-() const&
+{
+	BigInt res(*this, get_allocator());
+
+	res.Negate();
+	return res;
+}
+BigInt
+BigInt::operator-() &&
+{
+	BigInt res(std::move(*this));
+
+	res.Negate();
+	return res;
+}
+
+BigInt&
+BigInt::operator+=(const BigInt& y)
+{
+	if(negative == y.negative)
+		AddTo(limbs, y.limbs);
+	else if(SubFrom(limbs, y.limbs))
+		negative = !negative;
+	Trim();
+	return *this;
+}
+
+BigInt&
+BigInt::operator-=(const BigInt& y)
+{
+	if(negative != y.negative)
+		AddTo(limbs, y.limbs);
+	else if(SubFrom(limbs, y.limbs))
+		negative = !negative;
+	Trim();
+	return *this;
+}
+
+BigInt&
+BigInt::operator*=(const BigInt& y)
+{
+	if(!(limbs.empty() || y.limbs.empty()))
+	{
+		LimbVector r(limbs.size() + y.limbs.size(), Limb(), get_allocator());
+
+		if(limbs.size() >= y.limbs.size())
+			MulMagnitude(r.data(), limbs.data(), limbs.size(), y.limbs.data(),
+				y.limbs.size(), get_allocator());
+		else
+			MulMagnitude(r.data(), y.limbs.data(), y.limbs.size(),
+				limbs.data(), limbs.size(), get_allocator());
+		limbs.swap(r);
+		negative = negative != y.negative;
+		Trim();
+	}
+	else
+	{
+		limbs.clear();
+		negative = {};
+	}
+	return *this;
+}
+
+BigInt&
+BigInt::operator/=(const BigInt& y)
+{
+	BigInt r(get_allocator());
+
+	DivRem(*this, y, *this, r);
+	return *this;
+}
+
+BigInt&
+BigInt::operator%=(const BigInt& y)
+{
+	BigInt q(get_allocator());
+
+	DivRem(*this, y, q, *this);
+	return *this;
+}
+
+bool
+operator==(const BigInt& x, const BigInt& y) ynothrow
+{
+	return x.negative == y.negative && x.limbs == y.limbs;
+}
+
+bool
+operator<(const BigInt& x, const BigInt& y) ynothrow
+{
+	if(x.negative == y.negative)
+	{
+		const int c(CompareMagnitude(x.limbs, y.limbs));
+
+		return x.negative ? c > 0 : c < 0;
+	}
+	return x.negative;
+}
+
+void
+BigInt::DivRem(const BigInt& x, const BigInt& y, BigInt& q, BigInt& r)
+{
+	if(y.IsZero())
+		throw std::domain_error("Division by zero.");
+
+	// NOTE: The temporary objects allow the aliasing of the parameters.
+	BigInt quo(x.get_allocator()), rem(x.get_allocator());
+
+	if(CompareMagnitude(x.limbs, y.limbs) >= 0)
+		DivRemMagnitude(x.limbs, y.limbs, quo.limbs, rem.limbs);
+	else
+		rem.limbs.assign(x.limbs.begin(), x.limbs.end());
+	quo.negative = x.negative != y.negative;
+	rem.negative = x.negative;
+	quo.Trim();
+	rem.Trim();
+	q = std::move(quo);
+	r = std::move(rem);
+}
+
+string
+BigInt::ToString(string::allocator_type a) const
+{
+	string res(a);
+
+	if(!limbs.empty())
+	{
+		// NOTE: Convert to chunks of 9 decimal digits in the reversed order.
+		LimbVector t(limbs, get_allocator()), chunks(get_allocator());
+
+		chunks.reserve(limbs.size() * 10 / 9 + 1);
+		while(!t.empty())
+			chunks.push_back(DivRemSmall(t, 1000000000));
+
+		char buf[9];
+
+		res.reserve(chunks.size() * 9 + 1);
+		if(negative)
+			res += '-';
+		res.append(&buf[0], WriteDecimalDigitsIn<9>(buf, chunks.back()));
+		chunks.pop_back();
+		for(auto i(chunks.size()); i-- != 0;)
+		{
+			buf[0] = char('0' + chunks[i] / 100000000);
+			DecimalDigits<8>::Write(&buf[1], chunks[i] % 100000000);
+			res.append(&buf[0], 9);
+		}
+	}
+	else
+		res += '0';
+	return res;
+}
+
+void
+BigInt::Assign(std::uint64_t m, bool neg)
+{
+	limbs.clear();
+	if(m != 0)
+	{
+		limbs.push_back(Limb(m));
+		if(m >> LimbBits != 0)
+			limbs.push_back(Limb(m >> LimbBits));
+	}
+	negative = neg && m != 0;
+}
+
+void
+BigInt::AssignFloat(long double x)
+{
+	YAssert(std::isfinite(x), "Invalid floating-point value found.");
+
+	static yconstexpr const long double base(4294967296.0L);
+
+	x = std::trunc(x);
+	negative = std::signbit(x);
+	x = std::fabs(x);
+	limbs.clear();
+	while(x >= 1)
+	{
+		const auto q(std::floor(x / base));
+
+		limbs.push_back(Limb(x - q * base));
+		x = q;
+	}
+	Trim();
+}
+
+void
+BigInt::Trim() ynothrow
+{
+	TrimLimbs(limbs);
+	if(limbs.empty())
+		negative = {};
+}
+
+long double
+BigInt::ToFloat() const ynothrow
+{
+	// XXX: This may be imprecise due to the rounding of each step.
+	long double res(0);
+
+	for(auto i(limbs.size()); i-- != 0;)
+		res = res * 4294967296.0L + limbs[i];
+	return negative ? -res : res;
+}
+
+
 bool
 IsExactValue(const ValueObject& vo) ynothrow
 {
 	// TODO: Add rationals.
-	return IsFixnumValue(vo) || false;
+	return IsFixnumValue(vo) || IsTyped<BigInt>(vo);
 }
 
 bool
@@ -3699,13 +4586,13 @@ Min(ResolvedArg<>&& x, ResolvedArg<>&& y)
 ValueObject
 Add1(ResolvedArg<>&& x)
 {
-	return NumUnaryOp<AddOne>(x);
+	return NumUnaryOp<AddOne>(x, x.get().get_allocator());
 }
 
 ValueObject
 Sub1(ResolvedArg<>&& x)
 {
-	return NumUnaryOp<SubOne>(x);
+	return NumUnaryOp<SubOne>(x, x.get().get_allocator());
 }
 
 ValueObject
@@ -3735,7 +4622,7 @@ Divides(ResolvedArg<>&& x, ResolvedArg<>&& y)
 ValueObject
 Abs(ResolvedArg<>&& x)
 {
-	return NumUnaryOp<ReplaceAbs>(x);
+	return NumUnaryOp<ReplaceAbs>(x, x.get().get_allocator());
 }
 
 array<ValueObject, 2>
@@ -3786,7 +4673,8 @@ Inexact(ResolvedArg<>&& x)
 } // inline namespace Math;
 
 void
-ReadDecimal(ValueObject& vo, string_view id, string_view::const_iterator first)
+ReadDecimal(ValueObject& vo, string_view id, string_view::const_iterator first,
+	BigInt::allocator_type a)
 {
 	// NOTE: These types are fixed to ensure values only different by signs
 	//	would be likely of the same type. Otherwise, if non-negative values are
@@ -3803,6 +4691,9 @@ ReadDecimal(ValueObject& vo, string_view id, string_view::const_iterator first)
 			++first;
 		else
 			break;
+
+	const auto digits(first);
+
 	yconstexpr_if(std::numeric_limits<ReadIntType>::max()
 		< std::numeric_limits<ReadExtIntType>::max())
 	{
@@ -3812,11 +4703,11 @@ ReadDecimal(ValueObject& vo, string_view id, string_view::const_iterator first)
 		{
 			ReadExtIntType lans(ans);
 
-			if(YB_UNLIKELY(ReadDecimalExact(vo, id, first, lans)))
+			if(YB_UNLIKELY(ReadDecimalExact(vo, id, first, lans))
+				&& !ReadDecimalBignum(vo, id, digits, first, a))
 				// NOTE: The cast is safe even when %ReadCommonType is unsigned
 				//	because %ReadDecimalExact may only add the minus sign on a
 				//	complete parse.
-				// TODO: Use a bigint instead of the inexact number?
 				ReadDecimalInexact(vo, first, id, ReadCommonType(lans),
 					id.end());
 		}
@@ -3825,7 +4716,8 @@ ReadDecimal(ValueObject& vo, string_view id, string_view::const_iterator first)
 	{
 		ReadIntType ans(0);
 
-		if(YB_UNLIKELY(ReadDecimalExact(vo, id, first, ans)))
+		if(YB_UNLIKELY(ReadDecimalExact(vo, id, first, ans))
+			&& !ReadDecimalBignum(vo, id, digits, first, a))
 			// NOTE: Ditto.
 			ReadDecimalInexact(vo, first, id, ReadCommonType(ans), id.end());
 	}
@@ -11,13 +11,13 @@
 /*!	\file SContext.cpp
 \ingroup NPL
 \brief S 表达式上下文。
-\version r2314
+\version r2315
 \author FrankHB <frankhb1989@gmail.com>
 \since build 329
 \par 创建时间:
 	2012-08-03 19:55:59 +0800
 \par 修改时间:
-	2022-06-13 01:32 +0800
+	2026-10-17 10:31 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -279,7 +279,7 @@ TermNode::ConSub(const Container& con, allocator_type a)
 
 
 void
-ReaderState::UpdateLexeme(const string& lexeme)
+ReaderState::UpdateLexeme(string_view lexeme)
 {
 	if(lexeme.length() == 1)
 	{
@@ -11,13 +11,13 @@
 /*!	\file FileSystem.cpp
 \ingroup YCLib
 \brief 平台相关的文件系统接口。
-\version r4991
+\version r4992
 \author FrankHB <frankhb1989@gmail.com>
 \since build 312
 \par 创建时间:
 	2012-05-30 22:41:35 +0800
 \par 修改时间:
-	2022-04-30 21:54 +0800
+	2026-10-17 16:41 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -944,6 +944,22 @@ YCL_Impl_FileSystem_ufunc_1(uremove)
 YCL_Impl_FileSystem_ufunc_2(std::remove, )
 #endif
 
+bool
+urename(const char* from, const char* to) ynothrowv
+{
+	YAssertNonnull(from), YAssertNonnull(to);
+#if YCL_Win32
+	// NOTE: %::_wrename fails if the destination exists.
+	return CallNothrow({}, [=]{
+		return ::MoveFileExW(MakePathStringW(from).c_str(),
+			MakePathStringW(to).c_str(), MOVEFILE_REPLACE_EXISTING)
+			|| (errno = GetErrnoFromWin32(), false);
+	});
+#else
+	return std::rename(from, to) == 0;
+#endif
+}
+
 #undef YCL_Impl_FileSystem_ufunc_1
 #undef YCL_Impl_FileSystem_ufunc_2
 #undef YCL_Impl_FileSystem_ufunc
@@ -11,13 +11,13 @@
 /*!	\file ValueNode.cpp
 \ingroup Core
 \brief 值类型节点。
-\version r908
+\version r909
 \author FrankHB <frankhb1989@gmail.com>
 \since build 338
 \par 创建时间:
 	2012-08-03 23:04:03 +0800
 \par 修改时间:
-	2022-02-26 23:04 +0800
+	2026-10-17 13:51 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -219,13 +219,13 @@ IsPrefixedIndex(string_view name, char prefix)
 {
 	YAssertNonnull(name.data());
 	if(name.length() > 1 && name.front() == prefix)
-		try
-		{
-			const auto ss(name.substr(1));
+	{
+		const auto ss(name.substr(1));
 
-			return MakeIndex(DecodeIndex(ss)) == ss;
-		}
-		CatchIgnore(std::invalid_argument&)
+		// NOTE: This avoids the exception thrown by %DecodeIndex for
+		//	non-index names, which are common in printing.
+		return IsDecodableIndex(ss) && MakeIndex(DecodeIndex(ss)) == ss;
+	}
 	return {};
 }
 
@@ -255,11 +255,10 @@ MakeIndex(size_t n)
 	return str;
 }
 
-size_t
-DecodeIndex(string_view sv)
+bool
+IsDecodableIndex(string_view sv) ynothrowv
 {
 	YAssert(sv.data(), "Invalid argument found.");
-
 	if(!sv.empty())
 	{
 		// XXX: Conversion might be implementation-defined with steady result
@@ -267,17 +266,26 @@ DecodeIndex(string_view sv)
 		const auto lb(size_t(sv.front()));
 		const size_t sz(sv.size());
 
-		if(sz < std::numeric_limits<size_t>::digits / 8 + 1
-			&& sz == (lb + 7) / 8 + 1)
+		return sz < std::numeric_limits<size_t>::digits / 8 + 1
+			&& sz == (lb + 7) / 8 + 1;
+	}
+	return {};
+}
+
+size_t
+DecodeIndex(string_view sv)
+{
+	if(IsDecodableIndex(sv))
+	{
+		const size_t sz(sv.size());
+		size_t n(0);
+
+		for(size_t i(1); i < sz; ++i)
 		{
-			size_t n(0);
-			for(size_t i(1); i < sz; ++i)
-			{
-				n <<= 8;
-				n |= size_t(sv[i]);
-			}
-			return n;
+			n <<= 8;
+			n |= size_t(sv[i]);
 		}
+		return n;
 	}
 	throw std::invalid_argument("Invalid string name found.");
 }
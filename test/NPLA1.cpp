@@ -0,0 +1,356 @@
+﻿/*
+	© 2026 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file NPLA1.cpp
+\ingroup Test
+\brief NPLA1 测试。
+\version r4
+\author FrankHB <frankhb1989@gmail.com>
+\since build 955
+\par 创建时间:
+	2026-10-17 15:20:36 +0800
+\par 修改时间:
+	2026-10-17 17:21 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	Test::NPLA1
+*/
+
+
+#include <ytest/test.h>
+#include <NPL/Dependency.h> // for NPL::A1::GlobalState,
+//	NPL::A1::ContextState, NPL::A1::Profiler,
+//	NPL::A1::Forms::LoadStandardContext, NPL::SwitchToFreshEnvironment,
+//	NPL::A1::Perform, NPL::EnvironmentCollector, NPL::TermReference,
+//	NPL::A1::SetupConstantFolding, NPL::A1::MarkPureCombiners;
+#include <iostream>
+
+// NOTE: The cases not depending on the native interface are in the NPLA1
+//	scripts instead.
+
+namespace
+{
+
+using namespace ytest;
+using ystdex::seq_apply;
+using namespace NPL;
+using namespace A1;
+
+void
+show_result(std::ostream& out, const std::string& name, size_t pass_n,
+	size_t fail_n)
+{
+	out << name << ": " << pass_n << '/' << pass_n + fail_n << '.'
+		<< std::endl;
+}
+
+//! \brief 在剖析的上下文中求值并检查剖析器的状态。
+namespace profiler_test
+{
+
+template<typename _func>
+bool
+check(const char* setup, const char* expr, _func f)
+{
+	GlobalState global;
+	ContextState cs(global);
+	const auto p_profiler(YSLib::make_shared<Profiler>());
+
+	cs.Trace.FilterLevel = YSLib::Logger::Level::Informative;
+	Forms::LoadStandardContext(cs);
+	// NOTE: The ground environment is frozen.
+	yunused(NPL::SwitchToFreshEnvironment(cs, ValueObject(cs.ShareRecord())));
+	Perform(cs, setup);
+	cs.ProfilerPtr = p_profiler;
+	try
+	{
+		Perform(cs, expr);
+	}
+	catch(std::exception&)
+	{}
+	return f(cs, *p_profiler);
+}
+
+} // namespace profiler_test;
+
+//! \brief 检查读取引用输入的源代码时使用替换的叶节点词素转换器。
+namespace reader_test
+{
+
+template<typename _func>
+bool
+check(bool sourced, _func set_converter)
+{
+	GlobalState global;
+	ContextState cs(global);
+	size_t n(0);
+
+	global.UseSourceLocation = sourced;
+	set_converter(global, n);
+
+	const auto term(global.ReadFrom(GlobalState::LoadOptionTag<>(),
+		string_view("a (b c) \"d\""), cs));
+
+	return n == 4 && term.size() == 3;
+}
+
+} // namespace reader_test;
+
+//! \brief 检查环境回收器回收的环境。
+namespace collector_test
+{
+
+//! \brief 分配被追踪的环境，并在其中绑定自身以形成循环引用。
+shared_ptr<Environment>
+make_cyclic(EnvironmentCollector& gc)
+{
+	auto p_env(YSLib::make_shared<Environment>(Environment::allocator_type()));
+
+	p_env->AddValue("self", p_env);
+	gc.Add(p_env);
+	return p_env;
+}
+
+//! \brief 在被激活的回收器中求值，频繁地触发回收。
+bool
+check_nested(const char* setup, const char* expr, int expected)
+{
+	GlobalState global;
+	ContextState cs(global);
+	EnvironmentCollector gc;
+
+	cs.Trace.FilterLevel = YSLib::Logger::Level::Informative;
+	Forms::LoadStandardContext(cs);
+	yunused(NPL::SwitchToFreshEnvironment(cs, ValueObject(cs.ShareRecord())));
+	Perform(cs, setup);
+	// NOTE: Each collection also traces the environment allocated previously,
+	//	which has the bindings populated.
+	gc.Threshold = 2;
+
+	const auto p_prev(EnvironmentCollector::SwitchActive(make_observer(&gc)));
+	const auto gd(ystdex::make_guard([&]() ynothrow{
+		EnvironmentCollector::SwitchActive(p_prev);
+	}));
+
+	try
+	{
+		const auto term(Perform(cs, expr));
+		const auto p(term.Value.AccessPtr<int>());
+
+		return p && *p == expected && gc.GetStatistics().Collections != 0;
+	}
+	catch(std::exception&)
+	{}
+	return {};
+}
+
+} // namespace collector_test;
+
+//! \brief 检查启用常量折叠时的求值结果。
+namespace fold_test
+{
+
+/*!
+\note 第二参数指定在求值第一参数后标记的纯合并子，使之后读取的项中的调用被折叠。
+\note 第三参数中被折叠的调用应是在被重复求值的函数体中的列表子项。
+*/
+bool
+check(const char* setup, std::initializer_list<string_view> names,
+	const char* expr)
+{
+	GlobalState global;
+	ContextState cs(global);
+
+	cs.Trace.FilterLevel = YSLib::Logger::Level::Informative;
+	Forms::LoadStandardContext(cs);
+	SetupConstantFolding(global);
+	yunused(NPL::SwitchToFreshEnvironment(cs, ValueObject(cs.ShareRecord())));
+	try
+	{
+		Perform(cs, setup);
+		MarkPureCombiners(cs, names);
+
+		const auto term(Perform(cs, expr));
+		const auto p(term.Value.AccessPtr<bool>());
+
+		return p && *p;
+	}
+	catch(std::exception&)
+	{}
+	return {};
+}
+
+} // namespace fold_test;
+
+} // unnamed namespace;
+
+
+int
+main()
+{
+	using std::cout;
+	using std::endl;
+	const auto make_guard([](const std::string& subject){
+		return group_guard(subject, [](group_guard& printer){
+			cout << "CASES: " << printer.subject << ':' << endl;
+		}, [](group_guard& printer){
+			show_result(cout, printer.subject, printer.pass_n, printer.fail_n);
+		});
+	});
+	size_t pass_n(0), fail_n(0), case_n(0);
+	const auto pass([&]{
+		yunseq(++pass_n, cout << '#' << ++case_n << ": PASS." << endl);
+	});
+	const auto fail([&]{
+		yunseq(++fail_n, cout << '#' << ++case_n << ": FAIL." << endl);
+	});
+	// NOTE: The calls to 'f' and 'g' are not in tail contexts.
+	const auto setup("$defl! g (x) list ($if x (raise-error \"error\") x);"
+		" $defl! f (x) list (g x);");
+
+	// 3 cases covering: NPL::A1::Profiler, NPL::A1::ContextState::ProfilerPtr.
+	seq_apply(make_guard("NPLA1.Profiler").get(pass, fail),
+		// NOTE: Calls exited normally.
+		profiler_test::check(setup, "f #f",
+			[](ContextState&, const Profiler& pf){
+			const auto p(pf.Find("f"));
+
+			return pf.GetDepth() == 0 && p && p->Calls == 1 && p->Active == 0;
+		}),
+		// NOTE: Calls exited by the exception.
+		profiler_test::check(setup, "f #t",
+			[](ContextState&, const Profiler& pf){
+			const auto p_f(pf.Find("f"));
+			const auto p_g(pf.Find("g"));
+
+			return pf.GetDepth() == 0 && p_f && p_f->Active == 0 && p_g
+				&& p_g->Active == 0;
+		}),
+		// NOTE: Calls after the exception are not nested in the exited calls.
+		profiler_test::check(setup, "f #t",
+			[](ContextState& cs, const Profiler& pf){
+			Perform(cs, "f #f");
+
+			const auto p(pf.Find("f"));
+
+			return pf.GetDepth() == 0 && p && p->Calls == 2 && p->Active == 0;
+		})
+	);
+	// 2 cases covering: NPL::A1::GlobalState::ConvertLeaf,
+	//	NPL::A1::GlobalState::ConvertLeafSourced.
+	seq_apply(make_guard("NPLA1.Reader").get(pass, fail),
+		reader_test::check({}, [](GlobalState& global, size_t& n){
+			global.ConvertLeaf = [&](const GParsedValue<ByteParser>& str){
+				TermNode term(global.Allocator);
+
+				++n;
+				ParseLeaf(term, YSLib::make_string_view(str));
+				return term;
+			};
+		}),
+		reader_test::check(true, [](GlobalState& global, size_t& n){
+			global.ConvertLeafSourced = [&](const GParsedValue<
+				SourcedByteParser>& val, const ContextState&){
+				TermNode term(global.Allocator);
+
+				++n;
+				ParseLeaf(term, YSLib::make_string_view(val.second));
+				return term;
+			};
+		})
+	);
+	// 4 cases covering: NPL::EnvironmentCollector::Collect.
+	seq_apply(make_guard("NPLA.EnvironmentCollector").get(pass, fail),
+		// NOTE: An environment only referenced by itself is collected.
+		[]{
+			EnvironmentCollector gc;
+			const weak_ptr<Environment> p_weak(collector_test::make_cyclic(gc));
+			const bool alive(!p_weak.expired());
+
+			gc.Collect();
+			return alive && p_weak.expired()
+				&& gc.GetStatistics().Environments == 1;
+		}(),
+		// NOTE: An environment referenced by a term reference is kept.
+		[]{
+			EnvironmentCollector gc;
+			TermNode term;
+			auto p_env(collector_test::make_cyclic(gc));
+			const TermReference ref(term, p_env);
+			const weak_ptr<Environment> p_weak(p_env);
+
+			p_env.reset();
+			gc.Collect();
+
+			const auto p_kept(ref.GetEnvironmentReference().Lock());
+
+			return p_kept && p_kept == p_weak.lock()
+				&& p_kept->GetMapRef().size() == 1
+				&& gc.GetStatistics().Environments == 0;
+		}(),
+		// NOTE: An environment held by a value not traced is kept until the
+		//	holder is collected.
+		[]{
+			EnvironmentCollector gc;
+			auto p_holder(collector_test::make_cyclic(gc));
+			auto p_env(collector_test::make_cyclic(gc));
+			const weak_ptr<Environment> p_weak(p_env);
+
+			// NOTE: The pair type is not recognized without
+			//	%EnvironmentCollector::Trace.
+			p_holder->AddValue("held",
+				pair<shared_ptr<Environment>, int>(std::move(p_env), 0));
+			p_holder.reset();
+			gc.Collect();
+
+			const bool kept(!p_weak.expired()
+				&& p_weak.lock()->GetMapRef().size() == 1
+				&& gc.GetStatistics().Environments == 1);
+
+			// NOTE: The holder is released by the previous collection.
+			gc.Collect();
+			return kept && p_weak.expired()
+				&& gc.GetStatistics().Environments == 2;
+		}(),
+		// NOTE: Collections in nested calls keep the environments of the
+		//	active frames and the closures.
+		collector_test::check_nested("$import! std.math + -;"
+			" $defl! mk (n) $lambda/e (() lock-current-environment) () n;"
+			" $defl! f (n) $if (eqv? n 0) 0 ($let ((g (mk n)))"
+			" $let ((r (f (- n 1)))) + r (() g));", "f 10", 55)
+	);
+	// 4 cases covering: NPL::A1::SetupConstantFolding,
+	//	NPL::A1::MarkPureCombiners.
+	seq_apply(make_guard("NPLA1.ConstantFolding").get(pass, fail),
+		// NOTE: A folded call is not reused after the combiner is redefined.
+		fold_test::check("$import! std.strings ++;", {},
+			"$defl! f () (++ \"a\" \"b\"); $def! x () f;"
+			" $def! ++ $lambda (.) \"c\"; $def! y () f;"
+			" $and (equal? x \"ab\") (equal? y \"c\")"),
+		// NOTE: A folded call is not reused when the combiner is shadowed by a
+		//	local binding.
+		fold_test::check("$import! std.math + -;", {},
+			"$defl! h (op) $let ((+ op)) (+ 1 2); $def! x h +; $def! y h -;"
+			" $def! z h +; $and (eqv? x 3) (eqv? y -1) (eqv? z 3)"),
+		// NOTE: The folded value is copied to the result, so a modified result
+		//	does not change the results of later calls.
+		fold_test::check("", {}, "$defl! mk () (list 1 2); $def! a () mk;"
+			" set-first! a 9; $def! b () mk; set-first! b 8; $def! c () mk;"
+			" $and (eqv? (first a) 9) (eqv? (first b) 8) (eqv? (first c) 1)"),
+		// NOTE: Results containing references are not saved, even if the
+		//	combiner is marked pure.
+		fold_test::check("$def! (a b mode) list 1 2 0;"
+			" $defl%! pick (x) $if (eqv? mode 0) a b;", {"pick"},
+			"$defl! f () (pick 0); $def! x () f; assign! mode 1;"
+			" $def! y () f; $and (eqv? x 1) (eqv? y 2)")
+	);
+	show_result(cout, "ALL", pass_n, fail_n);
+}
@@ -0,0 +1,159 @@
+﻿/*
+	© 2026 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file NPLA1Benchmark.cpp
+\ingroup Test
+\brief NPLA1 基准测试。
+\version r5
+\author FrankHB <frankhb1989@gmail.com>
+\since build 955
+\par 创建时间:
+	2026-10-17 15:02:11 +0800
+\par 修改时间:
+	2026-10-17 17:32 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	Test::NPLA1Benchmark
+*/
+
+
+#include <NPL/Dependency.h> // for NPL::A1::GlobalState,
+//	NPL::A1::ContextState, NPL::A1::Forms::LoadStandardContext,
+//	NPL::SwitchToFreshEnvironment, NPL::A1::Perform, NPL::LexicalAnalyzer,
+//	NPL::ByteParser, NPL::string;
+#include <ytest/timing.hpp> // for ytest::timing::average;
+#include <chrono> // for std::chrono::steady_clock, std::chrono::duration;
+#include <iostream> // for std::cout;
+#include <iomanip> // for std::setw;
+
+namespace
+{
+
+using namespace NPL;
+using namespace A1;
+using std::chrono::steady_clock;
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+//! \brief 基准测试用例。
+struct BenchmarkCase final
+{
+	const char* Name;
+	//! \brief 被测试的定义的源代码。
+	const char* Setup;
+	//! \brief 被计时的表达式的源代码。
+	const char* Expression;
+	size_t Repeat;
+};
+
+const BenchmarkCase Cases[]{
+	{"nested-body", "$defl! f (n) $if (eqv? n 0) () ($sequence"
+		" (list (list n n) (list n (list n n)) (list (list (list n) n)))"
+		" (f (- n 1)));", "f 2000", 20},
+	// NOTE: The numeric loops operate mostly on the fixnums.
+	{"fib", "$defl! fib (n) $if (<? n 2) n (+ (fib (- n 1)) (fib (- n 2)));",
+		"fib 20", 5},
+	{"tak", "$defl! tak (x y z) $if (<? y x) (tak (tak (- x 1) y z)"
+		" (tak (- y 1) z x) (tak (- z 1) x y)) z;", "tak 18 12 6", 5}
+};
+
+//! \brief 测试被计时的表达式的平均求值时间。
+milliseconds
+Measure(const BenchmarkCase& bc)
+{
+	GlobalState global;
+	ContextState cs(global);
+
+	cs.Trace.FilterLevel = YSLib::Logger::Level::Informative;
+	Forms::LoadStandardContext(cs);
+	// NOTE: The ground environment is frozen.
+	yunused(NPL::SwitchToFreshEnvironment(cs, ValueObject(cs.ShareRecord())));
+	Perform(cs, "$import! std.math + - <?;");
+	Perform(cs, bc.Setup);
+	// NOTE: Warm up.
+	Perform(cs, bc.Expression);
+	return ytest::timing::average(bc.Repeat, steady_clock::now, [&]{
+		Perform(cs, bc.Expression);
+	});
+}
+
+void
+Report(const BenchmarkCase& bc)
+{
+	std::cout << std::setw(16) << bc.Name << std::setw(12)
+		<< Measure(bc).count() << " ms" << std::endl;
+}
+
+
+//! \brief 词法分析基准测试用例。
+struct LexerCase final
+{
+	const char* Name;
+	//! \brief 重复构成输入的源代码片段。
+	const char* Unit;
+};
+
+const LexerCase LexerCases[]{
+	{"lex-code", "$defl! tak (x y z) $if (<? y x) (tak (tak (- x 1) y z)"
+		" (tak (- y 1) z x) (tak (- z 1) x y)) z;\n"},
+	{"lex-strings", "$def! s \"The quick brown fox jumps over the lazy dog,"
+		" then the \\\"dog\\\" sleeps again.\";\n"}
+};
+
+//! \brief 输入的大小。
+yconstexpr const size_t LexerInputSize(1U << 22);
+
+//! \brief 测试参数指定的解析例程对输入的平均词法分析吞吐量。
+template<typename _func>
+double
+MeasureLexer(const string& src, _func f)
+{
+	const milliseconds t(ytest::timing::average(5, steady_clock::now, [&]{
+		LexicalAnalyzer lexer;
+		ByteParser parse(lexer, src.get_allocator());
+
+		f(parse);
+		yunused(parse.GetResult().size());
+	}));
+
+	return double(src.size()) / t.count() / 1000;
+}
+
+void
+Report(const LexerCase& lc)
+{
+	string src;
+
+	while(src.size() < LexerInputSize)
+		src += lc.Unit;
+
+	const auto first(src.data()), last(first + src.size());
+
+	std::cout << std::setw(16) << lc.Name << std::setw(12)
+		<< MeasureLexer(src, [&](ByteParser& parse){
+			parse(first, last);
+		}) << " MB/s (bulk)," << std::setw(12)
+		<< MeasureLexer(src, [&](ByteParser& parse){
+			for(auto p(first); p != last; ++p)
+				parse(*p);
+		}) << " MB/s (per byte)" << std::endl;
+}
+
+} // unnamed namespace;
+
+
+int
+main()
+{
+	for(const auto& bc : Cases)
+		Report(bc);
+	for(const auto& lc : LexerCases)
+		Report(lc);
+}
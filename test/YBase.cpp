@@ -11,13 +11,13 @@
 /*!	\file test.cpp
 \ingroup Test
 \brief YBase 测试。
-\version r762
+\version r770
 \author FrankHB <frankhb1989@gmail.com>
 \since build 519
 \par 创建时间:
 	2014-07-10 05:09:57 +0800
 \par 修改时间:
-	2022-02-05 09:34 +0800
+	2026-10-17 17:52 +0800
 \par 文本编码:
 	UTF-8
 \par 模块名称:
@@ -39,6 +39,10 @@
 #include <ystdex/tstring_view.hpp>
 #include <ystdex/mixin.hpp>
 #include <ystdex/bitseg.hpp>
+#include <ystdex/concurrency.h>
+#include <ystdex/cache.hpp>
+#include <ystdex/memory_resource.h>
+#include <atomic>
 
 // NOTE: %YB_ATTR_nodiscard is not used to improve the translation performance
 //	of the test, if any. %YB_PURE and some other attributes are also not used
@@ -238,6 +242,40 @@ t_constfn() ynothrow
 	return ystdex::addressof(x) == std::addressof(x);
 }
 
+/*!
+\brief 记录未被去配的分配数的资源。
+\since build 955
+*/
+class counting_resource final : public ystdex::pmr::memory_resource
+{
+public:
+	size_t count = 0;
+
+private:
+	void*
+	do_allocate(size_t bytes, size_t alignment) override
+	{
+		const auto p(ystdex::pmr::new_delete_resource()->allocate(bytes,
+			alignment));
+
+		++count;
+		return p;
+	}
+
+	void
+	do_deallocate(void* p, size_t bytes, size_t alignment) ynothrow override
+	{
+		--count;
+		ystdex::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	bool
+	do_is_equal(const memory_resource& r) const ynothrow override
+	{
+		return this == &r;
+	}
+};
+
 } // namespace memory_test;
 
 //! \since build 851
@@ -659,6 +697,413 @@ main()
 		bitseg_test::expect<4>("10203050710c0fff", bytes),
 		bitseg_test::expect<4, true>("0102030517c0f0ff", bytes)
 	);
+	// 10 cases covering: ystdex::work_stealing_pool, ystdex::task_pool,
+	//	ystdex::task_graph, ystdex::spsc_ring, ystdex::mpmc_ring.
+	seq_apply(make_guard("YStandard.Concurrency").get(pass, fail),
+		expect(size_t(1000 * 999 / 2), []{
+			work_stealing_pool pool(4);
+			std::vector<std::future<size_t>> futures;
+			size_t sum(0);
+
+			for(size_t i(0); i < 1000; ++i)
+				futures.push_back(pool.enqueue([](size_t n){
+					return n;
+				}, i));
+			for(auto& f : futures)
+				sum += f.get();
+			return sum;
+		}),
+		expect(size_t(1) << 12, []{
+			std::atomic<size_t> leaves(0);
+
+			{
+				work_stealing_pool pool(3);
+				struct fork final
+				{
+					work_stealing_pool& pool;
+					std::atomic<size_t>& leaves;
+					size_t depth;
+
+					void
+					operator()() const
+					{
+						if(depth == 0)
+							++leaves;
+						else
+						{
+							pool.post(fork{pool, leaves, depth - 1});
+							pool.post(fork{pool, leaves, depth - 1});
+						}
+					}
+				};
+
+				pool.post(fork{pool, leaves, 12});
+			}
+			return leaves.load();
+		}),
+		expect(make_pair(size_t(5), size_t(2)), []{
+			work_stealing_pool pool(3);
+			std::atomic<size_t> n(0);
+
+			for(size_t i(0); i < 3; ++i)
+				pool.post([&]{
+					++n;
+				});
+			pool.reset(2);
+			for(size_t i(0); i < 2; ++i)
+				pool.post([&]{
+					++n;
+				});
+			// NOTE: The posted tasks are run before the threads exit.
+			pool.reset(2);
+			return make_pair(n.load(), pool.get_thread_num());
+		}),
+		expect(size_t(200), []{
+			task_pool pool(2);
+			std::vector<std::future<size_t>> futures;
+			std::atomic<size_t> running(0);
+			size_t max_running(0);
+
+			for(size_t i(0); i < 200; ++i)
+			{
+				futures.push_back(pool.wait([&]{
+					++running;
+					std::this_thread::yield();
+					return running--;
+				}));
+				max_running = std::max(max_running, pool.size());
+			}
+
+			size_t n(0);
+
+			for(auto& f : futures)
+				if(f.get() != 0)
+					++n;
+			return max_running <= pool.get_max_task_num() ? n : 0;
+		}),
+		expect(true, []{
+			work_stealing_pool pool(3);
+			task_graph g;
+			std::atomic<size_t> seq(0);
+			size_t a(0), b(0), c(0), d(0);
+			const auto na(g.add([&]{
+				a = ++seq;
+			}));
+			const auto nb(g.then(na, [&]{
+				b = ++seq;
+			}));
+			const auto nc(g.then(na, [&]{
+				c = ++seq;
+			}));
+
+			g.when_all({nb, nc}, [&]{
+				d = ++seq;
+			});
+			g.run(pool);
+			g.wait();
+			return a == 1 && b > a && c > a && d == 4;
+		}),
+		expect(make_pair(string("failed"), size_t(0)), []{
+			task_pool pool(2);
+			task_graph g;
+			std::atomic<size_t> n(0);
+			const auto first(g.add([]{
+				throw std::runtime_error("failed");
+			}));
+
+			g.then(first, [&]{
+				++n;
+			});
+			g.run(pool.get_pool());
+			try
+			{
+				g.wait();
+			}
+			catch(std::runtime_error& e)
+			{
+				return std::make_pair(string(e.what()), n.load());
+			}
+			return std::make_pair(string(), size_t(1));
+		}),
+		expect(true, []{
+			work_stealing_pool pool(1);
+			task_graph g;
+			const auto x(g.add({}));
+			const auto y(g.then(x, {}));
+
+			g.precede(y, x);
+			try
+			{
+				g.run(pool);
+			}
+			catch(std::invalid_argument&)
+			{
+				return !g.is_running();
+			}
+			return false;
+		}),
+		expect(make_tuple(size_t(4), false, 1, 2), []{
+			spsc_ring<int> ring(3);
+			int x(0), y(0);
+
+			for(int i(1); i <= 4; ++i)
+				ring.try_push(i);
+
+			const bool full(ring.try_push(5));
+
+			ring.try_pop(x);
+			ring.try_pop(y);
+			return make_tuple(ring.capacity(), full, x, y);
+		}),
+		expect(true, []{
+			const size_t n(100000);
+			spsc_ring<size_t> ring(64);
+			std::thread producer([&]{
+				size_t buf[16];
+
+				for(size_t i(0); i < n;)
+				{
+					const auto k(std::min(n - i, size_t(16)));
+
+					for(size_t j(0); j < k; ++j)
+						buf[j] = i + j;
+
+					size_t pushed(0);
+
+					while(pushed < k)
+						pushed += ring.try_push_n(buf + pushed, k - pushed);
+					i += k;
+				}
+			});
+			bool ordered(true);
+
+			for(size_t i(0); i < n; ++i)
+				ordered = ring.spin_pop() == i && ordered;
+			producer.join();
+			return ordered && ring.empty();
+		}),
+		expect(size_t(3 * 20000 * 19999 / 2), []{
+			mpmc_ring<size_t> ring(128);
+			std::atomic<size_t> sum(0);
+			std::vector<std::thread> threads;
+
+			for(size_t i(0); i < 3; ++i)
+				threads.emplace_back([&]{
+					for(size_t j(0); j < 20000; ++j)
+						ring.spin_push(j);
+				});
+			for(size_t i(0); i < 3; ++i)
+				threads.emplace_back([&]{
+					size_t local(0);
+
+					for(size_t j(0); j < 20000; ++j)
+						local += ring.spin_pop();
+					sum += local;
+				});
+			for(auto& thrd : threads)
+				thrd.join();
+			return sum.load();
+		})
+	);
+	// 3 cases covering: ystdex::concurrent_cache.
+	seq_apply(make_guard("YStandard.Cache").get(pass, fail),
+		expect(make_tuple(false, true, size_t(3), size_t(1), size_t(1)), []{
+			concurrent_cache<int, int> cache(3, 1);
+			int x(0);
+
+			for(int i(1); i <= 3; ++i)
+				cache.insert(i, i);
+			cache.find(1, x);
+			cache.insert(4, 4);
+
+			const bool found2(cache.find(2, x));
+			const bool found1(cache.find(1, x));
+			const auto stat(cache.get_statistics());
+
+			return make_tuple(found2, found1, cache.size(), stat.misses,
+				stat.evictions);
+		}),
+		expect(make_tuple(false, false, true, size_t(8)), []{
+			concurrent_cache<int, string> cache(8, 1,
+				[](const int&, const string& str){
+				return str.size();
+			});
+			string x;
+
+			cache.insert(1, string("abcd"));
+			cache.insert(2, string("efgh"));
+
+			const bool oversized(cache.insert(3, string("too long value")));
+
+			cache.insert_or_assign(2, string("ijklmnopqrstu"));
+
+			const bool found2(cache.find(2, x));
+
+			cache.insert_or_assign(1, string("abcdefgh"));
+			return make_tuple(oversized, found2,
+				cache.find(1, x) && x == "abcdefgh", cache.get_weight());
+		}),
+		expect(true, []{
+			concurrent_cache<size_t, size_t> cache(256, 8);
+			std::atomic<size_t> wrong(0);
+			std::vector<std::thread> threads;
+
+			for(size_t i(0); i < 4; ++i)
+				threads.emplace_back([&, i]{
+					for(size_t j(0); j < 20000; ++j)
+					{
+						const auto k((j * 7 + i) % 512);
+
+						if(cache.lookup(k, [=]{
+							return k * 3;
+						}) != k * 3)
+							++wrong;
+						if(j % 64 == 0)
+							cache.erase(k);
+					}
+				});
+			for(auto& thrd : threads)
+				thrd.join();
+
+			const auto stat(cache.get_statistics());
+
+			return wrong == 0 && cache.get_weight() <= cache.get_budget()
+				&& stat.hits + stat.misses == 4 * 20000;
+		})
+	);
+	// 4 cases covering: ystdex::pmr::thread_cached_pool_resource.
+	seq_apply(make_guard("YStandard.MemoryResource").get(pass, fail),
+		expect(make_tuple(true, true, false), []{
+			ystdex::pmr::thread_cached_pool_resource rsrc;
+			const auto p(rsrc.allocate(24, 8));
+
+			rsrc.deallocate(p, 24, 8);
+
+			const auto q(rsrc.allocate(20, 4));
+			const auto r(rsrc.allocate(24, 8));
+			const bool reused(q == p), distinct(q != r);
+
+			rsrc.deallocate(q, 20, 4);
+			rsrc.deallocate(r, 24, 8);
+			rsrc.flush();
+
+			const auto big(rsrc.allocate(size_t(1) << 25, 16));
+
+			rsrc.deallocate(big, size_t(1) << 25, 16);
+			return make_tuple(reused, distinct, big == p);
+		}),
+		expect(true, []{
+			ystdex::pmr::thread_cached_pool_resource rsrc;
+			std::vector<void*> ptrs;
+
+			for(size_t i(0); i < 1000; ++i)
+				ptrs.push_back(rsrc.allocate(16, 8));
+			for(const auto p : ptrs)
+				rsrc.deallocate(p, 16, 8);
+			rsrc.release();
+
+			bool res(true);
+
+			ptrs.clear();
+			for(size_t i(0); i < 1000; ++i)
+			{
+				const auto p(static_cast<unsigned char*>(
+					rsrc.allocate(16, 8)));
+
+				std::fill_n(p, 16, (unsigned char)(i));
+				ptrs.push_back(p);
+			}
+			for(size_t i(0); i < 1000; ++i)
+			{
+				const auto p(static_cast<unsigned char*>(ptrs[i]));
+
+				res = res && p[0] == (unsigned char)(i)
+					&& p[15] == (unsigned char)(i);
+				rsrc.deallocate(p, 16, 8);
+			}
+			return res;
+		}),
+		expect(size_t(0), []{
+			const size_t n_thrd(4), n(5000);
+			ystdex::pmr::thread_cached_pool_resource rsrc;
+			std::vector<std::vector<std::pair<unsigned char*, size_t>>>
+				blocks(n_thrd);
+			std::atomic<size_t> bad(0);
+			const auto run([&](std::function<void(size_t)> f){
+				std::vector<std::thread> threads;
+
+				for(size_t i(0); i < n_thrd; ++i)
+					threads.emplace_back(f, i);
+				for(auto& thrd : threads)
+					thrd.join();
+			});
+
+			run([&](size_t i){
+				for(size_t j(0); j < n; ++j)
+				{
+					const auto size(size_t(8) << (j % 6));
+					const auto p(static_cast<unsigned char*>(
+						rsrc.allocate(size)));
+
+					std::fill_n(p, size, (unsigned char)(i));
+					blocks[i].emplace_back(p, size);
+					if(j % 3 == 0)
+					{
+						const auto& pr(blocks[i].back());
+
+						rsrc.deallocate(pr.first, pr.second);
+						blocks[i].pop_back();
+					}
+				}
+			});
+			// NOTE: Blocks are deallocated by threads other than the ones
+			//	allocating them.
+			run([&](size_t i){
+				const auto k((i + 1) % n_thrd);
+
+				for(const auto& pr : blocks[k])
+				{
+					if(pr.first[0] != (unsigned char)(k)
+						|| pr.first[pr.second - 1] != (unsigned char)(k))
+						++bad;
+					rsrc.deallocate(pr.first, pr.second);
+				}
+				rsrc.flush();
+			});
+			return bad.load();
+		}),
+		expect(true, []{
+			memory_test::counting_resource upstream;
+			ystdex::pmr::pool_options opts;
+
+			// NOTE: Small chunks make the cached blocks keep more chunks.
+			opts.max_blocks_per_chunk = 8;
+
+			ystdex::pmr::thread_cached_pool_resource rsrc(opts, &upstream);
+			const auto run([&]{
+				std::vector<void*> ptrs;
+
+				for(size_t i(0); i < 100; ++i)
+					ptrs.push_back(rsrc.allocate(16, 8));
+				for(const auto p : ptrs)
+					rsrc.deallocate(p, 16, 8);
+			});
+
+			run();
+			rsrc.flush();
+
+			const auto n(upstream.count);
+
+			// NOTE: Blocks cached by the exited thread are returned without
+			//	%flush.
+			std::thread(run).join();
+#if YB_HAS_THREAD_LOCAL
+			return upstream.count == n;
+#else
+			return true;
+#endif
+		})
+	);
 	show_result(cout, "ALL", pass_n, fail_n);
 }
 
@@ -0,0 +1,277 @@
+﻿/*
+	© 2026 FrankHB.
+
+	This file is part of the YSLib project, and may only be used,
+	modified, and distributed under the terms of the YSLib project
+	license, LICENSE.TXT.  By continuing to use, modify, or distribute
+	this file you indicate that you have read the license and
+	understand and accept it fully.
+*/
+
+/*!	\file YBaseBenchmark.cpp
+\ingroup Test
+\brief YBase 基准测试。
+\version r2
+\author FrankHB <frankhb1989@gmail.com>
+\since build 955
+\par 创建时间:
+	2026-10-17 18:40:12 +0800
+\par 修改时间:
+	2026-10-17 18:52 +0800
+\par 文本编码:
+	UTF-8
+\par 模块名称:
+	Test::YBaseBenchmark
+*/
+
+
+#include <ystdex/concurrency.h> // for ystdex::spsc_ring, ystdex::mpmc_ring,
+//	std::thread;
+#include <ystdex/memory_resource.h> // for ystdex::pmr::memory_resource,
+//	ystdex::pmr::synchronized_pool_resource,
+//	ystdex::pmr::thread_cached_pool_resource,
+//	ystdex::pmr::new_delete_resource;
+#include <ytest/timing.hpp> // for ytest::timing::once;
+#include <mutex> // for std::mutex, std::lock_guard, std::unique_lock;
+#include <condition_variable> // for std::condition_variable;
+#include <deque> // for std::deque;
+#include <vector> // for std::vector;
+#include <atomic> // for std::atomic;
+#include <chrono> // for std::chrono::steady_clock, std::chrono::duration;
+#include <iostream> // for std::cout;
+#include <iomanip> // for std::setw;
+
+namespace
+{
+
+using std::chrono::steady_clock;
+using seconds = std::chrono::duration<double>;
+using microseconds = std::chrono::duration<double, std::micro>;
+using nanoseconds = std::chrono::duration<double, std::nano>;
+
+//! \brief 作为基准的队列：以互斥量保护的双端队列。
+class locked_queue
+{
+private:
+	std::mutex mtx{};
+	std::condition_variable cond{};
+	std::deque<size_t> queue{};
+
+public:
+	//! \brief 构造：忽略容量。
+	explicit
+	locked_queue(size_t = 0)
+	{}
+
+	void
+	push(size_t x)
+	{
+		{
+			std::lock_guard<std::mutex> lck(mtx);
+
+			queue.push_back(x);
+		}
+		cond.notify_one();
+	}
+
+	size_t
+	pop()
+	{
+		std::unique_lock<std::mutex> lck(mtx);
+
+		cond.wait(lck, [this]{
+			return !queue.empty();
+		});
+
+		const auto res(queue.front());
+
+		queue.pop_front();
+		return res;
+	}
+};
+
+template<class _tRing>
+inline void
+Push(_tRing& q, size_t x)
+{
+	q.spin_push(x);
+}
+inline void
+Push(locked_queue& q, size_t x)
+{
+	q.push(x);
+}
+
+template<class _tRing>
+inline size_t
+Pop(_tRing& q)
+{
+	return q.spin_pop();
+}
+inline size_t
+Pop(locked_queue& q)
+{
+	return q.pop();
+}
+
+//! \brief 测试以指定数量的生产者和消费者线程传递元素的吞吐量。
+template<class _tQueue>
+double
+Throughput(_tQueue& q, size_t n_thrd, size_t n)
+{
+	std::atomic<size_t> sum(0);
+	const auto d(ytest::timing::once(steady_clock::now, [&]{
+		std::vector<std::thread> thrds;
+
+		for(size_t i(0); i < n_thrd; ++i)
+			thrds.emplace_back([&]{
+				for(size_t j(0); j < n / n_thrd; ++j)
+					Push(q, j);
+			});
+		for(size_t i(0); i < n_thrd; ++i)
+			thrds.emplace_back([&]{
+				size_t local(0);
+
+				for(size_t j(0); j < n / n_thrd; ++j)
+					local += Pop(q);
+				sum += local;
+			});
+		for(auto& thrd : thrds)
+			thrd.join();
+	}));
+
+	return double(n / n_thrd * n_thrd) / seconds(d).count() / 1e6;
+}
+
+//! \brief 测试两个线程之间以一对队列往返传递元素的平均延迟。
+template<class _tQueue>
+microseconds
+Latency(size_t n)
+{
+	_tQueue a(16), b(16);
+
+	return microseconds(ytest::timing::once(steady_clock::now, [&]{
+		std::thread thrd([&]{
+			for(size_t i(0); i < n; ++i)
+				Push(b, Pop(a));
+		});
+
+		for(size_t i(0); i < n; ++i)
+		{
+			Push(a, i);
+			yunused(Pop(b));
+		}
+		thrd.join();
+	})) / double(n);
+}
+
+/*!
+\brief 测试以指定数量的线程混合分配和去配的平均时间。
+\note 每个线程保留固定数量的不同大小的区块，以伪随机的顺序替换。
+*/
+nanoseconds
+Allocate(ystdex::pmr::memory_resource& r, size_t n_thrd, size_t n)
+{
+	return nanoseconds(ytest::timing::once(steady_clock::now, [&]{
+		std::vector<std::thread> thrds;
+
+		for(size_t i(0); i < n_thrd; ++i)
+			thrds.emplace_back([&]{
+				const size_t n_live(64);
+				void* live[n_live]{};
+				size_t sizes[n_live];
+
+				for(size_t j(0); j < n / n_thrd; ++j)
+				{
+					const auto k(j * 2654435761U % n_live);
+
+					if(live[k])
+						r.deallocate(live[k], sizes[k]);
+					sizes[k] = size_t(16) << j % 5;
+					live[k] = r.allocate(sizes[k]);
+				}
+				for(size_t k(0); k < n_live; ++k)
+					if(live[k])
+						r.deallocate(live[k], sizes[k]);
+			});
+		for(auto& thrd : thrds)
+			thrd.join();
+	})) / double(n / n_thrd * n_thrd);
+}
+
+void
+ReportThroughput(const char* name, size_t n_thrd, double mops)
+{
+	std::cout << std::setw(16) << name << std::setw(8) << n_thrd << "P/"
+		<< n_thrd << 'C' << std::setw(12) << mops << " Mop/s" << std::endl;
+}
+
+void
+ReportLatency(const char* name, microseconds d)
+{
+	std::cout << std::setw(16) << name << std::setw(12) << "round trip"
+		<< std::setw(12) << d.count() << " us" << std::endl;
+}
+
+void
+ReportAllocation(const char* name, size_t n_thrd, nanoseconds d)
+{
+	std::cout << std::setw(28) << name << std::setw(8) << n_thrd
+		<< std::setw(12) << d.count() << " ns/op" << std::endl;
+}
+
+} // unnamed namespace;
+
+
+int
+main()
+{
+	// NOTE: The spinning operations of the rings are compared to the blocking
+	//	operations of %locked_queue, which park the waiting threads.
+	const size_t n(1000000), n_round_trip(20000), capacity(1024);
+
+	for(const size_t n_thrd : {1, 2, 4})
+	{
+		{
+			locked_queue q;
+
+			ReportThroughput("locked_queue", n_thrd, Throughput(q, n_thrd, n));
+		}
+		{
+			ystdex::mpmc_ring<size_t> q(capacity);
+
+			ReportThroughput("mpmc_ring", n_thrd, Throughput(q, n_thrd, n));
+		}
+		if(n_thrd == 1)
+		{
+			ystdex::spsc_ring<size_t> q(capacity);
+
+			ReportThroughput("spsc_ring", n_thrd, Throughput(q, n_thrd, n));
+		}
+	}
+	ReportLatency("locked_queue", Latency<locked_queue>(n_round_trip));
+	ReportLatency("mpmc_ring",
+		Latency<ystdex::mpmc_ring<size_t>>(n_round_trip));
+	ReportLatency("spsc_ring",
+		Latency<ystdex::spsc_ring<size_t>>(n_round_trip));
+
+	const size_t n_alloc(4000000);
+
+	for(const size_t n_thrd : {1, 2, 4})
+	{
+		{
+			ystdex::pmr::synchronized_pool_resource r;
+
+			ReportAllocation("synchronized_pool_resource", n_thrd,
+				Allocate(r, n_thrd, n_alloc));
+		}
+		{
+			ystdex::pmr::thread_cached_pool_resource r;
+
+			ReportAllocation("thread_cached_pool_resource", n_thrd,
+				Allocate(r, n_thrd, n_alloc));
+		}
+		ReportAllocation("new_delete_resource", n_thrd,
+			Allocate(*ystdex::pmr::new_delete_resource(), n_thrd, n_alloc));
+	}
+}
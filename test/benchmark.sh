@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+# (C) 2026 FrankHB.
+# Script for benchmarks.
+# Requires: G++/Clang++, Tools/Scripts, YBase and YFramework source.
+
+set -e
+
+: "${SHBuild_ToolDir:=\
+$(cd "$(dirname "${BASH_SOURCE[0]}")/../Tools/Scripts"; pwd)}"
+
+# shellcheck source=../Tools/Scripts/SHBuild-bootstrap.sh
+. "$SHBuild_ToolDir/SHBuild-bootstrap.sh" # for YSLib_BaseDir,
+#	SHBuild_GetBuildName, SHBuild_Pushd, CXX, CXXFLAGS, LDFLAGS, INCLUDES,
+#	LIBS, SHBuild_Popd, SHBuild_Puts;
+
+TestDir="$(cd "$(dirname "${BASH_SOURCE[0]}")"; pwd)"
+Benchmark_BuildDir="$YSLib_BaseDir/build/$(SHBuild_GetBuildName)/.benchmark"
+mkdir -p "$Benchmark_BuildDir"
+SHBuild_Pushd "$Benchmark_BuildDir"
+
+# XXX: Value of several variables may contain whitespaces.
+# shellcheck disable=2086
+"$CXX" "$TestDir/YBaseBenchmark.cpp" -oYBaseBenchmark $CXXFLAGS $LDFLAGS \
+	$INCLUDES "$YSLib_BaseDir/YBase/source/ystdex/cassert.cpp" \
+	"$YSLib_BaseDir/YBase/source/ystdex/concurrency.cpp" \
+	"$YSLib_BaseDir/YBase/source/ystdex/memory_resource.cpp" \
+	"$YSLib_BaseDir/YBase/source/ystdex/node_base.cpp" "$@"
+
+./YBaseBenchmark
+
+# XXX: Ditto.
+# shellcheck disable=2086
+"$CXX" "$TestDir/NPLA1Benchmark.cpp" -oNPLA1Benchmark $CXXFLAGS $LDFLAGS \
+	$INCLUDES $LIBS "$@"
+
+./NPLA1Benchmark
+
+SHBuild_Popd
+
+SHBuild_Puts 'Done.'
+
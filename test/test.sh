@@ -1,7 +1,8 @@
 #!/usr/bin/env bash
-# (C) 2014-2017, 2020-2021 FrankHB.
+# (C) 2014-2017, 2020-2021, 2026 FrankHB.
 # Script for testing.
-# Requires: G++/Clang++, Tools/Scripts, YBase source.
+# Requires: G++/Clang++, Tools/Scripts, YBase and YFramework source.
+# Optional: SHBuild for NPLA1 script tests.
 
 set -e
 
@@ -20,7 +21,10 @@ SHBuild_Debug=debug
 #	SHBuild_Popd;
 
 LIBS="$YSLib_BaseDir/YBase/source/ystdex/cassert.cpp \
+$YSLib_BaseDir/YBase/source/ystdex/concurrency.cpp \
 $YSLib_BaseDir/YBase/source/ystdex/cstdio.cpp \
+$YSLib_BaseDir/YBase/source/ystdex/memory_resource.cpp \
+$YSLib_BaseDir/YBase/source/ystdex/node_base.cpp \
 $YSLib_BaseDir/YBase/source/ytest/test.cpp \
 "
 
@@ -38,7 +42,27 @@ SHBuild_S1_InitializePCH # for SHBuild_IncPCH.
 
 ./YBase
 
+# NOTE: The NPLA1 tests depending on the native interface are built with the
+#	sources in the bootstrap configuration.
+# shellcheck source=../Tools/Scripts/SHBuild-bootstrap.sh
+. "$SHBuild_ToolDir/SHBuild-bootstrap.sh" # for LIBS;
+
+# XXX: Ditto.
+# shellcheck disable=2086,2154
+"$CXX" "$TestDir/NPLA1.cpp" -oNPLA1 $CXXFLAGS $LDFLAGS $SHBuild_IncPCH \
+	$INCLUDES $LIBS "$YSLib_BaseDir/YBase/source/ytest/test.cpp" "$@"
+
+./NPLA1
+
 SHBuild_Popd
 
+# NOTE: The NPLA1 tests are skipped if no SHBuild is found.
+: "${SHBuild:="$(command -v SHBuild || true)"}"
+if [[ "$SHBuild" != '' ]]; then
+	"$SHBuild" -xcmd,RunNPLFile "$TestDir/NPLA1.txt"
+else
+	SHBuild_Puts 'SHBuild is not found. NPLA1 tests are skipped.'
+fi
+
 SHBuild_Puts 'Done.'
 